@@ -0,0 +1,159 @@
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "../src/dfa/compile_cache.h"
+#include "../src/dfa/compiler.h"
+
+namespace
+{
+  /**
+   * @brief Builds a set of keyword-like rules
+   *
+   * @param[in] count The number of rules
+   * @return std::vector<std::string> The rules
+   */
+  std::vector<std::string> generated_rules(std::size_t count)
+  {
+    std::vector<std::string> rules;
+    std::uint32_t seed = 7;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      std::string rule;
+
+      for (int length = 0; length < 6; ++length)
+      {
+        seed = seed * 1103515245 + 12345;
+        rule += static_cast<char>('a' + (seed >> 16) % 26);
+      }
+
+      rule += i % 3 == 0 ? "[0-9]+" : i % 3 == 1 ? "_[a-z]?" : "(x|yz)";
+      rules.push_back(std::move(rule));
+    }
+
+    return rules;
+  }
+
+  const std::string CACHED_PATTERN =
+      "(GET|POST|PUT) /api/v[0-9]+/[a-z_]+(\\?[a-z]+=[0-9a-f]{8})? HTTP/1\\.[01]";
+
+  const std::vector<std::string> &compile_rules()
+  {
+    static const std::vector<std::string> rules = generated_rules(5000);
+    return rules;
+  }
+} // namespace
+
+/**
+ * @brief Measures compiling 5000 rules into one unminimized DFA, on the
+ *        calling thread or on a pool of the given size
+ *
+ */
+static void BM_CompileSet(benchmark::State &state)
+{
+  const std::size_t threads = static_cast<std::size_t>(state.range(0));
+  std::optional<thread_management::ThreadPool> pool;
+
+  if (threads > 0)
+    pool.emplace(threads);
+
+  // Keep per-pattern debug logging out of the measurement
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+
+  for (auto _ : state)
+  {
+    dfa::Compiler compiler({.minimize = false,
+                            .pool = pool ? &*pool : nullptr});
+    auto machine = compiler.compile_set(compile_rules());
+    benchmark::DoNotOptimize(machine);
+  }
+}
+BENCHMARK(BM_CompileSet)
+    ->Arg(0)
+    ->Arg(std::max(1u, std::thread::hardware_concurrency()))
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/**
+ * @brief Measures compiling a typical request-routing pattern from scratch
+ *
+ */
+static void BM_CompileUncached(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+
+  for (auto _ : state)
+  {
+    auto machine = dfa::Compiler().compile(CACHED_PATTERN);
+    benchmark::DoNotOptimize(machine);
+  }
+}
+BENCHMARK(BM_CompileUncached)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Measures getting the same pattern from a CompileCache
+ *
+ */
+static void BM_CompileCached(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+  dfa::CompileCache cache;
+
+  for (auto _ : state)
+  {
+    auto machine = cache.get(CACHED_PATTERN);
+    benchmark::DoNotOptimize(machine);
+  }
+
+  state.counters["hit_ratio"] = cache.get_stats().hit_ratio();
+}
+BENCHMARK(BM_CompileCached)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Measures compiling the same pattern into a Matcher, which skips
+ *        determinization when the pattern has at most 64 positions
+ *
+ */
+static void BM_CompileMatcher(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+  dfa::Compiler compiler;
+
+  for (auto _ : state)
+  {
+    auto matcher = compiler.compile_matcher(CACHED_PATTERN);
+    benchmark::DoNotOptimize(matcher);
+  }
+
+  state.counters["positions"] =
+      static_cast<double>(compiler.get_stats().positions);
+}
+BENCHMARK(BM_CompileMatcher)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Measures matching a request line with the minimal DFA and with
+ *        the bit-parallel engine of the same pattern
+ *
+ */
+static void BM_MatchRequestLine(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+
+  const std::string line =
+      "POST /api/v2/user_profile?session=0badf00d HTTP/1.1";
+  const bool bit_parallel = state.range(0) != 0;
+  const dfa::Matcher matcher =
+      bit_parallel ? dfa::Compiler().compile_matcher(CACHED_PATTERN)
+                   : dfa::Matcher(dfa::Compiler().compile(CACHED_PATTERN));
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(matcher.matches(line));
+
+  state.SetLabel(bit_parallel ? "bit_parallel" : "dfa");
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() *
+                                                    line.size()));
+}
+BENCHMARK(BM_MatchRequestLine)->Arg(0)->Arg(1);
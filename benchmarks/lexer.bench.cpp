@@ -0,0 +1,76 @@
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include "../src/lexer/lexer.h"
+
+namespace
+{
+  /**
+   * @brief Builds a generated pattern of roughly the requested size
+   *
+   * @param[in] size Target length of the pattern in bytes
+   * @return std::string The pattern
+   */
+  std::string generated_pattern(std::size_t size)
+  {
+    static const std::string pieces[] = {
+        "(ab|cd)*", "[a-z0-9_]+", "x{2,5}", "\\d\\w", "^foo.bar$", "(?i)"};
+
+    std::string pattern;
+
+    for (std::size_t i = 0; pattern.size() < size; ++i)
+      pattern += pieces[i % std::size(pieces)];
+
+    return pattern;
+  }
+} // namespace
+
+/**
+ * @brief Measures Lexer::scan throughput in tokens per second
+ *
+ */
+static void BM_LexerScan(benchmark::State &state)
+{
+  const std::string pattern =
+      generated_pattern(static_cast<std::size_t>(state.range(0)));
+  lexer::Lexer lexer(pattern);
+  std::size_t tokens = 0;
+
+  for (auto _ : state)
+  {
+    auto result = lexer.scan();
+    tokens += result.size();
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(tokens));
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(pattern.size()));
+}
+BENCHMARK(BM_LexerScan)->Arg(64)->Arg(1 << 10)->Arg(10 << 10);
+
+/**
+ * @brief Measures the Token adapter, Lexer::tokenize, in tokens per second
+ *
+ */
+static void BM_LexerTokenize(benchmark::State &state)
+{
+  const std::string pattern =
+      generated_pattern(static_cast<std::size_t>(state.range(0)));
+  lexer::Lexer lexer(pattern);
+  std::size_t tokens = 0;
+
+  for (auto _ : state)
+  {
+    auto result = lexer.tokenize();
+    tokens += result.size();
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(tokens));
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(pattern.size()));
+}
+BENCHMARK(BM_LexerTokenize)->Arg(64)->Arg(1 << 10)->Arg(10 << 10);
+
+BENCHMARK_MAIN();
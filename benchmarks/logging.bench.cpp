@@ -0,0 +1,111 @@
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include "../src/lex/observers/token_logger.h"
+#include "../src/lexer/lexer.h"
+#include "../src/utils/logger.h"
+
+namespace
+{
+  const std::string LOGGED_PATTERN =
+      "(GET|POST|PUT) /api/v[0-9]+/[a-z_]+(\\?[a-z]+=[0-9a-f]{8})? HTTP/1\\.[01]";
+
+  /**
+   * @brief Tokenizes the pattern and visits every token, calling a log
+   *        macro per token when Log is true
+   *
+   * @tparam Log Whether the loop contains a log call
+   * @param[in] level The runtime level of the call, when compiled in
+   * @return std::size_t A checksum of the tokens
+   */
+  template <bool Log>
+  std::size_t tokenize(spdlog::level::level_enum level)
+  {
+    [[maybe_unused]] auto &logger = logger::Logger::get_logger();
+    lexer::Lexer lexer(LOGGED_PATTERN);
+    const lex::TokenStream tokens = lexer.scan();
+    std::size_t checksum = 0;
+
+    for (const auto &token : tokens)
+    {
+      if constexpr (Log)
+      {
+        if (level == spdlog::level::trace)
+          REGEX_DFA_LOG_TRACE(logger, "Token: {}",
+                              std::string(tokens.get_value(token)));
+
+        else
+          REGEX_DFA_LOG(logger, level, "Token: {}",
+                        std::string(tokens.get_value(token)));
+      }
+
+      checksum += static_cast<std::size_t>(token.type) + token.length;
+    }
+
+    return checksum;
+  }
+} // namespace
+
+/**
+ * @brief Measures tokenizing with no logging code in the loop
+ *
+ */
+static void BM_TokenizeWithoutLogging(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(tokenize<false>(spdlog::level::trace));
+}
+BENCHMARK(BM_TokenizeWithoutLogging);
+
+/**
+ * @brief Measures the same loop with a trace call per token, which the
+ *        default LOG_LEVEL compiles out
+ *
+ */
+static void BM_TokenizeTraceCompiledOut(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(tokenize<true>(spdlog::level::trace));
+
+  state.SetLabel(REGEX_DFA_ACTIVE_LEVEL > SPDLOG_LEVEL_TRACE
+                     ? "compiled out"
+                     : "compiled in, disabled at runtime");
+}
+BENCHMARK(BM_TokenizeTraceCompiledOut);
+
+/**
+ * @brief Measures the same loop with a compiled-in debug call per token
+ *        that the runtime level filters out
+ *
+ */
+static void BM_TokenizeDebugDisabledAtRuntime(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(tokenize<true>(spdlog::level::debug));
+}
+BENCHMARK(BM_TokenizeDebugDisabledAtRuntime);
+
+/**
+ * @brief Measures the Token adapter with a TokenLogger attached when Range
+ *        is 1, and none when it is 0; the logger's level filters every
+ *        message out
+ *
+ */
+static void BM_TokenizeWithIdleObserver(benchmark::State &state)
+{
+  logger::Logger::get_logger()->set_level(spdlog::level::warn);
+  lexer::Lexer lexer(LOGGED_PATTERN);
+
+  if (state.range(0) != 0)
+    lexer.register_observer(std::make_shared<lex::TokenLogger>());
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(lexer.tokenize());
+}
+BENCHMARK(BM_TokenizeWithIdleObserver)->Arg(0)->Arg(1);
@@ -0,0 +1,310 @@
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include "../src/ast/ast_builder.h"
+#include "../src/dfa/dfa_builder.h"
+#include "../src/dfa/followpos_visitor.h"
+#include "../src/dfa/minimizer.h"
+#include "../src/lexer/lexer.h"
+#include "../src/parser/parser.h"
+
+namespace
+{
+  /**
+   * @brief The PatternShape enum tells which dimension a sweep grows
+   *
+   * @details
+   *       - SIZE: A concatenation of mixed atoms of about n bytes.
+   *       - ALTERNATION: An alternation of n distinct words.
+   *       - REPEAT: A group repeated exactly n times.
+   */
+  enum class PatternShape
+  {
+    SIZE,
+    ALTERNATION,
+    REPEAT
+  };
+
+  /**
+   * @brief Gets a distinct lowercase word for an index
+   *
+   * @param[in] index The index
+   * @return std::string The word
+   */
+  std::string word(std::size_t index)
+  {
+    std::string result = "k";
+
+    do
+    {
+      result += static_cast<char>('a' + index % 26);
+      index /= 26;
+    } while (index > 0);
+
+    return result;
+  }
+
+  /**
+   * @brief Builds the pattern of a sweep point
+   *
+   * @param[in] shape The dimension being swept
+   * @param[in] n The sweep parameter
+   * @return std::string The pattern
+   */
+  std::string shaped_pattern(PatternShape shape, std::size_t n)
+  {
+    static const std::string pieces[] = {"ab", "[0-9]", "(c|d)", "e*", "f?"};
+    std::string pattern;
+
+    switch (shape)
+    {
+    case PatternShape::SIZE:
+      for (std::size_t i = 0; pattern.size() < n; ++i)
+        pattern += pieces[i % std::size(pieces)];
+      break;
+
+    case PatternShape::ALTERNATION:
+      for (std::size_t i = 0; i < n; ++i)
+        pattern += (i == 0 ? "" : "|") + word(i);
+      break;
+
+    case PatternShape::REPEAT:
+      pattern = "(ab|c){" + std::to_string(n) + "}";
+      break;
+    }
+
+    return pattern;
+  }
+
+  /**
+   * @brief Builds the AST of a sweep point directly through ConcreteBuilder
+   *
+   * @param[in,out] builder The builder, reset before use
+   * @param[in] shape The dimension being swept
+   * @param[in] n The sweep parameter
+   */
+  void build_shaped_tree(ast::ConcreteBuilder &builder, PatternShape shape,
+                         std::size_t n)
+  {
+    builder.reset();
+
+    switch (shape)
+    {
+    case PatternShape::SIZE:
+    {
+      std::vector<ast::NodeIndex> children;
+
+      for (std::size_t i = 0; i < n / 2; ++i)
+        children.push_back(builder.literal(i % 2 == 0 ? "a" : "b").build());
+
+      builder.grouping(children).build();
+      break;
+    }
+
+    case PatternShape::ALTERNATION:
+    {
+      ast::NodeIndex node = builder.literal(word(0)).build();
+
+      for (std::size_t i = 1; i < n; ++i)
+        node = builder.alternation(node, builder.literal(word(i)).build())
+                   .build();
+      break;
+    }
+
+    case PatternShape::REPEAT:
+    {
+      const ast::NodeIndex left = builder.literal("ab").build();
+      const ast::NodeIndex group = builder.grouping(builder.alternation(
+                                                        left,
+                                                        builder.literal("c")
+                                                            .build())
+                                                        .build())
+                                       .build();
+
+      builder.quantifier(group, static_cast<std::uint32_t>(n),
+                         static_cast<std::uint32_t>(n))
+          .build();
+      break;
+    }
+    }
+  }
+
+  ast::Arena parse(const std::string &pattern)
+  {
+    lexer::Lexer lexer(pattern);
+    parser::Parser parser(lexer.scan());
+
+    return parser.parse();
+  }
+
+  void quiet_logs()
+  {
+    logger::Logger::get_logger()->set_level(spdlog::level::warn);
+  }
+
+  /**
+   * @brief Registers a stage over every sweep
+   *
+   * @param[in] benchmark The benchmark registered for one shape
+   * @param[in] shape The dimension being swept
+   */
+  void sweep(benchmark::internal::Benchmark *benchmark, PatternShape shape)
+  {
+    switch (shape)
+    {
+    case PatternShape::SIZE:
+      benchmark->RangeMultiplier(4)->Range(16, 1024);
+      break;
+
+    case PatternShape::ALTERNATION:
+      benchmark->RangeMultiplier(4)->Range(4, 1024);
+      break;
+
+    case PatternShape::REPEAT:
+      benchmark->RangeMultiplier(4)->Range(2, 4096);
+      break;
+    }
+
+    benchmark->Unit(benchmark::kMicrosecond);
+  }
+} // namespace
+
+/**
+ * @brief Measures Lexer::tokenize
+ *
+ */
+static void BM_StageTokenize(benchmark::State &state, PatternShape shape)
+{
+  quiet_logs();
+  const std::string pattern =
+      shaped_pattern(shape, static_cast<std::size_t>(state.range(0)));
+  lexer::Lexer lexer(pattern);
+
+  for (auto _ : state)
+  {
+    auto tokens = lexer.tokenize();
+    benchmark::DoNotOptimize(tokens);
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(pattern.size()));
+}
+
+/**
+ * @brief Measures the parser, which builds its AST through ConcreteBuilder;
+ *        the token stream is copied on every iteration
+ *
+ */
+static void BM_StageParse(benchmark::State &state, PatternShape shape)
+{
+  quiet_logs();
+  const std::string pattern =
+      shaped_pattern(shape, static_cast<std::size_t>(state.range(0)));
+  const lexer::Lexer lexer(pattern);
+  const lex::TokenStream tokens = lexer.scan();
+
+  for (auto _ : state)
+  {
+    parser::Parser parser(tokens);
+    auto tree = parser.parse();
+    benchmark::DoNotOptimize(tree);
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(pattern.size()));
+}
+
+/**
+ * @brief Measures building an equivalent AST through ConcreteBuilder
+ *        directly
+ *
+ */
+static void BM_StageBuildAst(benchmark::State &state, PatternShape shape)
+{
+  ast::ConcreteBuilder builder;
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state)
+  {
+    build_shaped_tree(builder, shape, n);
+    benchmark::DoNotOptimize(builder.get_arena());
+  }
+}
+
+/**
+ * @brief Measures the followpos analysis
+ *
+ */
+static void BM_StageFollowpos(benchmark::State &state, PatternShape shape)
+{
+  quiet_logs();
+  const ast::Arena tree =
+      parse(shaped_pattern(shape, static_cast<std::size_t>(state.range(0))));
+
+  for (auto _ : state)
+  {
+    dfa::FollowposVisitor visitor;
+    auto automaton = visitor.analyze(tree);
+    benchmark::DoNotOptimize(automaton);
+  }
+}
+
+/**
+ * @brief Measures the subset construction
+ *
+ */
+static void BM_StageDeterminize(benchmark::State &state, PatternShape shape)
+{
+  quiet_logs();
+  const ast::Arena tree =
+      parse(shaped_pattern(shape, static_cast<std::size_t>(state.range(0))));
+  dfa::FollowposVisitor visitor;
+  const auto automaton = visitor.analyze(tree);
+  std::size_t states = 0;
+
+  for (auto _ : state)
+  {
+    auto machine = dfa::DFABuilder(automaton).build();
+    states = machine.get_state_count();
+    benchmark::DoNotOptimize(machine);
+  }
+
+  state.counters["states"] = static_cast<double>(states);
+}
+
+/**
+ * @brief Measures the minimization
+ *
+ */
+static void BM_StageMinimize(benchmark::State &state, PatternShape shape)
+{
+  quiet_logs();
+  const ast::Arena tree =
+      parse(shaped_pattern(shape, static_cast<std::size_t>(state.range(0))));
+  dfa::FollowposVisitor visitor;
+  const auto machine = dfa::DFABuilder(visitor.analyze(tree)).build();
+
+  for (auto _ : state)
+  {
+    dfa::Minimizer minimizer(machine);
+    auto minimal = minimizer.minimize();
+    benchmark::DoNotOptimize(minimal);
+  }
+
+  state.counters["states"] = static_cast<double>(machine.get_state_count());
+}
+
+#define STAGE_SWEEPS(stage)                                                  \
+  BENCHMARK_CAPTURE(stage, size, PatternShape::SIZE)                         \
+      ->Apply([](benchmark::internal::Benchmark *b) { sweep(b, PatternShape::SIZE); });                \
+  BENCHMARK_CAPTURE(stage, alternation, PatternShape::ALTERNATION)           \
+      ->Apply([](benchmark::internal::Benchmark *b) { sweep(b, PatternShape::ALTERNATION); });         \
+  BENCHMARK_CAPTURE(stage, repeat, PatternShape::REPEAT)                     \
+      ->Apply([](benchmark::internal::Benchmark *b) { sweep(b, PatternShape::REPEAT); })
+
+STAGE_SWEEPS(BM_StageTokenize);
+STAGE_SWEEPS(BM_StageParse);
+STAGE_SWEEPS(BM_StageBuildAst);
+STAGE_SWEEPS(BM_StageFollowpos);
+STAGE_SWEEPS(BM_StageDeterminize);
+STAGE_SWEEPS(BM_StageMinimize);
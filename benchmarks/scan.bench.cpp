@@ -0,0 +1,258 @@
+#include <string>
+#include <thread>
+#include <benchmark/benchmark.h>
+
+#include "../src/dfa/batch_matcher.h"
+#include "../src/dfa/compiler.h"
+#include "../src/dfa/jit_dfa.h"
+#include "../src/dfa/parallel_scanner.h"
+#include "../src/dfa/stream_matcher.h"
+#include "request_line.h"
+
+namespace
+{
+  /**
+   * @brief Builds a pseudo-random lowercase text
+   *
+   * @param[in] size The length of the text in bytes
+   * @return std::string The text
+   */
+  std::string generated_text(std::size_t size)
+  {
+    std::string text(size, 'a');
+    std::uint32_t seed = 1;
+
+    for (auto &character : text)
+    {
+      seed = seed * 1103515245 + 12345;
+      character = static_cast<char>('a' + (seed >> 16) % 26);
+    }
+
+    return text;
+  }
+
+  const std::string &scan_text()
+  {
+    static const std::string text = generated_text(std::size_t{64} << 20);
+    return text;
+  }
+
+  const dfa::DFA &scan_dfa()
+  {
+    static const dfa::DFA machine =
+        dfa::Compiler({.unanchored = true}).compile("q[a-e]+z|xyz");
+    return machine;
+  }
+
+  /**
+   * @brief Builds short request lines, about half of which are valid
+   *
+   * @param[in] count The number of records
+   * @return std::vector<std::string> The records
+   */
+  std::vector<std::string> generated_records(std::size_t count)
+  {
+    static const std::string methods[] = {"GET", "POST", "PUT", "HEAD"};
+    std::vector<std::string> records;
+    std::uint32_t seed = 1;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      seed = seed * 1103515245 + 12345;
+      records.push_back(methods[(seed >> 16) % 4] + " /api/v" +
+                        std::to_string(seed % 3) + "/" +
+                        generated_text(4 + (seed >> 8) % 20) + " HTTP/1." +
+                        std::to_string((seed >> 4) % 3));
+    }
+
+    return records;
+  }
+
+  /**
+   * @brief Builds a 1 MiB input that matches one of two patterns as a whole
+   * @details Pattern 0 splits bytes into few ranges and pattern 1 into
+   *          many, so the JIT dispatches them through compare trees and
+   *          jump tables respectively
+   *
+   * @param[in] which The pattern
+   * @return std::pair<std::string, std::string> The pattern and the input
+   */
+  std::pair<std::string, std::string> whole_match_case(std::int64_t which)
+  {
+    std::string text = generated_text(std::size_t{1} << 20);
+
+    if (which == 0)
+    {
+      for (std::size_t i = 7; i < text.size(); i += 8)
+        text[i] = ' ';
+
+      return {"([a-z]+ )*[a-z]*", text};
+    }
+
+    static const char hex[] = "0123456789abcdefABCDEF:. -";
+
+    for (auto &character : text)
+      character = hex[static_cast<unsigned char>(character) % (sizeof(hex) - 1)];
+
+    return {"[0-9a-fA-F:. -]*", text};
+  }
+
+  const dfa::DFA &record_dfa()
+  {
+    static const dfa::DFA machine = dfa::Compiler().compile(
+        "(GET|POST|PUT) /api/v[0-9]+/[a-z_]+ HTTP/1\\.[01]");
+    return machine;
+  }
+} // namespace
+
+/**
+ * @brief Measures a single-threaded scan of 64 MiB
+ *
+ */
+static void BM_ScanSequential(benchmark::State &state)
+{
+  const std::string &text = scan_text();
+  dfa::StreamMatcher matcher(scan_dfa());
+
+  for (auto _ : state)
+  {
+    std::size_t matches = 0;
+    matcher.feed(std::as_bytes(std::span(text.data(), text.size())),
+                 [&](std::uint64_t) { ++matches; });
+    matcher.finish([&](std::uint64_t) { ++matches; });
+    benchmark::DoNotOptimize(matches);
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_ScanSequential)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Measures ParallelScanner over 64 MiB with a given thread count
+ *
+ */
+static void BM_ScanParallel(benchmark::State &state)
+{
+  const std::string &text = scan_text();
+  thread_management::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  dfa::ParallelScanner scanner(scan_dfa(), pool);
+
+  for (auto _ : state)
+  {
+    auto result = scanner.scan(text);
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_ScanParallel)
+    ->Arg(1)
+    ->Arg(std::max(1u, std::thread::hardware_concurrency()))
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/**
+ * @brief Matches 64Ki short records one at a time with DFA::matches
+ *
+ */
+static void BM_MatchRecordsSerial(benchmark::State &state)
+{
+  const auto records = generated_records(std::size_t{1} << 16);
+  const dfa::DFA &machine = record_dfa();
+
+  for (auto _ : state)
+  {
+    std::size_t matches = 0;
+
+    for (const auto &record : records)
+      matches += machine.matches(record);
+
+    benchmark::DoNotOptimize(matches);
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(records.size()));
+}
+BENCHMARK(BM_MatchRecordsSerial);
+
+/**
+ * @brief Matches the same records with the direct-coded scan generated
+ *        from benchmarks/request_line.patterns at build time
+ *
+ */
+static void BM_MatchRecordsGenerated(benchmark::State &state)
+{
+  const auto records = generated_records(std::size_t{1} << 16);
+
+  for (auto _ : state)
+  {
+    std::size_t matches = 0;
+
+    for (const auto &record : records)
+      matches += request_line::matches(record);
+
+    benchmark::DoNotOptimize(matches);
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(records.size()));
+}
+BENCHMARK(BM_MatchRecordsGenerated);
+
+/**
+ * @brief Matches the same records with a BatchMatcher of a given lane
+ *        count
+ *
+ */
+static void BM_MatchRecordsBatch(benchmark::State &state)
+{
+  const auto records = generated_records(std::size_t{1} << 16);
+  const std::vector<std::string_view> inputs(records.begin(), records.end());
+  const dfa::BatchMatcher matcher(
+      record_dfa(), {.lanes = static_cast<std::size_t>(state.range(0))});
+  std::vector<std::uint8_t> results(inputs.size());
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(matcher.matches(inputs, results));
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(records.size()));
+}
+BENCHMARK(BM_MatchRecordsBatch)->Arg(4)->Arg(8)->Arg(16);
+
+/**
+ * @brief Matches a 1 MiB input with the table-driven DFA
+ *
+ */
+static void BM_MatchTable(benchmark::State &state)
+{
+  const auto [pattern, text] = whole_match_case(state.range(0));
+  const dfa::DFA machine = dfa::Compiler().compile(pattern);
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(machine.matches(text));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_MatchTable)->Arg(0)->Arg(1);
+
+/**
+ * @brief Matches the same input with the DFA compiled to machine code
+ *
+ */
+static void BM_MatchJit(benchmark::State &state)
+{
+  const auto [pattern, text] = whole_match_case(state.range(0));
+  const dfa::JitDFA jit(dfa::Compiler().compile(pattern));
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(jit.matches(text));
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(text.size()));
+  state.SetLabel(jit.is_native() ? "native" : "table fallback");
+}
+BENCHMARK(BM_MatchJit)->Arg(0)->Arg(1);
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "../src/threads/thread_pool.h"
+
+namespace
+{
+  constexpr std::size_t TASKS = 10000;
+
+  std::size_t thread_count()
+  {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+} // namespace
+
+/**
+ * @brief Measures one-off jobs submitted through enqueue() and awaited
+ *        through their futures
+ *
+ */
+static void BM_SchedulerEnqueue(benchmark::State &state)
+{
+  thread_management::ThreadPool pool(thread_count());
+  std::vector<std::future<void>> futures;
+  std::atomic<std::size_t> sum{0};
+
+  futures.reserve(TASKS);
+
+  for (auto _ : state)
+  {
+    futures.clear();
+
+    for (std::size_t i = 0; i < TASKS; ++i)
+      futures.push_back(pool.enqueue([&sum, i]
+                                     { sum.fetch_add(i, std::memory_order_relaxed); }));
+
+    for (auto &future : futures)
+      future.get();
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(TASKS));
+}
+BENCHMARK(BM_SchedulerEnqueue)->UseRealTime();
+
+/**
+ * @brief Measures tiny tasks submitted to a TaskGroup from outside the pool
+ *
+ */
+static void BM_SchedulerTaskGroup(benchmark::State &state)
+{
+  thread_management::ThreadPool pool(thread_count());
+  thread_management::TaskGroup group(pool);
+  std::atomic<std::size_t> sum{0};
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < TASKS; ++i)
+      group.run([&sum, i]
+                { sum.fetch_add(i, std::memory_order_relaxed); });
+
+    group.wait();
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(TASKS));
+}
+BENCHMARK(BM_SchedulerTaskGroup)->UseRealTime();
+
+/**
+ * @brief Measures tiny tasks forked from inside a worker, which go to its
+ *        own deque and are stolen by the others
+ *
+ */
+static void BM_SchedulerNestedTaskGroup(benchmark::State &state)
+{
+  thread_management::ThreadPool pool(thread_count());
+  std::atomic<std::size_t> sum{0};
+
+  for (auto _ : state)
+    pool.enqueue([&]
+                 {
+                   thread_management::TaskGroup group(pool);
+
+                   for (std::size_t i = 0; i < TASKS; ++i)
+                     group.run([&sum, i]
+                               { sum.fetch_add(i, std::memory_order_relaxed); });
+
+                   group.wait();
+                 })
+        .get();
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(TASKS));
+}
+BENCHMARK(BM_SchedulerNestedTaskGroup)->UseRealTime();
+
+/**
+ * @brief Measures parallel_for over single-index ranges
+ *
+ */
+static void BM_SchedulerParallelFor(benchmark::State &state)
+{
+  thread_management::ThreadPool pool(thread_count());
+  std::atomic<std::size_t> sum{0};
+
+  for (auto _ : state)
+    pool.parallel_for(0, TASKS, 1, [&sum](std::size_t begin, std::size_t)
+                      { sum.fetch_add(begin, std::memory_order_relaxed); });
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(TASKS));
+}
+BENCHMARK(BM_SchedulerParallelFor)->UseRealTime();
@@ -0,0 +1,72 @@
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include "../src/dfa/compiler.h"
+
+namespace
+{
+  /**
+   * @brief Builds a synthetic log with one error line near the end
+   *
+   * @param[in] size Target length of the log in bytes
+   * @return std::string The log
+   */
+  std::string generated_log(std::size_t size)
+  {
+    static const std::string lines[] = {
+        "INFO request served in 12ms\n", "DEBUG cache hit for key user:42\n",
+        "WARN slow query took 250ms\n", "INFO connection closed by peer\n"};
+
+    std::string log;
+
+    for (std::size_t i = 0; log.size() < size; ++i)
+      log += lines[i % std::size(lines)];
+
+    return log + "ERROR 503 upstream timeout\n";
+  }
+
+  /**
+   * @brief Searches the log for the error line, with or without prefilter
+   *
+   * @param[in] state The benchmark state
+   * @param[in] prefilter Whether to keep the prefilter of the pattern
+   */
+  void search_log(benchmark::State &state, bool prefilter)
+  {
+    const std::string log =
+        generated_log(static_cast<std::size_t>(state.range(0)));
+    auto searcher = dfa::Compiler().compile_searcher("ERROR [0-9]+");
+
+    if (!prefilter)
+      searcher.get_prefilter() = dfa::Prefilter();
+
+    for (auto _ : state)
+    {
+      auto match = searcher.find(log);
+      benchmark::DoNotOptimize(match);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                            static_cast<std::int64_t>(log.size()));
+  }
+} // namespace
+
+/**
+ * @brief Measures Searcher::find with the SIMD literal prefilter
+ *
+ */
+static void BM_SearchPrefilter(benchmark::State &state)
+{
+  search_log(state, true);
+}
+BENCHMARK(BM_SearchPrefilter)->Arg(1 << 20);
+
+/**
+ * @brief Measures Searcher::find trying the DFA at every position
+ *
+ */
+static void BM_SearchNoPrefilter(benchmark::State &state)
+{
+  search_log(state, false);
+}
+BENCHMARK(BM_SearchNoPrefilter)->Arg(1 << 20);
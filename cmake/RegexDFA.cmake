@@ -0,0 +1,33 @@
+# regex_dfa_generate_header(<target> PATTERNS <file> OUTPUT <header>
+#                           [NAMESPACE <name>])
+#
+# Compiles the patterns in <file>, one per line, into a self-contained C++
+# header with RegexToDFAConverter's generate command and adds it to <target>.
+# A relative OUTPUT is placed in the current binary directory, which is added
+# to the target's include path. The header is regenerated whenever the
+# pattern file or the generator changes.
+function(regex_dfa_generate_header target)
+  cmake_parse_arguments(ARG "" "PATTERNS;OUTPUT;NAMESPACE" "" ${ARGN})
+
+  if(NOT ARG_PATTERNS OR NOT ARG_OUTPUT)
+    message(FATAL_ERROR
+            "regex_dfa_generate_header: PATTERNS and OUTPUT are required")
+  endif()
+
+  get_filename_component(patterns "${ARG_PATTERNS}" ABSOLUTE)
+  get_filename_component(output "${ARG_OUTPUT}" ABSOLUTE
+                         BASE_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+  get_filename_component(output_dir "${output}" DIRECTORY)
+
+  add_custom_command(
+    OUTPUT "${output}"
+    COMMAND "${CMAKE_COMMAND}" -E make_directory "${output_dir}"
+    COMMAND RegexToDFAConverter generate "${patterns}" "${output}"
+            ${ARG_NAMESPACE}
+    DEPENDS "${patterns}" RegexToDFAConverter
+    COMMENT "Generating ${ARG_OUTPUT} from ${ARG_PATTERNS}"
+    VERBATIM)
+
+  target_sources(${target} PRIVATE "${output}")
+  target_include_directories(${target} PRIVATE "${output_dir}")
+endfunction()
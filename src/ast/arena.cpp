@@ -0,0 +1,368 @@
+#include <stdexcept>
+#include "arena.h"
+
+namespace ast
+{
+  /**
+   * @brief Appends a node to the arena
+   *
+   * @param[in] type The type of the node
+   * @param[in] value The string payload of the node, if any
+   * @param[in] character The character payload of the node, if any
+   * @return NodeIndex The index of the new node
+   * @throw std::length_error If the arena is full
+   */
+  NodeIndex Arena::add_node(NodeType type, std::string_view value,
+                            char character)
+  {
+    if (m_nodes.size() >= NO_NODE)
+      throw std::length_error("Arena: too many nodes");
+
+    Node node;
+    node.type = type;
+    node.character = character;
+    node.value_offset = static_cast<std::uint32_t>(m_text.size());
+    node.value_length = static_cast<std::uint32_t>(value.size());
+
+    m_text.append(value);
+    m_nodes.push_back(node);
+
+    return static_cast<NodeIndex>(m_nodes.size() - 1);
+  }
+
+  /**
+   * @brief Appends a quantifier node over an existing node
+   *
+   * @param[in] child The quantified node
+   * @param[in] min_occurrences The minimum number of occurrences
+   * @param[in] max_occurrences The maximum number of occurrences, or
+   *            UNBOUNDED
+   * @return NodeIndex The index of the new node
+   */
+  NodeIndex Arena::add_quantifier(NodeIndex child,
+                                  std::uint32_t min_occurrences,
+                                  std::uint32_t max_occurrences)
+  {
+    const NodeIndex index = add_node(NodeType::QUANTIFIER);
+
+    m_nodes[index].min_occurrences = min_occurrences;
+    m_nodes[index].max_occurrences = max_occurrences;
+    add_child(index, child);
+
+    return index;
+  }
+
+  /**
+   * @brief Appends a node to the children of another node
+   * @details The child must not have a parent yet, since the sibling link
+   *          lives in the child itself
+   *
+   * @param[in] parent The parent node
+   * @param[in] child The node to add
+   * @throw std::out_of_range If either index is invalid
+   */
+  void Arena::add_child(NodeIndex parent, NodeIndex child)
+  {
+    if (parent >= m_nodes.size() || child >= m_nodes.size())
+      throw std::out_of_range("Arena: invalid node index");
+
+    Node &node = m_nodes[parent];
+
+    if (node.last_child == NO_NODE)
+      node.first_child = child;
+
+    else
+      m_nodes[node.last_child].next_sibling = child;
+
+    node.last_child = child;
+  }
+
+  /**
+   * @brief Copies every node of another arena into this one
+   *
+   * @param[in] other The arena to copy, with its root set
+   * @return NodeIndex The index of the copied root
+   * @throw std::invalid_argument If the other arena has no root
+   * @throw std::length_error If the arena would be full
+   */
+  NodeIndex Arena::append(const Arena &other)
+  {
+    if (other.m_root == NO_NODE)
+      throw std::invalid_argument("Arena: appended tree has no root");
+
+    if (m_nodes.size() + other.m_nodes.size() >= NO_NODE)
+      throw std::length_error("Arena: too many nodes");
+
+    const auto node_offset = static_cast<NodeIndex>(m_nodes.size());
+    const auto text_offset = static_cast<std::uint32_t>(m_text.size());
+    auto relocate = [&](NodeIndex index)
+    { return index == NO_NODE ? NO_NODE : index + node_offset; };
+
+    // No exact reserve here: appending many trees must keep the
+    // geometric growth of the vector
+    m_text.append(other.m_text);
+
+    for (Node node : other.m_nodes)
+    {
+      node.first_child = relocate(node.first_child);
+      node.last_child = relocate(node.last_child);
+      node.next_sibling = relocate(node.next_sibling);
+      node.value_offset += text_offset;
+      m_nodes.push_back(node);
+    }
+
+    return other.m_root + node_offset;
+  }
+
+  /**
+   * @brief Calls the visitor method matching the type of a node
+   *
+   * @param[in] index The node to visit
+   * @param[in] visitor The visitor to accept
+   */
+  void Arena::accept(NodeIndex index, AstVisitor &visitor) const
+  {
+    const Node &node = get_node(index);
+    const std::string_view value = get_value(index);
+
+    switch (node.type)
+    {
+    case NodeType::LITERAL:
+      visitor.visit_literal_node(LiteralNode{index, value});
+      break;
+
+    case NodeType::METACHARACTER:
+      visitor.visit_metacharacter_node(
+          MetacharacterNode{index, node.character});
+      break;
+
+    case NodeType::CHARACTER_CLASS:
+      visitor.visit_character_class_node(CharacterClassNode{index, value});
+      break;
+
+    case NodeType::GROUPING:
+      visitor.visit_grouping_node(GroupingNode{index, get_children(index)});
+      break;
+
+    case NodeType::QUANTIFIER:
+      visitor.visit_quantifier_node(
+          QuantifierNode{index, node.first_child, node.min_occurrences,
+                         node.max_occurrences});
+      break;
+
+    case NodeType::ANCHOR:
+      visitor.visit_anchor_node(AnchorNode{index, value});
+      break;
+
+    case NodeType::ESCAPE_SEQUENCE:
+      visitor.visit_escape_sequence_node(
+          EscapeSequenceNode{index, node.character});
+      break;
+
+    case NodeType::WILDCARD:
+      visitor.visit_wildcard_node(WildcardNode{index});
+      break;
+
+    case NodeType::ALTERNATION:
+      visitor.visit_alternation_node(
+          AlternationNode{index, get_children(index)});
+      break;
+
+    case NodeType::BOUNDARY:
+      visitor.visit_boundary_node(BoundaryNode{index, value});
+      break;
+
+    case NodeType::MODIFIER:
+      visitor.visit_modifier_node(ModifierNode{index, value});
+      break;
+
+    case NodeType::INVALID:
+      visitor.visit_invalid_node(InvalidNode{index, value});
+      break;
+
+    case NodeType::END_OF_INPUT:
+      visitor.visit_end_of_input_node(EndOfInputNode{index});
+      break;
+    }
+  }
+
+  /**
+   * @brief Returns the string representation of a subtree
+   *
+   * @param[in] index The root of the subtree
+   * @return std::string The string representation of the subtree
+   */
+  std::string Arena::to_string(NodeIndex index) const
+  {
+    const Node &node = get_node(index);
+
+    switch (node.type)
+    {
+    case NodeType::METACHARACTER:
+    case NodeType::ESCAPE_SEQUENCE:
+      return std::string(1, node.character);
+
+    case NodeType::WILDCARD:
+      return ".";
+
+    case NodeType::END_OF_INPUT:
+      return "$";
+
+    case NodeType::GROUPING:
+    case NodeType::ALTERNATION:
+    {
+      const char *separator =
+          node.type == NodeType::ALTERNATION ? "|" : "";
+      std::string result = "(";
+
+      for (const auto child : get_children(index))
+      {
+        if (child != node.first_child)
+          result += separator;
+
+        result += to_string(child);
+      }
+
+      return result + ")";
+    }
+
+    case NodeType::QUANTIFIER:
+    {
+      std::string result = to_string(node.first_child);
+      const auto min = node.min_occurrences;
+      const auto max = node.max_occurrences;
+
+      if (min == 0 && max == 1)
+        result += "?";
+
+      else if (min == 0 && max == UNBOUNDED)
+        result += "*";
+
+      else if (min == 1 && max == UNBOUNDED)
+        result += "+";
+
+      else if (min == max)
+        result += "{" + std::to_string(min) + "}";
+
+      else if (max == UNBOUNDED)
+        result += "{" + std::to_string(min) + ",}";
+
+      else
+        result += "{" + std::to_string(min) + "," +
+                  std::to_string(max) + "}";
+
+      return result;
+    }
+
+    default:
+      return std::string(get_value(index));
+    }
+  }
+
+  /**
+   * @brief Returns the string representation of the whole tree
+   *
+   * @return std::string The string representation, empty without a root
+   */
+  std::string Arena::to_string() const
+  {
+    return m_root == NO_NODE ? std::string() : to_string(m_root);
+  }
+
+  /**
+   * @brief Reserves room for nodes and string payloads
+   *
+   * @param[in] nodes The number of nodes to reserve
+   * @param[in] text The number of payload bytes to reserve
+   */
+  void Arena::reserve(std::size_t nodes, std::size_t text)
+  {
+    m_nodes.reserve(nodes);
+    m_text.reserve(text);
+  }
+
+  /**
+   * @brief Removes every node, keeping the allocated capacity
+   *
+   */
+  void Arena::clear() noexcept
+  {
+    m_nodes.clear();
+    m_text.clear();
+    m_root = NO_NODE;
+  }
+
+  /**
+   * @brief Gets the storage record of a node
+   *
+   * @param[in] index The node index
+   * @return const Node& The node
+   * @throw std::out_of_range If the index is invalid
+   */
+  const Node &Arena::get_node(NodeIndex index) const
+  {
+    if (index >= m_nodes.size())
+      throw std::out_of_range("Arena: invalid node index");
+
+    return m_nodes[index];
+  }
+
+  /**
+   * @brief Gets the string payload of a node
+   *
+   * @param[in] index The node index
+   * @return std::string_view The payload, valid until the arena changes
+   */
+  std::string_view Arena::get_value(NodeIndex index) const
+  {
+    const Node &node = get_node(index);
+
+    return std::string_view(m_text).substr(node.value_offset,
+                                           node.value_length);
+  }
+
+  /**
+   * @brief Gets the children of a node
+   *
+   * @param[in] index The node index
+   * @return ChildRange The children, valid until the arena changes
+   */
+  ChildRange Arena::get_children(NodeIndex index) const
+  {
+    return ChildRange(m_nodes.data(), get_node(index).first_child);
+  }
+
+  /**
+   * @brief Gets the root of the tree
+   *
+   * @return NodeIndex The root, or NO_NODE if none was set
+   */
+  NodeIndex Arena::get_root() const noexcept
+  {
+    return m_root;
+  }
+
+  /**
+   * @brief Gets the number of nodes
+   *
+   * @return std::size_t The number of nodes
+   */
+  std::size_t Arena::size() const noexcept
+  {
+    return m_nodes.size();
+  }
+
+  /**
+   * @brief Sets the root of the tree
+   *
+   * @param[in] root The root node
+   * @throw std::out_of_range If the index is invalid
+   */
+  void Arena::set_root(NodeIndex root)
+  {
+    if (root >= m_nodes.size())
+      throw std::out_of_range("Arena: invalid node index");
+
+    m_root = root;
+  }
+} // namespace ast
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "node/node.h"
+#include "visitors/ast_visitor.h"
+
+namespace ast
+{
+  /**
+   * @class Arena
+   * @brief Owns every node of an AST in one contiguous buffer
+   *
+   * @details Nodes refer to each other by 32-bit indices and their string
+   *          payloads share one text buffer, so building a tree costs a
+   *          couple of amortized allocations and the whole tree is freed at
+   *          once. clear() keeps the capacity for the next pattern.
+   */
+  class Arena
+  {
+  public:
+    Arena() = default;
+
+    NodeIndex add_node(NodeType type, std::string_view value = {},
+                       char character = '\0');
+    NodeIndex add_quantifier(NodeIndex child, std::uint32_t min_occurrences,
+                             std::uint32_t max_occurrences);
+    void add_child(NodeIndex parent, NodeIndex child);
+    NodeIndex append(const Arena &other);
+
+    void accept(NodeIndex index, AstVisitor &visitor) const;
+    std::string to_string(NodeIndex index) const;
+    std::string to_string() const;
+
+    void reserve(std::size_t nodes, std::size_t text);
+    void clear() noexcept;
+
+    // Getters
+    [[nodiscard]] const Node &get_node(NodeIndex index) const;
+    [[nodiscard]] std::string_view get_value(NodeIndex index) const;
+    [[nodiscard]] ChildRange get_children(NodeIndex index) const;
+    [[nodiscard]] NodeIndex get_root() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+
+    // Setters
+    void set_root(NodeIndex root);
+
+  private:
+    std::vector<Node> m_nodes;
+    std::string m_text;
+    NodeIndex m_root = NO_NODE;
+  };
+} // namespace ast
@@ -1,26 +1,61 @@
 #include <sstream>
+#include <stdexcept>
 #include <functional>
 #include "ast_builder.h"
 
 namespace ast
 {
   /**
-   * @brief Builds a new node and sets it as the root node
+   * @brief Gets the last built node
    *
-   * @return AST_ptr The root node
+   * @return NodeIndex The root node, or NO_NODE if nothing was built
    */
-  AST_ptr ConcreteBuilder::build()
+  NodeIndex ConcreteBuilder::build()
   {
-    return std::move(m_root);
+    return m_root;
+  }
+
+  /**
+   * @brief Hands the built tree over
+   * @details The tree is rooted at the last built node unless a root was
+   *          set on the arena already. The builder is left empty.
+   *
+   * @return Arena The arena holding the tree
+   */
+  Arena ConcreteBuilder::release()
+  {
+    if (m_arena.get_root() == NO_NODE && m_root != NO_NODE)
+      m_arena.set_root(m_root);
+
+    Arena arena = std::move(m_arena);
+
+    m_arena = Arena();
+    m_root = NO_NODE;
+
+    return arena;
   }
 
   /**
    * @brief Resets the builder
+   * @details The arena keeps its capacity, so building the next tree does
+   *          not allocate again
    *
    */
-  void ConcreteBuilder::reset()
+  void ConcreteBuilder::reset() noexcept
   {
-    m_root = nullptr;
+    m_arena.clear();
+    m_root = NO_NODE;
+  }
+
+  /**
+   * @brief Appends a node to the children of a grouping or alternation
+   *
+   * @param[in] parent The parent node
+   * @param[in] child The node to add
+   */
+  void ConcreteBuilder::add_child(NodeIndex parent, NodeIndex child)
+  {
+    m_arena.add_child(parent, child);
   }
 
   /**
@@ -29,9 +64,9 @@ namespace ast
    * @param[in] value The value of the literal
    * @return ASTBuilder& The builder
    */
-  ASTBuilder &ConcreteBuilder::literal(const std::string &value)
+  ASTBuilder &ConcreteBuilder::literal(std::string_view value)
   {
-    m_root = std::make_unique<LiteralNode>(value);
+    m_root = m_arena.add_node(NodeType::LITERAL, value);
     return *this;
   }
 
@@ -43,7 +78,7 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::metacharacter(char character)
   {
-    m_root = std::make_unique<MetacharacterNode>(character);
+    m_root = m_arena.add_node(NodeType::METACHARACTER, {}, character);
     return *this;
   }
 
@@ -53,9 +88,9 @@ namespace ast
    * @param[in] value The value of the character class
    * @return ASTBuilder& The builder
    */
-  ASTBuilder &ConcreteBuilder::character_class(const std::string &value)
+  ASTBuilder &ConcreteBuilder::character_class(std::string_view value)
   {
-    m_root = std::make_unique<CharacterClassNode>(value);
+    m_root = m_arena.add_node(NodeType::CHARACTER_CLASS, value);
     return *this;
   }
 
@@ -65,13 +100,25 @@ namespace ast
    * @param[in] node The node to group
    * @return ASTBuilder& The builder
    */
-  ASTBuilder &ConcreteBuilder::grouping(AST_ptr &&node)
+  ASTBuilder &ConcreteBuilder::grouping(NodeIndex node)
   {
-    std::vector<std::unique_ptr<ASTNode>> children;
+    return grouping(std::span<const NodeIndex>(&node, 1));
+  }
 
-    children.push_back(std::move(node));
-    m_root = std::make_unique<GroupingNode>(std::move(children));
+  /**
+   * @brief Builds a new grouping node over a sequence of nodes
+   *
+   * @param[in] nodes The nodes to group, in order
+   * @return ASTBuilder& The builder
+   */
+  ASTBuilder &ConcreteBuilder::grouping(std::span<const NodeIndex> nodes)
+  {
+    const NodeIndex group = m_arena.add_node(NodeType::GROUPING);
 
+    for (const NodeIndex node : nodes)
+      m_arena.add_child(group, node);
+
+    m_root = group;
     return *this;
   }
 
@@ -80,13 +127,18 @@ namespace ast
    *
    * @param[in] node The node to quantify
    * @param[in] min The minimum number of times to match the node
-   * @param[in] max The maximum number of times to match the node
+   * @param[in] max The maximum number of times to match the node, or
+   *            UNBOUNDED
    * @return ASTBuilder& The builder
+   * @throw std::invalid_argument If min is UNBOUNDED or exceeds max
    */
-  ASTBuilder &ConcreteBuilder::quantifier(AST_ptr &&node, int min, int max)
+  ASTBuilder &ConcreteBuilder::quantifier(NodeIndex node, std::uint32_t min,
+                                          std::uint32_t max)
   {
-    m_root = std::make_unique<QuantifierNode>(std::move(node),
-                                              min, max);
+    if (min == UNBOUNDED || min > max)
+      throw std::invalid_argument("Builder: invalid quantifier bounds");
+
+    m_root = m_arena.add_quantifier(node, min, max);
     return *this;
   }
 
@@ -98,7 +150,8 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::anchor(char character)
   {
-    m_root = std::make_unique<AnchorNode>(std::string(1, character));
+    m_root = m_arena.add_node(NodeType::ANCHOR,
+                              std::string_view(&character, 1));
     return *this;
   }
 
@@ -110,7 +163,7 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::escape_sequence(char character)
   {
-    m_root = std::make_unique<EscapeSequenceNode>(character);
+    m_root = m_arena.add_node(NodeType::ESCAPE_SEQUENCE, {}, character);
     return *this;
   }
 
@@ -121,7 +174,7 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::wildcard()
   {
-    m_root = std::make_unique<WildcardNode>();
+    m_root = m_arena.add_node(NodeType::WILDCARD);
     return *this;
   }
 
@@ -132,14 +185,14 @@ namespace ast
    * @param[in] right The right node of the alternation
    * @return ASTBuilder& The builder
    */
-  ASTBuilder &ConcreteBuilder::alternation(AST_ptr &&left, AST_ptr &&right)
+  ASTBuilder &ConcreteBuilder::alternation(NodeIndex left, NodeIndex right)
   {
-    std::vector<std::unique_ptr<ASTNode>> children;
+    const NodeIndex alternation = m_arena.add_node(NodeType::ALTERNATION);
 
-    children.push_back(std::move(left));
-    children.push_back(std::move(right));
+    m_arena.add_child(alternation, left);
+    m_arena.add_child(alternation, right);
 
-    m_root = std::make_unique<AlternationNode>(std::move(children));
+    m_root = alternation;
     return *this;
   }
 
@@ -151,7 +204,8 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::boundary(char character)
   {
-    m_root = std::make_unique<BoundaryNode>(std::string(1, character));
+    m_root = m_arena.add_node(NodeType::BOUNDARY,
+                              std::string_view(&character, 1));
     return *this;
   }
 
@@ -163,7 +217,8 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::modifier(char character)
   {
-    m_root = std::make_unique<ModifierNode>(std::string(1, character));
+    m_root = m_arena.add_node(NodeType::MODIFIER,
+                              std::string_view(&character, 1));
     return *this;
   }
 
@@ -175,7 +230,8 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::invalid(char character)
   {
-    m_root = std::make_unique<InvalidNode>(std::string(1, character));
+    m_root = m_arena.add_node(NodeType::INVALID,
+                              std::string_view(&character, 1));
     return *this;
   }
 
@@ -186,21 +242,41 @@ namespace ast
    */
   ASTBuilder &ConcreteBuilder::end_of_input()
   {
-    m_root = std::make_unique<EndOfInputNode>();
+    m_root = m_arena.add_node(NodeType::END_OF_INPUT);
     return *this;
   }
 
   /**
-   * @brief Gets the children of the root node
+   * @brief Gets the arena holding the nodes built so far
+   *
+   * @return Arena& The arena
+   */
+  Arena &ConcreteBuilder::get_arena() noexcept
+  {
+    return m_arena;
+  }
+
+  /**
+   * @brief Gets the arena holding the nodes built so far
+   *
+   * @return const Arena& The arena
+   */
+  const Arena &ConcreteBuilder::get_arena() const noexcept
+  {
+    return m_arena;
+  }
+
+  /**
+   * @brief Gets the nodes of the tree under the root, in pre-order
    *
-   * @return std::vector<ASTNode *> The children of the root node
+   * @return std::vector<NodeIndex> The nodes, starting with the root
    */
-  std::vector<ASTNode *> ConcreteBuilder::get_children() const
+  std::vector<NodeIndex> ConcreteBuilder::get_children() const
   {
-    std::vector<ASTNode *> children;
+    std::vector<NodeIndex> children;
 
-    if (m_root)
-      collect_children(m_root.get(), children);
+    if (m_root != NO_NODE)
+      collect_children(m_root, children);
 
     return children;
   }
@@ -211,13 +287,13 @@ namespace ast
    * @param[in] node The node to collect the children of
    * @param[out] children The children of the node
    */
-  void ConcreteBuilder::collect_children(ASTNode *node,
-                                         std::vector<ASTNode *> &children) const
+  void ConcreteBuilder::collect_children(NodeIndex node,
+                                         std::vector<NodeIndex> &children) const
   {
     children.emplace_back(node);
 
-    for (auto &child : node->get_children())
-      collect_children(child.get(), children);
+    for (const NodeIndex child : m_arena.get_children(node))
+      collect_children(child, children);
   }
 
   /**
@@ -227,20 +303,20 @@ namespace ast
   std::string ConcreteBuilder::to_string() const
   {
     std::stringstream ss;
-    std::function<void(ASTNode *, int)> print;
+    std::function<void(NodeIndex, int)> print;
 
-    print = [&ss, &print](ASTNode *node, int depth)
+    print = [this, &ss, &print](NodeIndex node, int depth)
     {
-      ss << std::string(depth, ' ') << node->to_string() << std::endl;
+      ss << std::string(depth, ' ') << m_arena.to_string(node) << std::endl;
 
-      for (auto &child : node->get_children())
-        print(child.get(), depth + 1);
+      for (const NodeIndex child : m_arena.get_children(node))
+        print(child, depth + 1);
     };
 
-    if (m_root)
-      print(m_root.get(), 0);
+    if (m_root != NO_NODE)
+      print(m_root, 0);
 
     return ss.str();
   }
 
-} // namespace ast
\ No newline at end of file
+} // namespace ast
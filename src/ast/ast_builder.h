@@ -1,35 +1,41 @@
-#include <memory>
+#pragma once
+
+#include <span>
 #include <vector>
 #include <string>
+#include <string_view>
 
-#include "node/node.h"
+#include "arena.h"
 
 namespace ast
 {
-  using AST_ptr = std::unique_ptr<ASTNode>;
-
   /**
    * @class ASTBuilder
    * @brief The ASTBuilder class is an interface for building an AST
    *
+   * @details Every node builder appends a node to the builder's arena and
+   *          makes it the current root. Composite builders take the indices
+   *          of nodes built before.
    */
   class ASTBuilder
   {
   public:
     virtual ~ASTBuilder() = default;
 
-    virtual AST_ptr build() = 0;
+    virtual NodeIndex build() = 0;
 
     // Node builders
-    virtual ASTBuilder &literal(const std::string &value) = 0;
+    virtual ASTBuilder &literal(std::string_view value) = 0;
     virtual ASTBuilder &metacharacter(char character) = 0;
-    virtual ASTBuilder &character_class(const std::string &value) = 0;
-    virtual ASTBuilder &grouping(AST_ptr &&node) = 0;
-    virtual ASTBuilder &quantifier(AST_ptr &&node, int min, int max) = 0;
+    virtual ASTBuilder &character_class(std::string_view value) = 0;
+    virtual ASTBuilder &grouping(NodeIndex node) = 0;
+    virtual ASTBuilder &grouping(std::span<const NodeIndex> nodes) = 0;
+    virtual ASTBuilder &quantifier(NodeIndex node, std::uint32_t min,
+                                   std::uint32_t max) = 0;
     virtual ASTBuilder &anchor(char character) = 0;
     virtual ASTBuilder &escape_sequence(char character) = 0;
     virtual ASTBuilder &wildcard() = 0;
-    virtual ASTBuilder &alternation(AST_ptr &&left, AST_ptr &&right) = 0;
+    virtual ASTBuilder &alternation(NodeIndex left, NodeIndex right) = 0;
     virtual ASTBuilder &boundary(char character) = 0;
     virtual ASTBuilder &modifier(char character) = 0;
     virtual ASTBuilder &invalid(char character) = 0;
@@ -45,38 +51,42 @@ namespace ast
   class ConcreteBuilder : public ASTBuilder
   {
   public:
-    /**
-     * @brief Construct a new Concrete Builder:: Concrete Builder object
-     *
-     */
-    ConcreteBuilder() : m_root(nullptr) {}
+    ConcreteBuilder() = default;
 
-    AST_ptr build() override;
-    void reset();
+    NodeIndex build() override;
+    Arena release();
+    void reset() noexcept;
+    void add_child(NodeIndex parent, NodeIndex child);
 
     // Node builders
-    ASTBuilder &literal(const std::string &value) override;
+    ASTBuilder &literal(std::string_view value) override;
     ASTBuilder &metacharacter(char character) override;
-    ASTBuilder &character_class(const std::string &value) override;
-    ASTBuilder &grouping(AST_ptr &&node) override;
-    ASTBuilder &quantifier(AST_ptr &&node, int min, int max) override;
+    ASTBuilder &character_class(std::string_view value) override;
+    ASTBuilder &grouping(NodeIndex node) override;
+    ASTBuilder &grouping(std::span<const NodeIndex> nodes) override;
+    ASTBuilder &quantifier(NodeIndex node, std::uint32_t min,
+                           std::uint32_t max) override;
     ASTBuilder &anchor(char character) override;
     ASTBuilder &escape_sequence(char character) override;
     ASTBuilder &wildcard() override;
-    ASTBuilder &alternation(AST_ptr &&left, AST_ptr &&right) override;
+    ASTBuilder &alternation(NodeIndex left, NodeIndex right) override;
     ASTBuilder &boundary(char character) override;
     ASTBuilder &modifier(char character) override;
     ASTBuilder &invalid(char character) override;
     ASTBuilder &end_of_input() override;
 
-    // TODO: Add a print method
-    std::vector<ASTNode *> get_children() const;
+    // Getters
+    [[nodiscard]] Arena &get_arena() noexcept;
+    [[nodiscard]] const Arena &get_arena() const noexcept;
+
+    std::vector<NodeIndex> get_children() const;
     std::string to_string() const;
 
   private:
-    AST_ptr m_root;
+    Arena m_arena;
+    NodeIndex m_root = NO_NODE;
 
-    void collect_children(ASTNode *node,
-                          std::vector<ASTNode *> &children) const;
+    void collect_children(NodeIndex node,
+                          std::vector<NodeIndex> &children) const;
   };
-} // namespace ast
\ No newline at end of file
+} // namespace ast
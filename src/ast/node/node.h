@@ -1,78 +1,189 @@
-#include <cstdint>
-#include <memory>
-#include <vector>
+#pragma once
 
-#include "../visitors/ast_visitor.h"
+#include <cstdint>
+#include <iterator>
+#include <string_view>
 
 namespace ast
 {
-  class ASTNode
+  /**
+   * @brief Index of a node inside its Arena
+   *
+   */
+  using NodeIndex = std::uint32_t;
+
+  /**
+   * @brief Index used for "no node", e.g. a leaf's first child
+   *
+   */
+  inline constexpr NodeIndex NO_NODE = ~NodeIndex{0};
+
+  /**
+   * @brief Quantifier maximum that stands for "no upper limit"
+   *
+   */
+  inline constexpr std::uint32_t UNBOUNDED = ~std::uint32_t{0};
+
+  /**
+   * @brief The NodeType enum represents the different kinds of AST nodes
+   *
+   */
+  enum class NodeType : std::uint8_t
   {
-  public:
-    virtual ~ASTNode() = default;
+    LITERAL,
+    METACHARACTER,
+    CHARACTER_CLASS,
+    GROUPING,
+    QUANTIFIER,
+    ANCHOR,
+    ESCAPE_SEQUENCE,
+    WILDCARD,
+    ALTERNATION,
+    BOUNDARY,
+    MODIFIER,
+    INVALID,
+    END_OF_INPUT
+  };
 
-    virtual std::vector<std::unique_ptr<ASTNode>> &get_children() = 0;
-    virtual void add_child(std::unique_ptr<ASTNode> child) = 0;
-    virtual void accept(AstVisitor &visitor) = 0;
-    virtual std::string to_string() const = 0;
+  /**
+   * @struct Node
+   * @brief Storage record of a node in the Arena
+   *
+   * @details Children form a singly linked list through next_sibling, so a
+   *          node can gain children after creation without moving anything.
+   *          String payloads live in the arena's text buffer at
+   *          [value_offset, value_offset + value_length).
+   */
+  struct Node
+  {
+    NodeType type = NodeType::INVALID;
+    char character = '\0';
+    std::uint32_t min_occurrences = 0;
+    std::uint32_t max_occurrences = 0;
+    NodeIndex first_child = NO_NODE;
+    NodeIndex last_child = NO_NODE;
+    NodeIndex next_sibling = NO_NODE;
+    std::uint32_t value_offset = 0;
+    std::uint32_t value_length = 0;
   };
 
   /**
-   * @class AlternationNode
-   * @brief The AlternationNode class represents an alternation in a regex
-   *        expression
-   *b
+   * @class ChildRange
+   * @brief Forward range over the children of a node
+   *
    */
-  class LiteralNode : public ASTNode
+  class ChildRange
   {
   public:
-    std::string value;
-
     /**
-     * @brief Construct a new Literal Node:: Literal Node object
+     * @class Iterator
+     * @brief Follows the sibling links of the children
      *
-     * @param[in] value The value of the literal
      */
-    explicit LiteralNode(const std::string &value) : value(value) {}
+    class Iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = NodeIndex;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const NodeIndex *;
+      using reference = NodeIndex;
+
+      Iterator() = default;
+
+      /**
+       * @brief Construct a new Iterator:: Iterator object
+       *
+       * @param[in] nodes The node storage of the arena
+       * @param[in] index The current child, or NO_NODE at the end
+       */
+      Iterator(const Node *nodes, NodeIndex index)
+          : m_nodes(nodes), m_index(index)
+      {
+      }
+
+      NodeIndex operator*() const noexcept
+      {
+        return m_index;
+      }
+
+      Iterator &operator++() noexcept
+      {
+        m_index = m_nodes[m_index].next_sibling;
+        return *this;
+      }
+
+      Iterator operator++(int) noexcept
+      {
+        Iterator previous = *this;
+        ++*this;
+
+        return previous;
+      }
+
+      bool operator==(const Iterator &other) const noexcept
+      {
+        return m_index == other.m_index;
+      }
+
+    private:
+      const Node *m_nodes = nullptr;
+      NodeIndex m_index = NO_NODE;
+    };
+
+    ChildRange() = default;
 
     /**
-     * @brief Returns the children of the node
+     * @brief Construct a new Child Range:: Child Range object
      *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
+     * @param[in] nodes The node storage of the arena
+     * @param[in] first The first child, or NO_NODE if there is none
      */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
+    ChildRange(const Node *nodes, NodeIndex first)
+        : m_nodes(nodes), m_first(first)
     {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
     }
 
-    /**
-     * @brief Adds a child to the node
-     * @details Literals cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
+    [[nodiscard]] Iterator begin() const noexcept
+    {
+      return Iterator(m_nodes, m_first);
+    }
 
-    /**
-     * @brief Adds a child to the node
-     *
-     * @param[in] child The child to add
-     */
-    void accept(AstVisitor &visitor) override
+    [[nodiscard]] Iterator end() const noexcept
+    {
+      return Iterator(m_nodes, NO_NODE);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
     {
-      visitor.visit_literal_node(*this);
+      return m_first == NO_NODE;
     }
 
     /**
-     * @brief Returns the string representation of the node
+     * @brief Counts the children
      *
-     * @return std::string The string representation of the node
+     * @return std::size_t The number of children
      */
-    std::string to_string() const override
+    [[nodiscard]] std::size_t size() const noexcept
     {
-      return value;
+      return static_cast<std::size_t>(std::distance(begin(), end()));
     }
+
+  private:
+    const Node *m_nodes = nullptr;
+    NodeIndex m_first = NO_NODE;
+  };
+
+  /**
+   * @class LiteralNode
+   * @brief The LiteralNode class represents a literal in a regex expression
+   *
+   */
+  class LiteralNode
+  {
+  public:
+    NodeIndex index;
+    std::string_view value;
   };
 
   /**
@@ -81,56 +192,11 @@ namespace ast
    *        expression
    *
    */
-  class MetacharacterNode : public ASTNode
+  class MetacharacterNode
   {
   public:
+    NodeIndex index;
     char character;
-
-    /**
-     * @brief Construct a new Metacharacter Node:: Metacharacter Node object
-     *
-     * @param[in] character The character of the metacharacter
-     */
-    explicit MetacharacterNode(char character) : character(character) {}
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Metacharacters cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_metacharacter_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return std::string(1, character);
-    }
   };
 
   /**
@@ -139,56 +205,11 @@ namespace ast
    *        expression
    *
    */
-  class CharacterClassNode : public ASTNode
+  class CharacterClassNode
   {
   public:
-    std::string value;
-
-    /**
-     * @brief Construct a new Character Class Node:: Character Class Node object
-     *
-     * @param[in] value The value of the character class
-     */
-    explicit CharacterClassNode(const std::string &value) : value(value) {}
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Character classes cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_character_class_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return value;
-    }
+    NodeIndex index;
+    std::string_view value;
   };
 
   /**
@@ -196,67 +217,11 @@ namespace ast
    * @brief The GroupingNode class represents a grouping in a regex expression
    *
    */
-  class GroupingNode : public ASTNode
+  class GroupingNode
   {
   public:
-    std::vector<std::unique_ptr<ASTNode>> children;
-
-    /**
-     * @brief Construct a new Grouping Node:: Grouping Node object
-     *
-     * @param[in] children The children of the grouping
-     */
-    explicit GroupingNode(std::vector<std::unique_ptr<ASTNode>> children)
-        : children(std::move(children))
-    {
-    }
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      return children;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> child) override
-    {
-      children.push_back(std::move(child));
-    }
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_grouping_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      std::string result = "(";
-
-      for (const auto &child : children)
-        result += child->to_string();
-
-      result += ")";
-
-      return result;
-    }
+    NodeIndex index;
+    ChildRange children;
   };
 
   /**
@@ -265,82 +230,13 @@ namespace ast
    *        expression
    *
    */
-  class QuantifierNode : public ASTNode
+  class QuantifierNode
   {
   public:
-    std::unique_ptr<ASTNode> child;
-    std::uint8_t min_occurrences;
-    std::uint8_t max_occurrences;
-
-    /**
-     * @brief Construct a new Quantifier Node:: Quantifier Node object
-     *
-     * @param[in] child The child of the quantifier
-     * @param[in] min_occurrences The minimum number of occurrences
-     * @param[in] max_occurrences The maximum number of occurrences
-     */
-    QuantifierNode(std::unique_ptr<ASTNode> child, std::uint8_t min_occurrences,
-                   std::uint8_t max_occurrences)
-        : child(std::move(child)), min_occurrences(min_occurrences),
-          max_occurrences(max_occurrences)
-    {
-    }
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_quantifier_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      std::string result = child->to_string();
-
-      if (min_occurrences == 0 && max_occurrences == 1)
-        result += "?";
-
-      else if (min_occurrences == 0 && max_occurrences == 255)
-        result += "*";
-
-      else if (min_occurrences == 1 && max_occurrences == 255)
-        result += "+";
-
-      else if (min_occurrences == max_occurrences)
-        result += "{" + std::to_string(min_occurrences) + "}";
-
-      else
-        result += "{" + std::to_string(min_occurrences) + "," +
-                  std::to_string(max_occurrences) + "}";
-
-      return result;
-    }
+    NodeIndex index;
+    NodeIndex child;
+    std::uint32_t min_occurrences;
+    std::uint32_t max_occurrences;
   };
 
   /**
@@ -348,56 +244,11 @@ namespace ast
    * @brief The AnchorNode class represents an anchor in a regex expression
    *
    */
-  class AnchorNode : public ASTNode
+  class AnchorNode
   {
   public:
-    std::string value;
-
-    /**
-     * @brief Construct a new Anchor Node:: Anchor Node object
-     *
-     * @param[in] value The value of the anchor
-     */
-    explicit AnchorNode(const std::string &value) : value(value) {}
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Anchors cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_anchor_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return value;
-    }
+    NodeIndex index;
+    std::string_view value;
   };
 
   /**
@@ -406,56 +257,11 @@ namespace ast
    *        regex expression
    *
    */
-  class EscapeSequenceNode : public ASTNode
+  class EscapeSequenceNode
   {
   public:
+    NodeIndex index;
     char character;
-
-    /**
-     * @brief Construct a new Escape Sequence Node:: Escape Sequence Node object
-     *
-     * @param[in] character The character of the escape sequence
-     */
-    explicit EscapeSequenceNode(char character) : character(character) {}
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Escape sequences cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_escape_sequence_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return std::string(1, character);
-    }
   };
 
   /**
@@ -463,53 +269,10 @@ namespace ast
    * @brief The WildcardNode class represents a wildcard in a regex expression
    *
    */
-  class WildcardNode : public ASTNode
+  class WildcardNode
   {
   public:
-    /**
-     * @brief Construct a new Wildcard Node:: Wildcard Node object
-     *
-     */
-    explicit WildcardNode() {}
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Wildcards cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_wildcard_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return ".";
-    }
+    NodeIndex index;
   };
 
   /**
@@ -518,66 +281,11 @@ namespace ast
    *        expression
    *
    */
-  class AlternationNode : public ASTNode
+  class AlternationNode
   {
   public:
-    std::vector<std::unique_ptr<ASTNode>> children;
-
-    /**
-     * @brief Construct a new Alternation Node:: Alternation Node object
-     *
-     * @param[in] children The children of the alternation
-     */
-    explicit AlternationNode(std::vector<std::unique_ptr<ASTNode>> children)
-        : children(std::move(children)) {}
-
-    /**
-     * @brief Gets the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      return children;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> child) override
-    {
-      children.push_back(std::move(child));
-    }
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_alternation_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      std::string result = "(";
-
-      for (const auto &child : children)
-        result += child->to_string() + "|";
-
-      result.pop_back();
-      result += ")";
-
-      return result;
-    }
+    NodeIndex index;
+    ChildRange children;
   };
 
   /**
@@ -585,56 +293,11 @@ namespace ast
    * @brief The BoundaryNode class represents a boundary in a regex expression
    *
    */
-  class BoundaryNode : public ASTNode
+  class BoundaryNode
   {
   public:
-    std::string value;
-
-    /**
-     * @brief Construct a new Boundary Node:: Boundary Node object
-     *
-     * @param[in] value The value of the boundary
-     */
-    explicit BoundaryNode(const std::string &value) : value(value) {}
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Boundaries cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_boundary_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return value;
-    }
+    NodeIndex index;
+    std::string_view value;
   };
 
   /**
@@ -642,56 +305,11 @@ namespace ast
    * @brief The ModifierNode class represents a modifier in a regex expression
    *
    */
-  class ModifierNode : public ASTNode
+  class ModifierNode
   {
   public:
-    std::string value;
-
-    /**
-     * @brief Construct a new Modifier Node:: Modifier Node object
-     *
-     * @param[in] value The value of the modifier
-     */
-    explicit ModifierNode(const std::string &value) : value(value) {}
-
-    /**
-     * @brief Returns the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Modifiers cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_modifier_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return value;
-    }
+    NodeIndex index;
+    std::string_view value;
   };
 
   /**
@@ -700,56 +318,11 @@ namespace ast
    *        expression
    *
    */
-  class InvalidNode : public ASTNode
+  class InvalidNode
   {
   public:
-    std::string value;
-
-    /**
-     * @brief Construct a new Invalid Node:: Invalid Node object
-     *
-     * @param[in] value The value of the invalid token
-     */
-    explicit InvalidNode(const std::string &value) : value(value) {}
-
-    /**
-     * @brief Gets the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details Invalid tokens cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_invalid_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return value;
-    }
+    NodeIndex index;
+    std::string_view value;
   };
 
   /**
@@ -758,52 +331,9 @@ namespace ast
    *        a regex expression
    *
    */
-  class EndOfInputNode : public ASTNode
+  class EndOfInputNode
   {
   public:
-    /**
-     * @brief Construct a new End Of Input Node:: End Of Input Node object
-     *
-     */
-    explicit EndOfInputNode() {}
-
-    /**
-     * @brief Gets the children of the node
-     *
-     * @return std::vector<std::unique_ptr<ASTNode>>& The children of the node
-     */
-    std::vector<std::unique_ptr<ASTNode>> &get_children() override
-    {
-      static std::vector<std::unique_ptr<ASTNode>> empty;
-      return empty;
-    }
-
-    /**
-     * @brief Adds a child to the node
-     * @details End of input nodes cannot have children
-     *
-     * @param[in] child The child to add
-     */
-    void add_child(std::unique_ptr<ASTNode> /* child */) override {}
-
-    /**
-     * @brief Accepts a visitor
-     *
-     * @param[in] visitor The visitor to accept
-     */
-    void accept(AstVisitor &visitor) override
-    {
-      visitor.visit_end_of_input_node(*this);
-    }
-
-    /**
-     * @brief Returns the string representation of the node
-     *
-     * @return std::string The string representation of the node
-     */
-    std::string to_string() const override
-    {
-      return "$";
-    }
+    NodeIndex index;
   };
-} // namespace ast
\ No newline at end of file
+} // namespace ast
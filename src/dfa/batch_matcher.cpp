@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "batch_matcher.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define REGEX_DFA_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define REGEX_DFA_PREFETCH(address) ((void)(address))
+#endif
+
+namespace dfa
+{
+  namespace
+  {
+    // Most bytes the lanes advance between two checks for finished or
+    // dead inputs
+    constexpr std::size_t MAX_RUN = 64;
+  } // namespace
+
+  /**
+   * @brief Construct a new BatchMatcher:: BatchMatcher object
+   *
+   * @param[in] dfa The automaton to run, which must outlive the matcher
+   * @param[in] options The number of interleaved lanes
+   * @throw std::invalid_argument If the lane count is not 4, 8 or 16
+   */
+  BatchMatcher::BatchMatcher(const DFA &dfa, BatchMatchOptions options)
+      : m_dfa(dfa), m_options(options)
+  {
+    if (options.lanes != 4 && options.lanes != 8 && options.lanes != 16)
+      throw std::invalid_argument("BatchMatcher: lanes must be 4, 8 or 16");
+
+    const auto &transitions = dfa.get_transitions();
+    const auto class_count = static_cast<std::uint32_t>(dfa.get_class_count());
+    m_row_offsets.reserve(transitions.size());
+
+    for (const StateId target : transitions)
+      m_row_offsets.push_back(target * class_count);
+  }
+
+  /**
+   * @brief Checks which inputs the automaton matches as a whole
+   *
+   * @param[in] inputs The inputs to match
+   * @param[out] results Set to 1 for every matching input and 0 otherwise,
+   *             at the input's index
+   * @return std::size_t The number of matching inputs
+   * @throw std::invalid_argument If results is shorter than inputs
+   */
+  std::size_t BatchMatcher::matches(std::span<const std::string_view> inputs,
+                                    std::span<std::uint8_t> results) const
+  {
+    if (results.size() < inputs.size())
+      throw std::invalid_argument(
+          "BatchMatcher: results must hold one entry per input");
+
+    switch (m_options.lanes)
+    {
+    case 4:
+      return match_interleaved<4>(inputs, results);
+
+    case 16:
+      return match_interleaved<16>(inputs, results);
+
+    default:
+      return match_interleaved<8>(inputs, results);
+    }
+  }
+
+  /**
+   * @brief Gets the number of inputs advanced together
+   *
+   * @return std::size_t The lane count
+   */
+  std::size_t BatchMatcher::get_lanes() const noexcept
+  {
+    return m_options.lanes;
+  }
+
+  /**
+   * @brief Runs the inputs through the automaton, Lanes at a time
+   * @details All lanes advance by the length of the shortest remaining
+   *          input, capped at MAX_RUN, in an inner loop without checks:
+   *          the dead state loops on every byte, so a lane that dies
+   *          early only wastes the rest of the run. Lanes that finished
+   *          are then refilled.
+   *
+   * @tparam Lanes The number of interleaved inputs
+   * @param[in] inputs The inputs to match
+   * @param[out] results The result of every input
+   * @return std::size_t The number of matching inputs
+   */
+  template <std::size_t Lanes>
+  std::size_t
+  BatchMatcher::match_interleaved(std::span<const std::string_view> inputs,
+                                  std::span<std::uint8_t> results) const
+  {
+    const std::uint32_t *row_offsets = m_row_offsets.data();
+    const DFA::ByteClassMap &classes = m_dfa.get_byte_classes();
+    const auto class_count = static_cast<std::uint32_t>(m_dfa.get_class_count());
+    const std::uint32_t start = m_dfa.get_start_state() * class_count;
+
+    // Every lane holds the row offset of its state, the state's id times
+    // the class count; the dead state's is 0
+    std::array<const std::uint8_t *, Lanes> cursors{};
+    std::array<std::size_t, Lanes> remaining{};
+    std::array<std::size_t, Lanes> indices{};
+    std::array<std::uint32_t, Lanes> rows{};
+    std::array<bool, Lanes> busy{};
+    std::size_t next_input = 0;
+    std::size_t count = 0;
+
+    const auto finish = [&](std::size_t index, std::uint32_t row)
+    {
+      results[index] = m_dfa.is_accepting_at_eof(row / class_count) ? 1 : 0;
+      count += results[index];
+    };
+
+    // Loads the next non-empty input into a lane
+    const auto refill = [&](std::size_t lane)
+    {
+      while (next_input < inputs.size())
+      {
+        const std::size_t index = next_input++;
+        const std::string_view input = inputs[index];
+
+        if (index + Lanes < inputs.size())
+          REGEX_DFA_PREFETCH(inputs[index + Lanes].data());
+
+        if (input.empty())
+        {
+          finish(index, start);
+          continue;
+        }
+
+        cursors[lane] = reinterpret_cast<const std::uint8_t *>(input.data());
+        remaining[lane] = input.size();
+        indices[lane] = index;
+        rows[lane] = start;
+        busy[lane] = true;
+        return true;
+      }
+
+      busy[lane] = false;
+      return false;
+    };
+
+    bool full = true;
+
+    for (std::size_t lane = 0; lane < Lanes; ++lane)
+      full = refill(lane) && full;
+
+    while (full)
+    {
+      std::size_t run = MAX_RUN;
+
+      for (std::size_t lane = 0; lane < Lanes; ++lane)
+        run = std::min(run, remaining[lane]);
+
+      for (std::size_t step = 0; step < run; ++step)
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+          rows[lane] = row_offsets[rows[lane] + classes[cursors[lane][step]]];
+
+      for (std::size_t lane = 0; lane < Lanes; ++lane)
+      {
+        cursors[lane] += run;
+        remaining[lane] -= run;
+
+        if (remaining[lane] != 0 && rows[lane] != 0)
+          continue;
+
+        finish(indices[lane], rows[lane]);
+        full = refill(lane) && full;
+      }
+    }
+
+    // Too few inputs are left to fill every lane
+    for (std::size_t lane = 0; lane < Lanes; ++lane)
+    {
+      if (!busy[lane])
+        continue;
+
+      std::uint32_t row = rows[lane];
+
+      for (std::size_t i = 0; i < remaining[lane] && row != 0; ++i)
+        row = row_offsets[row + classes[cursors[lane][i]]];
+
+      finish(indices[lane], row);
+    }
+
+    return count;
+  }
+} // namespace dfa
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @struct BatchMatchOptions
+   * @brief Options controlling how a BatchMatcher interleaves its inputs
+   *
+   * @details lanes is the number of inputs advanced together, one of 4, 8
+   *          or 16.
+   */
+  struct BatchMatchOptions
+  {
+    std::size_t lanes = 8;
+  };
+
+  /**
+   * @class BatchMatcher
+   * @brief Matches many short, independent inputs against one DFA
+   *
+   * @details A single walk is a chain of dependent loads, each transition
+   *          waiting on the previous one. The batch matcher advances
+   *          several inputs in lockstep, one byte of each per step, so
+   *          their loads are in flight at the same time. A lane whose
+   *          input ends or dies is refilled with the next input, and the
+   *          inputs a few records ahead are prefetched. The last inputs,
+   *          once too few are left to fill every lane, finish one at a
+   *          time. The matcher keeps a copy of the transition table whose
+   *          entries are row offsets rather than state ids, which takes a
+   *          multiplication off each dependent load.
+   */
+  class BatchMatcher
+  {
+  public:
+    explicit BatchMatcher(const DFA &dfa, BatchMatchOptions options = {});
+
+    std::size_t matches(std::span<const std::string_view> inputs,
+                        std::span<std::uint8_t> results) const;
+
+    // Getters
+    [[nodiscard]] std::size_t get_lanes() const noexcept;
+
+  private:
+    const DFA &m_dfa;
+    BatchMatchOptions m_options;
+    std::vector<std::uint32_t> m_row_offsets;
+
+    // Helper functions
+    template <std::size_t Lanes>
+    std::size_t match_interleaved(std::span<const std::string_view> inputs,
+                                  std::span<std::uint8_t> results) const;
+  };
+} // namespace dfa
@@ -0,0 +1,194 @@
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include "bit_parallel_nfa.h"
+#include "dfa_builder.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Converts a set of positions below 64 to a bit mask
+     *
+     * @param[in] set The set
+     * @return std::uint64_t The mask
+     */
+    std::uint64_t to_mask(const PositionSet &set)
+    {
+      std::uint64_t mask = 0;
+
+      set.for_each([&](std::uint32_t position)
+                   { mask |= std::uint64_t{1} << position; });
+      return mask;
+    }
+
+    /**
+     * @brief Calls a function for every byte of a set, 64 bytes at a time
+     * @details Much faster than testing the 256 bits one by one
+     *
+     * @tparam Function Callable taking a std::size_t
+     * @param[in] set The set
+     * @param[in] function The function to call
+     */
+    template <typename Function>
+    void for_each_byte(const ByteSet &set, Function &&function)
+    {
+      const ByteSet low_word(~std::uint64_t{0});
+
+      for (std::size_t word = 0; word < 4; ++word)
+        for (std::uint64_t bits = ((set >> (64 * word)) & low_word).to_ullong();
+             bits != 0; bits &= bits - 1)
+          function(64 * word + static_cast<std::size_t>(
+                                   std::countr_zero(bits)));
+    }
+  } // namespace
+
+  /**
+   * @brief Construct a new BitParallelNFA:: BitParallelNFA object
+   * @details The start positions come from DFABuilder, so '^' behaves as
+   *          in a DFA
+   *
+   * @param[in] automaton The result of the followpos analysis
+   * @throw std::invalid_argument If the automaton has too many positions
+   */
+  BitParallelNFA::BitParallelNFA(const PositionAutomaton &automaton)
+      : m_position_count(automaton.size()),
+        m_chunk_count((automaton.size() + CHUNK_BITS - 1) / CHUNK_BITS)
+  {
+    if (m_position_count > MAX_POSITIONS)
+      throw std::invalid_argument("BitParallelNFA: " +
+                                  std::to_string(m_position_count) +
+                                  " positions do not fit a word");
+
+    std::uint64_t start_anchors = 0;
+    std::uint64_t end_anchors = 0;
+    std::array<std::uint64_t, MAX_POSITIONS> follow{};
+
+    m_start = to_mask(DFABuilder(automaton).start_set());
+    m_follow.resize(m_chunk_count * 256);
+
+    for (std::uint32_t position = 0; position < m_position_count; ++position)
+    {
+      const std::uint64_t bit = std::uint64_t{1} << position;
+
+      switch (automaton.kinds[position])
+      {
+      case PositionKind::SYMBOL:
+        for_each_byte(automaton.symbols[position], [&](std::size_t byte)
+                      { m_byte_masks[byte] |= bit; });
+        break;
+
+      case PositionKind::START_ANCHOR:
+        start_anchors |= bit;
+        break;
+
+      case PositionKind::END_ANCHOR:
+        end_anchors |= bit;
+        break;
+
+      case PositionKind::END_MARKER:
+        m_accept_at_eof |= bit;
+        break;
+      }
+
+      follow[position] = to_mask(automaton.follow[position]);
+    }
+
+    // At the end of input, '$' positions pass on to what follows them
+    for (bool changed = true; changed;)
+    {
+      changed = false;
+
+      for (std::uint64_t rest = end_anchors & ~m_accept_at_eof; rest != 0;
+           rest &= rest - 1)
+      {
+        const int position = std::countr_zero(rest);
+
+        if (follow[position] & m_accept_at_eof)
+        {
+          m_accept_at_eof |= std::uint64_t{1} << position;
+          changed = true;
+        }
+      }
+    }
+
+    // A '^' is only in the start mask, before any input, where the '$'
+    // positions that follow it may be passed too
+    for (std::uint64_t rest = start_anchors; rest != 0; rest &= rest - 1)
+    {
+      const int position = std::countr_zero(rest);
+
+      if (follow[position] & m_accept_at_eof)
+        m_accept_at_eof |= std::uint64_t{1} << position;
+    }
+
+    // '^' can only be passed before the first byte
+    for (std::size_t chunk = 0; chunk < m_chunk_count; ++chunk)
+    {
+      std::uint64_t *table = &m_follow[chunk * 256];
+
+      // Every entry extends the entry without its lowest bit
+      for (std::size_t bits = 1; bits < 256; ++bits)
+      {
+        const std::size_t position =
+            chunk * CHUNK_BITS +
+            static_cast<std::size_t>(std::countr_zero(bits));
+
+        table[bits] = table[bits & (bits - 1)] |
+                      (position < m_position_count
+                           ? follow[position] & ~start_anchors
+                           : 0);
+      }
+    }
+  }
+
+  /**
+   * @brief Checks whether the automaton matches the whole input
+   *
+   * @param[in] input The input to match
+   * @return true If the input matches
+   */
+  bool BitParallelNFA::matches(std::string_view input) const noexcept
+  {
+    std::uint64_t state = m_start;
+
+    for (const char character : input)
+    {
+      const std::uint64_t matched =
+          state & m_byte_masks[static_cast<std::uint8_t>(character)];
+      std::uint64_t next = 0;
+
+      for (std::size_t chunk = 0; chunk < m_chunk_count; ++chunk)
+        next |= m_follow[chunk * 256 + ((matched >> (chunk * CHUNK_BITS)) &
+                                        0xff)];
+
+      if (next == 0)
+        return false;
+
+      state = next;
+    }
+
+    return (state & m_accept_at_eof) != 0;
+  }
+
+  /**
+   * @brief Gets the number of positions, including the end marker
+   *
+   * @return std::size_t The number of positions
+   */
+  std::size_t BitParallelNFA::get_position_count() const noexcept
+  {
+    return m_position_count;
+  }
+
+  /**
+   * @brief Gets the heap memory held by the followpos tables
+   *
+   * @return std::size_t The number of bytes
+   */
+  std::size_t BitParallelNFA::memory_usage() const noexcept
+  {
+    return m_follow.capacity() * sizeof(std::uint64_t);
+  }
+} // namespace dfa
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "position_automaton.h"
+
+namespace dfa
+{
+  /**
+   * @class BitParallelNFA
+   * @brief Simulates a position automaton of at most 64 positions with one
+   *        machine word of state
+   *
+   * @details Bit i of the state is set when position i may consume the
+   *          next byte, as in a DFABuilder state. A byte keeps the positions
+   *          whose mask contains it and replaces them by the union of their
+   *          followpos, read eight positions at a time from precomputed
+   *          tables. Building the tables takes a few microseconds and at
+   *          most 18 KiB, and there is no determinization at all.
+   */
+  class BitParallelNFA
+  {
+  public:
+    static constexpr std::size_t MAX_POSITIONS = 64;
+
+    explicit BitParallelNFA(const PositionAutomaton &automaton);
+
+    [[nodiscard]] bool matches(std::string_view input) const noexcept;
+
+    // Getters
+    [[nodiscard]] std::size_t get_position_count() const noexcept;
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+  private:
+    static constexpr std::size_t CHUNK_BITS = 8;
+
+    std::size_t m_position_count;
+    std::size_t m_chunk_count;
+    std::uint64_t m_start = 0;
+    std::uint64_t m_accept_at_eof = 0;
+
+    // The positions consuming each byte
+    std::array<std::uint64_t, 256> m_byte_masks{};
+
+    // m_follow[256 k + c]: followpos of the positions 8k + i for every bit
+    // i of c, one table per chunk of positions in use
+    std::vector<std::uint64_t> m_follow;
+  };
+} // namespace dfa
@@ -0,0 +1,237 @@
+#include <stdexcept>
+#include "byte_set.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Adds every byte in the inclusive range [first, last] to a set
+     *
+     * @param[out] set The set to fill
+     * @param[in] first The first byte of the range
+     * @param[in] last The last byte of the range
+     */
+    void add_range(ByteSet &set, unsigned char first, unsigned char last)
+    {
+      for (unsigned int byte = first; byte <= last; ++byte)
+        set.set(byte);
+    }
+
+    /**
+     * @brief Maps the character after a backslash to the byte it stands for
+     *
+     * @param[in] character The escaped character
+     * @return unsigned char The byte value
+     */
+    unsigned char escaped_byte(char character)
+    {
+      switch (character)
+      {
+      case 'n':
+        return '\n';
+
+      case 't':
+        return '\t';
+
+      case 'r':
+        return '\r';
+
+      case 'f':
+        return '\f';
+
+      case 'v':
+        return '\v';
+
+      case '0':
+        return '\0';
+
+      default:
+        return static_cast<unsigned char>(character);
+      }
+    }
+  } // namespace
+
+  /**
+   * @brief Builds the set holding a single literal byte
+   *
+   * @param[in] character The literal character
+   * @return ByteSet The set containing only that byte
+   */
+  ByteSet literal_bytes(char character)
+  {
+    ByteSet set;
+
+    set.set(static_cast<unsigned char>(character));
+    return set;
+  }
+
+  /**
+   * @brief Builds the set matched by the '.' wildcard
+   * @details The wildcard matches every byte except the newline
+   *
+   * @return ByteSet The wildcard set
+   */
+  ByteSet wildcard_bytes()
+  {
+    ByteSet set;
+
+    set.set();
+    set.reset('\n');
+
+    return set;
+  }
+
+  /**
+   * @brief Builds the set matched by an escape sequence such as "\d"
+   * @details Shorthand classes (d, w, s and their negations) expand to their
+   *          ASCII sets, control escapes map to their byte and every other
+   *          character is matched literally
+   *
+   * @param[in] character The character following the backslash
+   * @return ByteSet The set matched by the escape
+   */
+  ByteSet escape_bytes(char character)
+  {
+    ByteSet set;
+
+    switch (character)
+    {
+    case 'd':
+    case 'D':
+      add_range(set, '0', '9');
+      break;
+
+    case 'w':
+    case 'W':
+      add_range(set, 'a', 'z');
+      add_range(set, 'A', 'Z');
+      add_range(set, '0', '9');
+      set.set('_');
+      break;
+
+    case 's':
+    case 'S':
+      for (const char space : {' ', '\t', '\n', '\r', '\f', '\v'})
+        set.set(static_cast<unsigned char>(space));
+      break;
+
+    default:
+      set.set(escaped_byte(character));
+      return set;
+    }
+
+    if (character == 'D' || character == 'W' || character == 'S')
+      set.flip();
+
+    return set;
+  }
+
+  /**
+   * @brief Builds the set matched by a bracket expression
+   * @details Accepts the value with or without the surrounding brackets and
+   *          supports negation, ranges and escapes such as "[^a-z\d_]"
+   *
+   * @param[in] value The text of the character class
+   * @return ByteSet The set matched by the class
+   * @throw std::invalid_argument If a range is reversed
+   */
+  ByteSet character_class_bytes(std::string_view value)
+  {
+    if (value.size() >= 2 && value.front() == '[' && value.back() == ']')
+      value = value.substr(1, value.size() - 2);
+
+    bool negated = false;
+
+    if (!value.empty() && value.front() == '^')
+    {
+      negated = true;
+      value.remove_prefix(1);
+    }
+
+    ByteSet set;
+    std::size_t index = 0;
+
+    while (index < value.size())
+    {
+      unsigned char first = static_cast<unsigned char>(value[index]);
+
+      if (first == '\\' && index + 1 < value.size())
+      {
+        const char escaped = value[index + 1];
+        const ByteSet escaped_set = escape_bytes(escaped);
+        index += 2;
+
+        if (escaped_set.count() != 1)
+        {
+          set |= escaped_set;
+          continue;
+        }
+
+        first = escaped_byte(escaped);
+      }
+      else
+        ++index;
+
+      if (index + 1 < value.size() && value[index] == '-')
+      {
+        unsigned char last = static_cast<unsigned char>(value[index + 1]);
+        index += 2;
+
+        if (last == '\\' && index < value.size())
+          last = escaped_byte(value[index++]);
+
+        if (last < first)
+          throw std::invalid_argument("Invalid character class range");
+
+        add_range(set, first, last);
+      }
+      else
+        set.set(first);
+    }
+
+    if (negated)
+      set.flip();
+
+    return set;
+  }
+
+  /**
+   * @brief Computes the coarsest byte classes that respect every set
+   * @details Two bytes share a class when every set contains either both or
+   *          neither of them, so a DFA built from these sets needs one
+   *          transition column per class rather than per byte
+   *
+   * @param[in] sets The byte sets to respect
+   * @return ByteClasses The byte classes
+   */
+  ByteClasses byte_classes(const std::vector<ByteSet> &sets)
+  {
+    ByteClasses classes;
+
+    for (const auto &set : sets)
+    {
+      if (set.none() || set.all())
+        continue;
+
+      std::array<std::int16_t, 512> renumber;
+      renumber.fill(-1);
+
+      std::size_t count = 0;
+
+      for (std::size_t byte = 0; byte < classes.map.size(); ++byte)
+      {
+        const std::size_t key = classes.map[byte] * 2u + set.test(byte);
+
+        if (renumber[key] < 0)
+          renumber[key] = static_cast<std::int16_t>(count++);
+
+        classes.map[byte] = static_cast<std::uint8_t>(renumber[key]);
+      }
+
+      classes.count = count;
+    }
+
+    return classes;
+  }
+} // namespace dfa
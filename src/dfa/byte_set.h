@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace dfa
+{
+  /**
+   * @brief Set of input bytes a single position can consume
+   *
+   */
+  using ByteSet = std::bitset<256>;
+
+  /**
+   * @struct ByteClasses
+   * @brief Partition of the 256 bytes into classes that no byte set tells
+   *        apart
+   *
+   * @details map[b] is the class of byte b. Classes are numbered in order of
+   *          their smallest byte, so byte 0 is always in class 0.
+   */
+  struct ByteClasses
+  {
+    std::array<std::uint8_t, 256> map{};
+    std::size_t count = 1;
+  };
+
+  ByteSet literal_bytes(char character);
+  ByteSet wildcard_bytes();
+  ByteSet escape_bytes(char character);
+  ByteSet character_class_bytes(std::string_view value);
+  ByteClasses byte_classes(const std::vector<ByteSet> &sets);
+} // namespace dfa
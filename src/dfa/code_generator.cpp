@@ -0,0 +1,387 @@
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <span>
+#include <stdexcept>
+
+#include "code_generator.h"
+
+namespace dfa
+{
+  namespace
+  {
+    struct ByteRange
+    {
+      std::uint32_t first;
+      StateId target;
+    };
+
+    /**
+     * @brief Checks whether a name is a valid C++ identifier, possibly
+     *        qualified with ::
+     *
+     * @param[in] name The name to check
+     * @return true If the name can be used as a namespace name
+     */
+    bool is_namespace_name(const std::string &name)
+    {
+      std::size_t start = 0;
+
+      while (true)
+      {
+        const std::size_t end = std::min(name.find("::", start), name.size());
+
+        if (end == start ||
+            std::isdigit(static_cast<unsigned char>(name[start])))
+          return false;
+
+        for (std::size_t i = start; i < end; ++i)
+          if (!std::isalnum(static_cast<unsigned char>(name[i])) &&
+              name[i] != '_')
+            return false;
+
+        if (end == name.size())
+          return true;
+
+        start = end + 2;
+      }
+    }
+
+    /**
+     * @brief Quotes a pattern as a C++ string literal
+     * @details Bytes that are not printable are written as three-digit
+     *          octal escapes, which cannot run into the following byte
+     *
+     * @param[in] text The pattern
+     * @return std::string The literal
+     */
+    std::string quote(const std::string &text)
+    {
+      static const char digits[] = "01234567";
+      std::string literal = "\"";
+
+      for (const char character : text)
+      {
+        const auto byte = static_cast<unsigned char>(character);
+
+        if (character == '"' || character == '\\')
+        {
+          literal += '\\';
+          literal += character;
+        }
+
+        else if (byte < 0x20 || byte >= 0x7F)
+        {
+          literal += '\\';
+          literal += digits[byte >> 6];
+          literal += digits[(byte >> 3) & 7];
+          literal += digits[byte & 7];
+        }
+
+        else
+          literal += character;
+      }
+
+      return literal + '"';
+    }
+
+    /**
+     * @brief Writes the elements of a table, 16 per line
+     *
+     * @tparam Values A range of integers
+     * @param[in] output The stream to write to
+     * @param[in] values The elements
+     */
+    template <typename Values>
+    void write_elements(std::ostream &output, const Values &values)
+    {
+      std::size_t column = 0;
+
+      for (const auto value : values)
+      {
+        output << (column == 0 ? "" : ",")
+               << (column % 16 == 0 ? "\n      " : " ")
+               << static_cast<std::uint64_t>(value);
+        ++column;
+      }
+
+      output << "};\n";
+    }
+
+    /**
+     * @brief Writes the jump to a state, or the return of the dead state
+     *
+     * @param[in] output The stream to write to
+     * @param[in] target The next state
+     * @param[in] indent The indentation of the statement
+     */
+    void write_jump(std::ostream &output, StateId target,
+                    const std::string &indent)
+    {
+      if (target == DFA::DEAD_STATE)
+        output << indent << "return 0;\n";
+
+      else
+        output << indent << "goto s" << target << ";\n";
+    }
+
+    /**
+     * @brief Writes a binary search over byte ranges, with the byte in c
+     *
+     * @param[in] output The stream to write to
+     * @param[in] ranges The ranges, sorted by first byte
+     * @param[in] indent The indentation of the tree
+     */
+    void write_compare_tree(std::ostream &output,
+                            std::span<const ByteRange> ranges,
+                            const std::string &indent)
+    {
+      if (ranges.size() == 1)
+      {
+        write_jump(output, ranges[0].target, indent);
+        return;
+      }
+
+      const std::size_t middle = ranges.size() / 2;
+
+      output << indent << "if (c < " << ranges[middle].first << ")\n"
+             << indent << "{\n";
+      write_compare_tree(output, ranges.first(middle), indent + "  ");
+      output << indent << "}\n";
+      write_compare_tree(output, ranges.subspan(middle), indent);
+    }
+
+    /**
+     * @brief Writes the direct-coded scan, one label per live state
+     *
+     * @param[in] output The stream to write to
+     * @param[in] dfa The automaton
+     */
+    void write_direct_scan(std::ostream &output, const DFA &dfa)
+    {
+      const std::string indent = "    ";
+
+      output << indent << "const auto *p = reinterpret_cast<const unsigned "
+                          "char *>(input.data());\n"
+             << indent << "const auto *const end = p + input.size();\n"
+             << indent << "unsigned c;\n\n";
+      write_jump(output, dfa.get_start_state(), indent);
+
+      for (StateId state = 1; state < dfa.get_state_count(); ++state)
+      {
+        output << "\n  s" << state << ":\n"
+               << indent << "if (p == end)\n"
+               << indent << "  return " << state << ";\n"
+               << indent << "c = *p++;\n";
+
+        std::vector<ByteRange> ranges;
+
+        for (std::uint32_t byte = 0; byte < DFA::ALPHABET_SIZE; ++byte)
+        {
+          const StateId target = dfa.next(state, static_cast<std::uint8_t>(byte));
+
+          if (ranges.empty() || ranges.back().target != target)
+            ranges.push_back({byte, target});
+        }
+
+        if (ranges.size() <= CodeGenerator::MAX_COMPARE_RANGES)
+        {
+          write_compare_tree(output, ranges, indent);
+          continue;
+        }
+
+        // Classes grouped by target, so each target is written once
+        std::map<StateId, std::vector<std::size_t>> cases;
+
+        for (std::size_t byte_class = 0; byte_class < dfa.get_class_count();
+             ++byte_class)
+          cases[dfa.next_class(state, byte_class)].push_back(byte_class);
+
+        output << indent << "switch (BYTE_CLASSES[c])\n"
+               << indent << "{\n";
+
+        for (const auto &[target, classes] : cases)
+        {
+          if (target == DFA::DEAD_STATE)
+            continue;
+
+          for (const auto byte_class : classes)
+            output << indent << "case " << byte_class << ":\n";
+
+          write_jump(output, target, indent + "  ");
+        }
+
+        output << indent << "default:\n"
+               << indent << "  return 0;\n"
+               << indent << "}\n";
+      }
+    }
+  } // namespace
+
+  /**
+   * @brief Writes a DFA as a C++ header
+   * @details The header declares, in options.namespace_name, the PATTERNS
+   *          it was generated from, the DFA tables, final_state(),
+   *          matches() and matching_patterns()
+   *
+   * @param[in] dfa The automaton to write, usually from compile_set()
+   * @param[in] patterns The source patterns, recorded in the header
+   * @param[in] output The stream to write to
+   * @param[in] options The namespace and the size limit of the
+   *            direct-coded scan
+   * @throw std::invalid_argument If the namespace name is not valid C++
+   * @throw std::runtime_error If the stream fails
+   */
+  void CodeGenerator::write(const DFA &dfa,
+                            const std::vector<std::string> &patterns,
+                            std::ostream &output,
+                            const CodeGenOptions &options)
+  {
+    if (!is_namespace_name(options.namespace_name))
+      throw std::invalid_argument("CodeGenerator: invalid namespace name " +
+                                  options.namespace_name);
+
+    const std::size_t states = dfa.get_state_count();
+    std::vector<std::uint32_t> accept_offsets{0};
+    std::vector<std::uint32_t> accept_ids;
+
+    for (StateId state = 0; state < states; ++state)
+    {
+      const auto ids = dfa.get_accept_ids(state);
+      accept_ids.insert(accept_ids.end(), ids.begin(), ids.end());
+      accept_offsets.push_back(static_cast<std::uint32_t>(accept_ids.size()));
+    }
+
+    const char *state_type = states <= 0x100     ? "std::uint8_t"
+                             : states <= 0x10000 ? "std::uint16_t"
+                                                 : "std::uint32_t";
+
+    output << "// Generated by RegexToDFAConverter; do not edit.\n"
+           << "#pragma once\n\n"
+           << "#include <array>\n"
+           << "#include <cstddef>\n"
+           << "#include <cstdint>\n"
+           << "#include <span>\n"
+           << "#include <string_view>\n\n"
+           << "namespace " << options.namespace_name << "\n{\n";
+
+    output << "  inline constexpr std::array<std::string_view, "
+           << patterns.size() << "> PATTERNS = {";
+
+    for (std::size_t i = 0; i < patterns.size(); ++i)
+      output << (i == 0 ? "" : ",") << "\n      " << quote(patterns[i]);
+
+    output << "};\n\n"
+           << "  inline constexpr std::size_t STATE_COUNT = " << states
+           << ";\n"
+           << "  inline constexpr std::size_t CLASS_COUNT = "
+           << dfa.get_class_count() << ";\n"
+           << "  inline constexpr std::uint32_t START_STATE = "
+           << dfa.get_start_state() << ";\n\n"
+           << "  // State 0 is dead: it rejects and loops on every byte\n"
+           << "  inline constexpr std::array<std::uint8_t, 256> BYTE_CLASSES "
+              "= {";
+    write_elements(output, dfa.get_byte_classes());
+
+    output << "  inline constexpr std::array<" << state_type << ", "
+           << dfa.get_transitions().size() << "> TRANSITIONS = {";
+    write_elements(output, dfa.get_transitions());
+
+    output << "  // Bit 0: a match ends here; bit 1: a match ends here at the "
+              "end of\n"
+           << "  // input\n"
+           << "  inline constexpr std::array<std::uint8_t, " << states
+           << "> ACCEPT_FLAGS = {";
+    write_elements(output, dfa.get_accept_flags());
+
+    output << "  // The ids of the patterns matching at the end of input in "
+              "state s are\n"
+           << "  // ACCEPT_IDS[ACCEPT_OFFSETS[s]] up to, excluding, "
+              "ACCEPT_IDS[ACCEPT_OFFSETS[s + 1]]\n"
+           << "  inline constexpr std::array<std::uint32_t, "
+           << accept_offsets.size() << "> ACCEPT_OFFSETS = {";
+    write_elements(output, accept_offsets);
+    output << "  inline constexpr std::array<std::uint32_t, "
+           << accept_ids.size() << "> ACCEPT_IDS = {";
+    write_elements(output, accept_ids);
+
+    output << R"(
+  // Runs the tables over the input and returns the state after it, 0 if
+  // the input cannot match; also usable in constant expressions
+  constexpr std::uint32_t final_state_of_tables(std::string_view input) noexcept
+  {
+    std::uint32_t state = START_STATE;
+
+    for (const char character : input)
+    {
+      state = TRANSITIONS[state * CLASS_COUNT +
+                          BYTE_CLASSES[static_cast<unsigned char>(character)]];
+
+      if (state == 0)
+        return 0;
+    }
+
+    return state;
+  }
+
+  // Returns the state after the input, 0 if the input cannot match
+  inline std::uint32_t final_state(std::string_view input) noexcept
+  {
+)";
+
+    if (states <= options.max_direct_states)
+      write_direct_scan(output, dfa);
+
+    else
+      output << "    return final_state_of_tables(input);\n";
+
+    output << R"(  }
+
+  // Checks whether the input matches as a whole
+  inline bool matches(std::string_view input) noexcept
+  {
+    return (ACCEPT_FLAGS[final_state(input)] & 2) != 0;
+  }
+
+  // Returns the ids of the patterns matching the whole input, in increasing
+  // order
+  inline std::span<const std::uint32_t>
+  matching_patterns(std::string_view input) noexcept
+  {
+    const std::uint32_t state = final_state(input);
+
+    return std::span<const std::uint32_t>(ACCEPT_IDS).subspan(
+        ACCEPT_OFFSETS[state], ACCEPT_OFFSETS[state + 1] - ACCEPT_OFFSETS[state]);
+  }
+})" << " // namespace "
+           << options.namespace_name << "\n";
+
+    if (!output)
+      throw std::runtime_error("CodeGenerator: write failed");
+  }
+
+  /**
+   * @brief Writes a DFA as a C++ header file
+   *
+   * @param[in] dfa The automaton to write
+   * @param[in] patterns The source patterns, recorded in the header
+   * @param[in] path The path of the header, replaced if it exists
+   * @param[in] options The namespace and the size limit of the
+   *            direct-coded scan
+   * @throw std::invalid_argument If the namespace name is not valid C++
+   * @throw std::runtime_error If the file cannot be written
+   */
+  void CodeGenerator::save(const DFA &dfa,
+                           const std::vector<std::string> &patterns,
+                           const std::string &path,
+                           const CodeGenOptions &options)
+  {
+    std::ofstream output(path, std::ios::trunc);
+
+    if (!output)
+      throw std::runtime_error("CodeGenerator: cannot open " + path);
+
+    write(dfa, patterns, output, options);
+  }
+} // namespace dfa
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @struct CodeGenOptions
+   * @brief Options controlling the C++ header written by CodeGenerator
+   *
+   * @details DFAs with at most max_direct_states states get a
+   *          direct-coded scan function; larger ones scan the tables.
+   */
+  struct CodeGenOptions
+  {
+    std::string namespace_name = "regex_dfa_generated";
+    std::size_t max_direct_states = 512;
+  };
+
+  /**
+   * @class CodeGenerator
+   * @brief Writes a DFA as a self-contained C++ header
+   *
+   * @details The header holds the DFA as constexpr tables in a namespace of
+   *          its own, along with scan functions that need nothing from this
+   *          project. The scan is direct-coded, re2c-style: every state is a
+   *          label, and the byte picks the next label through a tree of
+   *          compares, or a switch over byte classes when a state
+   *          distinguishes many byte ranges. The compiler can then
+   *          optimize each state on its own.
+   */
+  class CodeGenerator
+  {
+  public:
+    // States with more byte ranges than this switch on the byte class
+    static constexpr std::size_t MAX_COMPARE_RANGES = 8;
+
+    static void write(const DFA &dfa, const std::vector<std::string> &patterns,
+                      std::ostream &output, const CodeGenOptions &options = {});
+    static void save(const DFA &dfa, const std::vector<std::string> &patterns,
+                     const std::string &path,
+                     const CodeGenOptions &options = {});
+
+  private:
+    CodeGenerator() = default;
+  };
+} // namespace dfa
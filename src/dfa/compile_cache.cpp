@@ -0,0 +1,161 @@
+#include "compile_cache.h"
+
+namespace dfa
+{
+  /**
+   * @brief Construct a new CompileCache:: CompileCache object
+   *
+   * @param[in] options The capacity of the cache
+   */
+  CompileCache::CompileCache(CompileCacheOptions options) : m_options(options)
+  {
+  }
+
+  /**
+   * @brief Gets the automaton of a pattern, compiling it on a miss
+   * @details The compile runs without holding the cache lock. Other
+   *          threads asking for the same key meanwhile wait for it instead
+   *          of compiling again.
+   *
+   * @param[in] pattern The regex pattern
+   * @param[in] options The compile options; the pool only affects speed
+   * @return std::shared_ptr<const DFA> The automaton
+   * @throw std::invalid_argument If the pattern is invalid; failures are not
+   *        cached
+   */
+  std::shared_ptr<const DFA> CompileCache::get(const std::string &pattern,
+                                               const CompileOptions &options)
+  {
+    std::string key = make_key(pattern, options);
+    std::promise<Result> promise;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      if (auto it = m_entries.find(key); it != m_entries.end())
+      {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        ++m_stats.hits;
+        return it->second->dfa;
+      }
+
+      if (auto it = m_compiling.find(key); it != m_compiling.end())
+      {
+        std::shared_future<Result> pending = it->second;
+        ++m_stats.hits;
+        lock.unlock();
+
+        return pending.get();
+      }
+
+      ++m_stats.misses;
+      m_compiling.emplace(key, promise.get_future().share());
+    }
+
+    Result dfa;
+
+    try
+    {
+      dfa = std::make_shared<const DFA>(Compiler(options).compile(pattern));
+    }
+    catch (...)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+
+      m_compiling.erase(key);
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_compiling.erase(key);
+    promise.set_value(dfa);
+    insert(std::move(key), dfa);
+
+    return dfa;
+  }
+
+  /**
+   * @brief Drops every cached automaton; compiles in progress are kept
+   *
+   */
+  void CompileCache::clear()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_entries.clear();
+    m_lru.clear();
+    m_stats.entries = 0;
+    m_stats.memory = 0;
+  }
+
+  /**
+   * @brief Gets a snapshot of the cache counters
+   *
+   * @return CompileCacheStats The counters
+   */
+  CompileCacheStats CompileCache::get_stats() const
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+  /**
+   * @brief Builds the cache key of a pattern
+   * @details The options that change the automaton, and the limits that
+   *          decide whether it may be built at all, are part of the key, so
+   *          compiles with and without a pool share entries while an
+   *          automaton built under generous limits is never returned to a
+   *          caller whose limits would reject it
+   *
+   * @param[in] pattern The regex pattern
+   * @param[in] options The compile options
+   * @return std::string The key
+   */
+  std::string CompileCache::make_key(const std::string &pattern,
+                                     const CompileOptions &options)
+  {
+    std::string key;
+
+    key += options.minimize ? 'm' : '-';
+    key += options.unanchored ? 'u' : '-';
+    key += std::to_string(options.max_estimated_states) + ':';
+    key += std::to_string(options.max_estimated_work) + ':';
+    key += std::to_string(options.budget.max_states) + ':';
+    key += std::to_string(options.budget.max_memory) + ':';
+    key += std::to_string(options.budget.max_work) + ':';
+    key += pattern;
+
+    return key;
+  }
+
+  /**
+   * @brief Caches an automaton, evicting the least recently used ones to
+   *        make room; the caller holds the lock
+   *
+   * @param[in] key The key of the automaton
+   * @param[in] dfa The automaton
+   */
+  void CompileCache::insert(std::string key, Result dfa)
+  {
+    const std::size_t memory = dfa->memory_usage() + 2 * key.capacity();
+
+    // An automaton larger than the whole cache is returned but not kept
+    if (memory > m_options.capacity)
+      return;
+
+    while (!m_lru.empty() && m_stats.memory + memory > m_options.capacity)
+    {
+      m_stats.memory -= m_lru.back().memory;
+      m_entries.erase(m_lru.back().key);
+      m_lru.pop_back();
+      ++m_stats.evictions;
+    }
+
+    m_lru.push_front(Entry{key, std::move(dfa), memory});
+    m_entries.emplace(std::move(key), m_lru.begin());
+    m_stats.memory += memory;
+    m_stats.entries = m_lru.size();
+  }
+} // namespace dfa
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "compiler.h"
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @struct CompileCacheOptions
+   * @brief Options of a CompileCache
+   *
+   */
+  struct CompileCacheOptions
+  {
+    // Approximate memory limit of the cached automata, in bytes
+    std::size_t capacity = std::size_t{64} << 20;
+  };
+
+  /**
+   * @struct CompileCacheStats
+   * @brief Counters describing how well the cache performs
+   *
+   * @details
+   *       - hits: Lookups answered from the cache, including those that
+   *         waited for a compile another thread had started.
+   *       - misses: Lookups that compiled the pattern.
+   *       - evictions: Automata dropped to stay within the capacity.
+   *       - entries: Automata currently cached.
+   *       - memory: Approximate bytes held by the cached automata.
+   */
+  struct CompileCacheStats
+  {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t entries = 0;
+    std::size_t memory = 0;
+
+    /**
+     * @brief Gets the share of lookups answered without compiling
+     *
+     * @return double The hit ratio, 0 before the first lookup
+     */
+    [[nodiscard]] double hit_ratio() const noexcept
+    {
+      const std::size_t lookups = hits + misses;
+      return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+    }
+  };
+
+  /**
+   * @class CompileCache
+   * @brief Thread-safe LRU cache of compiled automata
+   *
+   * @details Automata are keyed by the pattern together with the options
+   *          that change the result, so a lookup costs one hash of the
+   *          pattern. When the cached automata would exceed the capacity,
+   *          the least recently used ones are evicted. Concurrent lookups
+   *          of a pattern that is not cached share a single compile. The
+   *          returned automata are immutable and stay valid after
+   *          eviction.
+   */
+  class CompileCache
+  {
+  public:
+    explicit CompileCache(CompileCacheOptions options = {});
+
+    CompileCache(const CompileCache &) = delete;
+    CompileCache &operator=(const CompileCache &) = delete;
+
+    std::shared_ptr<const DFA> get(const std::string &pattern,
+                                   const CompileOptions &options = {});
+    void clear();
+
+    // Getters
+    [[nodiscard]] CompileCacheStats get_stats() const;
+
+  private:
+    using Result = std::shared_ptr<const DFA>;
+
+    /**
+     * @struct Entry
+     * @brief A cached automaton
+     *
+     */
+    struct Entry
+    {
+      std::string key;
+      Result dfa;
+      std::size_t memory;
+    };
+
+    CompileCacheOptions m_options;
+    CompileCacheStats m_stats;
+    mutable std::mutex m_mutex;
+
+    // Most recently used first
+    std::list<Entry> m_lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_entries;
+    std::unordered_map<std::string, std::shared_future<Result>> m_compiling;
+
+    // Helper functions
+    static std::string make_key(const std::string &pattern,
+                                const CompileOptions &options);
+    void insert(std::string key, Result dfa);
+  };
+} // namespace dfa
@@ -0,0 +1,479 @@
+#include <limits>
+#include <stdexcept>
+#include "../lexer/lexer.h"
+#include "../parser/parser.h"
+#include "compiler.h"
+#include "dfa_builder.h"
+#include "followpos_visitor.h"
+#include "minimizer.h"
+#include "state_estimator.h"
+#include "thompson_visitor.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Largest estimated work, in positions, that compile_matcher()
+     *        computes the followpos sets for whatever the limits
+     *
+     */
+    constexpr double MAX_MATCHER_WORK = static_cast<double>(1ULL << 30);
+
+    /**
+     * @brief Measures the time since a point of the steady clock
+     *
+     * @param[in] start The starting point
+     * @return std::chrono::microseconds The elapsed time
+     */
+    std::chrono::microseconds elapsed_since(
+        std::chrono::steady_clock::time_point start)
+    {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+    }
+  } // namespace
+
+  /**
+   * @brief Construct a new Compiler:: Compiler object
+   *
+   * @param[in] options The pipeline options
+   */
+  Compiler::Compiler(CompileOptions options)
+      : m_options(options), m_logger(logger::Logger::get_logger())
+  {
+  }
+
+  /**
+   * @brief Compiles a regex pattern
+   *
+   * @param[in] pattern The pattern to compile
+   * @return DFA The compiled automaton
+   * @throw std::invalid_argument If the pattern is invalid or unsupported
+   * @throw std::length_error If the DFA is estimated to be too large
+   */
+  DFA Compiler::compile(const std::string &pattern)
+  {
+    return compile(parse(pattern));
+  }
+
+  /**
+   * @brief Compiles an already parsed AST
+   *
+   * @param[in] tree The AST, with its root set
+   * @return DFA The compiled automaton
+   * @throw std::invalid_argument If the AST has unsupported nodes
+   * @throw std::length_error If the DFA is estimated to be too large
+   */
+  DFA Compiler::compile(const ast::Arena &tree)
+  {
+    m_stats = CompileStats{};
+    check_estimate(tree, m_options.unanchored);
+
+    FollowposVisitor visitor;
+
+    return build(visitor.analyze(tree), m_options.unanchored);
+  }
+
+  /**
+   * @brief Compiles a regex pattern into a lazily determinized DFA
+   *
+   * @param[in] pattern The pattern to compile
+   * @param[in] options The cache options of the automaton
+   * @return LazyDFA The automaton
+   * @throw std::invalid_argument If the pattern is invalid or unsupported
+   */
+  LazyDFA Compiler::compile_lazy(const std::string &pattern,
+                                 LazyDFAOptions options)
+  {
+    return compile_lazy(parse(pattern), options);
+  }
+
+  /**
+   * @brief Compiles an already parsed AST into a lazily determinized DFA
+   *
+   * @param[in] tree The AST, with its root set
+   * @param[in] options The cache options of the automaton
+   * @return LazyDFA The automaton
+   * @throw std::invalid_argument If the AST has unsupported nodes
+   */
+  LazyDFA Compiler::compile_lazy(const ast::Arena &tree,
+                                 LazyDFAOptions options)
+  {
+    m_stats = CompileStats{};
+
+    FollowposVisitor visitor;
+    LazyDFA lazy(visitor.analyze(tree), options);
+
+    m_stats.positions = lazy.get_position_count();
+    m_stats.dfa_states = lazy.get_stats().states;
+
+    return lazy;
+  }
+
+  /**
+   * @brief Compiles a regex pattern into a searcher
+   *
+   * @param[in] pattern The pattern to compile
+   * @return Searcher The searcher
+   * @throw std::invalid_argument If the pattern is invalid or unsupported
+   * @throw std::length_error If the DFA is estimated to be too large
+   */
+  Searcher Compiler::compile_searcher(const std::string &pattern)
+  {
+    return compile_searcher(parse(pattern));
+  }
+
+  /**
+   * @brief Compiles an already parsed AST into a searcher
+   * @details Matches starting after the first byte cannot pass '^', so a
+   *          pattern with '^' also gets a DFA in which '^' is unreachable.
+   *          The unanchored version of that DFA finds where the first match
+   *          ends; it is left out when its estimate or budget is exceeded.
+   *
+   * @param[in] tree The AST, with its root set
+   * @return Searcher The searcher
+   * @throw std::invalid_argument If the AST has unsupported nodes
+   * @throw std::length_error If the DFA is estimated to be too large
+   */
+  Searcher Compiler::compile_searcher(const ast::Arena &tree)
+  {
+    m_stats = CompileStats{};
+    check_estimate(tree, false);
+
+    FollowposVisitor visitor;
+    const PositionAutomaton automaton = visitor.analyze(tree);
+    Prefilter prefilter = Prefilter::build(tree, automaton);
+
+    // '^' is made impassable by removing every edge that reaches it, so
+    // that not even a '$' at the start can lead to it
+    PositionAutomaton inner = automaton;
+    bool anchored = false;
+
+    for (std::uint32_t position = 0; position < inner.size(); ++position)
+    {
+      if (inner.kinds[position] == PositionKind::START_ANCHOR)
+      {
+        inner.first.erase(position);
+
+        for (auto &follow : inner.follow)
+          follow.erase(position);
+
+        anchored = true;
+      }
+    }
+
+    std::optional<DFA> inner_dfa;
+    std::optional<DFA> forward_dfa;
+
+    if (anchored)
+      inner_dfa = build(inner, false);
+
+    // Without the forward DFA the searcher still works, trying every
+    // candidate in turn
+    const CompileStats stats = m_stats;
+
+    try
+    {
+      check_estimate(tree, true);
+      forward_dfa = build(inner, true);
+    }
+    catch (const std::length_error &e)
+    {
+      REGEX_DFA_LOG_WARN(m_logger,
+                         "Compiler: {}; searching without a forward DFA",
+                         e.what());
+    }
+
+    m_stats = stats;
+
+    return Searcher(build(automaton, false), std::move(inner_dfa),
+                    std::move(forward_dfa), std::move(prefilter));
+  }
+
+  /**
+   * @brief Compiles a set of patterns into one DFA
+   * @details The ASTs are united under an alternation root, and pattern i
+   *          of the list gets id i
+   *
+   * @param[in] patterns The patterns to compile
+   * @return DFA The automaton, with the matching pattern ids of every state
+   * @throw std::invalid_argument If the set is empty, or a pattern is
+   *        invalid or unsupported
+   * @throw std::length_error If the DFA is estimated to be too large
+   */
+  DFA Compiler::compile_set(const std::vector<std::string> &patterns)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    ast::Arena tree;
+    const ast::NodeIndex root = tree.add_node(ast::NodeType::ALTERNATION);
+
+    for (std::size_t id = 0; id < patterns.size(); ++id)
+    {
+      try
+      {
+        tree.add_child(root, tree.append(parse(patterns[id])));
+      }
+      catch (const std::invalid_argument &e)
+      {
+        throw std::invalid_argument("Compiler: pattern " +
+                                    std::to_string(id) + ": " + e.what());
+      }
+    }
+
+    tree.set_root(root);
+
+    DFA dfa = compile_set(tree);
+
+    m_stats.compile_time = elapsed_since(start);
+
+    REGEX_DFA_LOG_INFO(m_logger,
+                       "Compiler: {} patterns compiled to {} states in {} us",
+                       m_stats.patterns, m_stats.dfa_states,
+                       m_stats.compile_time.count());
+
+    return dfa;
+  }
+
+  /**
+   * @brief Compiles an AST whose root children are the patterns of a set
+   *
+   * @param[in] tree The AST, with its root set
+   * @return DFA The automaton, with the matching pattern ids of every state
+   * @throw std::invalid_argument If the set is empty or has unsupported
+   *        nodes
+   * @throw std::length_error If the DFA is estimated to be too large
+   */
+  DFA Compiler::compile_set(const ast::Arena &tree)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    m_stats = CompileStats{};
+    check_estimate(tree, m_options.unanchored);
+
+    FollowposVisitor visitor;
+    const PositionAutomaton automaton = visitor.analyze_set(tree);
+    DFA dfa = build(automaton, m_options.unanchored);
+
+    m_stats.compile_time = elapsed_since(start);
+
+    return dfa;
+  }
+
+  /**
+   * @brief Compiles a regex pattern into the cheapest engine that runs it
+   *
+   * @param[in] pattern The pattern to compile
+   * @return Matcher The matcher
+   * @throw std::invalid_argument If the pattern is invalid, unsupported or
+   *        expands to more positions than any engine runs
+   */
+  Matcher Compiler::compile_matcher(const std::string &pattern)
+  {
+    return compile_matcher(parse(pattern));
+  }
+
+  /**
+   * @brief Compiles an already parsed AST into the cheapest engine that
+   *        runs it
+   * @details Automata of at most 64 positions run bit-parallel. Otherwise
+   *          the DFA is abandoned for a PikeVM when the estimate exceeds
+   *          max_estimated_states or max_estimated_work, or the
+   *          construction exceeds the budget. The followpos sets take about
+   *          one bit per position the estimate counts as work, so they are
+   *          only computed when that stays under MAX_MATCHER_WORK and fits
+   *          max_memory. The PikeVM runs a Thompson NFA built straight
+   *          from the AST, whose size grows linearly with the pattern; a
+   *          pattern expanding to more states than it allows, or to more
+   *          than max_memory bytes, has no engine and is rejected.
+   *
+   * @param[in] tree The AST, with its root set
+   * @return Matcher The matcher
+   * @throw std::invalid_argument If the AST has unsupported nodes or no
+   *        engine fits its size
+   */
+  Matcher Compiler::compile_matcher(const ast::Arena &tree)
+  {
+    m_stats = CompileStats{};
+
+    try
+    {
+      const StateEstimate estimate = this->estimate(tree, false);
+      m_stats.patterns = 1;
+
+      if (estimate.positions <= BitParallelNFA::MAX_POSITIONS)
+      {
+        FollowposVisitor visitor;
+        const PositionAutomaton automaton = visitor.analyze(tree);
+
+        m_stats.positions = automaton.size();
+
+        if (automaton.size() <= BitParallelNFA::MAX_POSITIONS)
+          return Matcher(BitParallelNFA(automaton));
+      }
+
+      const std::size_t max_memory = m_options.budget.max_memory;
+
+      try
+      {
+        check_limits();
+
+        if (estimate.work > MAX_MATCHER_WORK ||
+            (max_memory != 0 &&
+             estimate.work / 8 > static_cast<double>(max_memory)))
+          throw std::length_error(
+              "followpos sets need an estimated " +
+              std::to_string(m_stats.estimated_work / 8) + " bytes");
+
+        FollowposVisitor visitor;
+
+        return Matcher(build(visitor.analyze(tree), false));
+      }
+      catch (const std::length_error &e)
+      {
+        REGEX_DFA_LOG_WARN(m_logger,
+                           "Compiler: {}; falling back to the Pike VM",
+                           e.what());
+      }
+
+      m_stats.dfa_states = 0;
+
+      ThompsonVisitor visitor(max_memory);
+
+      return Matcher(PikeVM(visitor.build(tree)));
+    }
+    catch (const std::length_error &e)
+    {
+      throw std::invalid_argument(std::string("Compiler: pattern rejected: ") +
+                                  e.what());
+    }
+  }
+
+  /**
+   * @brief Gets the statistics of the last compilation
+   *
+   * @return const CompileStats& The statistics
+   */
+  const CompileStats &Compiler::get_stats() const noexcept
+  {
+    return m_stats;
+  }
+
+  /**
+   * @brief Runs the lexer and parser over a pattern
+   *
+   * @param[in] pattern The pattern to parse
+   * @return ast::Arena The AST
+   * @throw std::invalid_argument If the pattern is invalid
+   */
+  ast::Arena Compiler::parse(const std::string &pattern)
+  {
+    lexer::Lexer lexer(pattern);
+    parser::Parser parser(lexer.scan());
+
+    return parser.parse();
+  }
+
+  /**
+   * @brief Records the estimated DFA size of an AST and rejects it if it
+   *        exceeds the limits
+   *
+   * @param[in] tree The AST, with its root set
+   * @param[in] unanchored Whether a match may start at any byte
+   * @throw std::length_error If the estimate exceeds max_estimated_states
+   *        or max_estimated_work
+   */
+  void Compiler::check_estimate(const ast::Arena &tree, bool unanchored)
+  {
+    estimate(tree, unanchored);
+    check_limits();
+  }
+
+  /**
+   * @brief Estimates the positions and DFA size of an AST and records
+   *        them in the stats
+   *
+   * @param[in] tree The AST, with its root set
+   * @param[in] unanchored Whether a match may start at any byte
+   * @return StateEstimate The estimate
+   */
+  StateEstimate Compiler::estimate(const ast::Arena &tree, bool unanchored)
+  {
+    StateEstimator estimator;
+    const StateEstimate estimate = estimator.estimate(tree, unanchored);
+    constexpr std::size_t MAX_SIZE = std::numeric_limits<std::size_t>::max();
+
+    auto clamp = [](double value)
+    {
+      return value >= static_cast<double>(MAX_SIZE)
+                 ? MAX_SIZE
+                 : static_cast<std::size_t>(value);
+    };
+
+    m_stats.positions = clamp(estimate.positions);
+    m_stats.estimated_states = clamp(estimate.states);
+    m_stats.estimated_work = clamp(estimate.work);
+
+    return estimate;
+  }
+
+  /**
+   * @brief Rejects the last recorded estimate if it exceeds the limits
+   *
+   * @throw std::length_error If the estimate exceeds max_estimated_states
+   *        or max_estimated_work
+   */
+  void Compiler::check_limits() const
+  {
+    if (m_options.max_estimated_states != 0 &&
+        m_stats.estimated_states > m_options.max_estimated_states)
+      throw std::length_error(
+          "Compiler: pattern needs an estimated " +
+          std::to_string(m_stats.estimated_states) +
+          " DFA states, more than the limit of " +
+          std::to_string(m_options.max_estimated_states) +
+          "; compile it lazily instead");
+
+    if (m_options.max_estimated_work != 0 &&
+        m_stats.estimated_work > m_options.max_estimated_work)
+      throw std::length_error(
+          "Compiler: pattern needs an estimated " +
+          std::to_string(m_stats.estimated_work) +
+          " positions visited to determinize, more than the limit of " +
+          std::to_string(m_options.max_estimated_work) +
+          "; compile it lazily instead");
+  }
+
+  /**
+   * @brief Determinizes and, if enabled, minimizes a position automaton
+   *
+   * @param[in] automaton The result of the followpos analysis
+   * @param[in] unanchored Whether a match may start at any byte
+   * @return DFA The automaton
+   * @throw std::length_error If the DFA exceeds the budget
+   */
+  DFA Compiler::build(const PositionAutomaton &automaton, bool unanchored)
+  {
+    const DFABuilder builder(automaton, m_options.pool, m_options.budget);
+    DFA dfa = unanchored ? builder.build_unanchored() : builder.build();
+
+    m_stats.positions = automaton.size();
+    m_stats.patterns = automaton.end_markers.size();
+    m_stats.dfa_states = dfa.get_state_count();
+
+    if (!m_options.minimize)
+      return dfa;
+
+    Minimizer minimizer(dfa);
+    DFA minimal = minimizer.minimize();
+
+    m_stats.dfa_states = minimal.get_state_count();
+    m_stats.states_removed = minimizer.get_states_removed();
+
+    REGEX_DFA_LOG_DEBUG(m_logger,
+                        "Compiler: minimization removed {} of {} states",
+                        m_stats.states_removed,
+                        m_stats.dfa_states + m_stats.states_removed);
+
+    return minimal;
+  }
+} // namespace dfa
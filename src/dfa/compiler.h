@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../ast/arena.h"
+#include "../threads/thread_pool.h"
+#include "../utils/logger.h"
+#include "dfa.h"
+#include "dfa_builder.h"
+#include "lazy_dfa.h"
+#include "matcher.h"
+#include "searcher.h"
+#include "state_estimator.h"
+
+namespace dfa
+{
+  /**
+   * @struct CompileOptions
+   * @brief Options controlling the regex to DFA pipeline
+   * @details With unanchored set, compile() and compile_set() build a DFA
+   *          in which a match may start at any byte, as StreamMatcher
+   *          expects. With a pool, the subset construction runs on its
+   *          workers; the DFA is the same as without one. Patterns
+   *          estimated to need more than max_estimated_states states, or
+   *          to visit more than max_estimated_work positions while
+   *          building them, are rejected before determinization; 0
+   *          disables a check.
+   *          The budget bounds the states and memory of the subset
+   *          construction itself.
+   */
+  struct CompileOptions
+  {
+    bool minimize = true;
+    bool unanchored = false;
+    thread_management::ThreadPool *pool = nullptr;
+    std::size_t max_estimated_states = std::size_t{1} << 20;
+    std::size_t max_estimated_work = std::size_t{1} << 24;
+    BuildBudget budget{};
+  };
+
+  /**
+   * @struct CompileStats
+   * @brief Sizes recorded while compiling a pattern
+   *
+   */
+  struct CompileStats
+  {
+    std::size_t positions = 0;
+    std::size_t estimated_states = 0;
+    std::size_t estimated_work = 0;
+    std::size_t dfa_states = 0;
+    std::size_t states_removed = 0;
+    std::size_t patterns = 0;
+    std::chrono::microseconds compile_time{0};
+  };
+
+  /**
+   * @class Compiler
+   * @brief Runs the lexer, parser, followpos analysis, subset construction
+   *        and minimization to turn a pattern into a DFA
+   *
+   * @details compile_lazy() stops after the followpos analysis and returns
+   *          a LazyDFA that determinizes states while it scans.
+   *          compile_searcher() also derives a Prefilter from the AST and
+   *          returns a Searcher for unanchored search. compile_set() builds
+   *          one DFA for many patterns whose states record the ids of the
+   *          patterns that match. Every eager compilation checks the
+   *          StateEstimator first; compile_lazy() is the fallback for the
+   *          patterns it rejects. compile_matcher() skips determinization
+   *          for patterns small enough for a BitParallelNFA, and falls back
+   *          on its own to a PikeVM when the estimate or the budget is
+   *          exceeded.
+   */
+  class Compiler
+  {
+  public:
+    explicit Compiler(CompileOptions options = {});
+
+    DFA compile(const std::string &pattern);
+    DFA compile(const ast::Arena &tree);
+    LazyDFA compile_lazy(const std::string &pattern,
+                         LazyDFAOptions options = {});
+    LazyDFA compile_lazy(const ast::Arena &tree, LazyDFAOptions options = {});
+    Searcher compile_searcher(const std::string &pattern);
+    Searcher compile_searcher(const ast::Arena &tree);
+    DFA compile_set(const std::vector<std::string> &patterns);
+    DFA compile_set(const ast::Arena &tree);
+    Matcher compile_matcher(const std::string &pattern);
+    Matcher compile_matcher(const ast::Arena &tree);
+
+    // Getters
+    [[nodiscard]] const CompileStats &get_stats() const noexcept;
+
+  private:
+    CompileOptions m_options;
+    CompileStats m_stats;
+    std::shared_ptr<spdlog::logger> m_logger;
+
+    // Helper functions
+    static ast::Arena parse(const std::string &pattern);
+    void check_estimate(const ast::Arena &tree, bool unanchored);
+    StateEstimate estimate(const ast::Arena &tree, bool unanchored);
+    void check_limits() const;
+    DFA build(const PositionAutomaton &automaton, bool unanchored);
+  };
+} // namespace dfa
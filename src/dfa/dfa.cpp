@@ -0,0 +1,293 @@
+#include <sstream>
+#include <stdexcept>
+#include "dfa.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Formats a byte for display, escaping unprintable ones
+     *
+     * @param[in] byte The byte to format
+     * @return std::string The printable form of the byte
+     */
+    std::string format_byte(unsigned int byte)
+    {
+      if (byte >= 0x21 && byte <= 0x7e)
+        return std::string(1, static_cast<char>(byte));
+
+      std::ostringstream ss;
+      ss << "\\x" << std::hex << (byte >> 4) << (byte & 0xf);
+
+      return ss.str();
+    }
+  } // namespace
+
+  /**
+   * @brief Construct a new DFA:: DFA object
+   *
+   * @param[in] start_state The initial state
+   * @param[in] byte_classes The class of every byte
+   * @param[in] class_count The number of byte classes
+   * @param[in] transitions Row-major table of class_count entries per state
+   * @param[in] accept_flags AcceptFlag bits of every state
+   * @param[in] accept_ids Pattern ids matching at the end of input in every
+   *            state, or empty if the DFA does not track patterns
+   * @throw std::invalid_argument If the tables are inconsistent
+   */
+  DFA::DFA(StateId start_state, const ByteClassMap &byte_classes,
+           std::size_t class_count, std::vector<StateId> transitions,
+           std::vector<std::uint8_t> accept_flags,
+           const std::vector<std::vector<std::uint32_t>> &accept_ids)
+      : m_start_state(start_state), m_byte_classes(byte_classes),
+        m_class_count(class_count), m_transitions(std::move(transitions)),
+        m_accept_flags(std::move(accept_flags))
+  {
+    if (m_class_count == 0 || m_class_count > ALPHABET_SIZE)
+      throw std::invalid_argument("Invalid DFA byte class count");
+
+    for (const auto byte_class : m_byte_classes)
+      if (byte_class >= m_class_count)
+        throw std::invalid_argument("Invalid DFA byte class");
+
+    if (m_accept_flags.empty() ||
+        m_transitions.size() != m_accept_flags.size() * m_class_count)
+      throw std::invalid_argument("Invalid DFA transition table size");
+
+    if (m_start_state >= m_accept_flags.size())
+      throw std::invalid_argument("Invalid DFA start state");
+
+    for (const StateId target : m_transitions)
+      if (target >= m_accept_flags.size())
+        throw std::invalid_argument("Invalid DFA transition target");
+
+    if (accept_ids.empty())
+      return;
+
+    if (accept_ids.size() != m_accept_flags.size())
+      throw std::invalid_argument("Invalid DFA accept id table size");
+
+    m_accept_offsets.reserve(accept_ids.size() + 1);
+    m_accept_offsets.push_back(0);
+
+    for (const auto &ids : accept_ids)
+    {
+      m_accept_ids.insert(m_accept_ids.end(), ids.begin(), ids.end());
+      m_accept_offsets.push_back(
+          static_cast<std::uint32_t>(m_accept_ids.size()));
+    }
+  }
+
+  /**
+   * @brief Checks whether the whole input is matched by the automaton
+   *
+   * @param[in] input The input to match
+   * @return true If the input is in the language of the automaton
+   */
+  bool DFA::matches(std::string_view input) const noexcept
+  {
+    StateId state = m_start_state;
+
+    for (const char character : input)
+    {
+      state = next(state, static_cast<std::uint8_t>(character));
+
+      if (state == DEAD_STATE)
+        return false;
+    }
+
+    return is_accepting_at_eof(state);
+  }
+
+  /**
+   * @brief Finds every pattern of a pattern set that matches the whole
+   *        input, in a single scan
+   *
+   * @param[in] input The input to match
+   * @return std::span<const std::uint32_t> The ids of the matching patterns,
+   *         in increasing order
+   */
+  std::span<const std::uint32_t>
+  DFA::matching_patterns(std::string_view input) const noexcept
+  {
+    StateId state = m_start_state;
+
+    for (const char character : input)
+    {
+      state = next(state, static_cast<std::uint8_t>(character));
+
+      if (state == DEAD_STATE)
+        return {};
+    }
+
+    return get_accept_ids(state);
+  }
+
+  /**
+   * @brief Converts the automaton to a readable listing of its states
+   * @details Consecutive bytes with the same target are printed as a range
+   *          and transitions into the dead state are omitted
+   *
+   * @return std::string The string representation of the DFA
+   */
+  std::string DFA::to_string() const
+  {
+    std::ostringstream ss;
+
+    for (StateId state = 0; state < get_state_count(); ++state)
+    {
+      ss << "State " << state;
+
+      if (state == m_start_state)
+        ss << " (start)";
+
+      if (is_accepting(state))
+        ss << " (accept)";
+
+      else if (is_accepting_at_eof(state))
+        ss << " (accept at end)";
+
+      const auto ids = get_accept_ids(state);
+
+      if (!ids.empty() && (ids.size() > 1 || ids.front() != 0))
+      {
+        ss << " (patterns";
+
+        for (const auto id : ids)
+          ss << " " << id;
+
+        ss << ")";
+      }
+
+      ss << "\n";
+
+      unsigned int byte = 0;
+
+      while (byte < ALPHABET_SIZE)
+      {
+        const StateId target = next(state, static_cast<std::uint8_t>(byte));
+        unsigned int last = byte;
+
+        while (last + 1 < ALPHABET_SIZE &&
+               next(state, static_cast<std::uint8_t>(last + 1)) == target)
+          ++last;
+
+        if (target != DEAD_STATE)
+        {
+          ss << "  " << format_byte(byte);
+
+          if (last != byte)
+            ss << "-" << format_byte(last);
+
+          ss << " -> " << target << "\n";
+        }
+
+        byte = last + 1;
+      }
+    }
+
+    return ss.str();
+  }
+
+  /**
+   * @brief Gets the number of states, including the dead state
+   *
+   * @return std::size_t The number of states
+   */
+  std::size_t DFA::get_state_count() const noexcept
+  {
+    return m_accept_flags.size();
+  }
+
+  /**
+   * @brief Gets the initial state
+   *
+   * @return StateId The start state
+   */
+  StateId DFA::get_start_state() const noexcept
+  {
+    return m_start_state;
+  }
+
+  /**
+   * @brief Gets the class of every byte
+   *
+   * @return const ByteClassMap& The byte class map
+   */
+  const DFA::ByteClassMap &DFA::get_byte_classes() const noexcept
+  {
+    return m_byte_classes;
+  }
+
+  /**
+   * @brief Gets the number of byte classes, the width of a table row
+   *
+   * @return std::size_t The number of byte classes
+   */
+  std::size_t DFA::get_class_count() const noexcept
+  {
+    return m_class_count;
+  }
+
+  /**
+   * @brief Gets the row-major transition table
+   *
+   * @return const std::vector<StateId>& The transition table
+   */
+  const std::vector<StateId> &DFA::get_transitions() const noexcept
+  {
+    return m_transitions;
+  }
+
+  /**
+   * @brief Gets the AcceptFlag bits of every state
+   *
+   * @return const std::vector<std::uint8_t>& The accept flags
+   */
+  const std::vector<std::uint8_t> &DFA::get_accept_flags() const noexcept
+  {
+    return m_accept_flags;
+  }
+
+  /**
+   * @brief Gets the patterns that match when the input ends in a state
+   *
+   * @param[in] state The state
+   * @return std::span<const std::uint32_t> The pattern ids, empty if the
+   *         DFA does not track patterns
+   */
+  std::span<const std::uint32_t>
+  DFA::get_accept_ids(StateId state) const noexcept
+  {
+    if (m_accept_offsets.empty())
+      return {};
+
+    return std::span<const std::uint32_t>(m_accept_ids)
+        .subspan(m_accept_offsets[state],
+                 m_accept_offsets[state + 1] - m_accept_offsets[state]);
+  }
+
+  /**
+   * @brief Checks whether the DFA records the patterns of its states
+   *
+   * @return true If it was built with pattern ids
+   */
+  bool DFA::has_accept_ids() const noexcept
+  {
+    return !m_accept_offsets.empty();
+  }
+
+  /**
+   * @brief Gets the memory held by the DFA
+   *
+   * @return std::size_t The size of the object and its tables, in bytes
+   */
+  std::size_t DFA::memory_usage() const noexcept
+  {
+    return sizeof(DFA) + m_transitions.capacity() * sizeof(StateId) +
+           m_accept_flags.capacity() +
+           (m_accept_offsets.capacity() + m_accept_ids.capacity()) *
+               sizeof(std::uint32_t);
+  }
+} // namespace dfa
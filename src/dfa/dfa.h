@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dfa
+{
+  using StateId = std::uint32_t;
+
+  /**
+   * @brief The AcceptFlag enum describes when a DFA state accepts
+   *
+   * @details
+   *       - ACCEPT: A match ends in this state.
+   *       - ACCEPT_AT_EOF: A match ends here if the input ends here too.
+   *                        Set on every ACCEPT state as well.
+   */
+  enum AcceptFlag : std::uint8_t
+  {
+    NONE = 0,
+    ACCEPT = 1 << 0,
+    ACCEPT_AT_EOF = 1 << 1
+  };
+
+  /**
+   * @class DFA
+   * @brief A deterministic finite automaton stored as a flat transition
+   *        table over byte equivalence classes
+   *
+   * @details Every byte is first mapped to its class through a 256-entry
+   *          class map, and each state row holds one entry per class.
+   *          State 0 is the dead state, which rejects and loops on every
+   *          byte, so a scan never has to check for a missing transition.
+   *          A DFA compiled from a pattern set also records, for every
+   *          state, the ids of the patterns that match if the input ends
+   *          there.
+   */
+  class DFA
+  {
+  public:
+    static constexpr StateId DEAD_STATE = 0;
+    static constexpr std::size_t ALPHABET_SIZE = 256;
+
+    using ByteClassMap = std::array<std::uint8_t, ALPHABET_SIZE>;
+
+    DFA(StateId start_state, const ByteClassMap &byte_classes,
+        std::size_t class_count, std::vector<StateId> transitions,
+        std::vector<std::uint8_t> accept_flags,
+        const std::vector<std::vector<std::uint32_t>> &accept_ids = {});
+
+    [[nodiscard]] bool matches(std::string_view input) const noexcept;
+    [[nodiscard]] std::span<const std::uint32_t>
+    matching_patterns(std::string_view input) const noexcept;
+    std::string to_string() const;
+
+    // Getters
+    [[nodiscard]] std::size_t get_state_count() const noexcept;
+    [[nodiscard]] StateId get_start_state() const noexcept;
+    [[nodiscard]] const ByteClassMap &get_byte_classes() const noexcept;
+    [[nodiscard]] std::size_t get_class_count() const noexcept;
+    [[nodiscard]] const std::vector<StateId> &get_transitions() const noexcept;
+    [[nodiscard]] const std::vector<std::uint8_t> &
+    get_accept_flags() const noexcept;
+    [[nodiscard]] std::span<const std::uint32_t>
+    get_accept_ids(StateId state) const noexcept;
+    [[nodiscard]] bool has_accept_ids() const noexcept;
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+    /**
+     * @brief Gets the state reached from state on byte
+     *
+     * @param[in] state The current state
+     * @param[in] byte The input byte
+     * @return StateId The next state
+     */
+    [[nodiscard]] StateId next(StateId state,
+                               std::uint8_t byte) const noexcept
+    {
+      return m_transitions[state * m_class_count + m_byte_classes[byte]];
+    }
+
+    /**
+     * @brief Gets the state reached from state on any byte of a class
+     *
+     * @param[in] state The current state
+     * @param[in] byte_class The byte class
+     * @return StateId The next state
+     */
+    [[nodiscard]] StateId next_class(StateId state,
+                                     std::size_t byte_class) const noexcept
+    {
+      return m_transitions[state * m_class_count + byte_class];
+    }
+
+    /**
+     * @brief Checks whether a match ends in state
+     *
+     * @param[in] state The state to check
+     * @return true If the state accepts
+     */
+    [[nodiscard]] bool is_accepting(StateId state) const noexcept
+    {
+      return m_accept_flags[state] & ACCEPT;
+    }
+
+    /**
+     * @brief Checks whether a match ends in state when the input ends there
+     *
+     * @param[in] state The state to check
+     * @return true If the state accepts at the end of input
+     */
+    [[nodiscard]] bool is_accepting_at_eof(StateId state) const noexcept
+    {
+      return m_accept_flags[state] & ACCEPT_AT_EOF;
+    }
+
+  private:
+    StateId m_start_state;
+    ByteClassMap m_byte_classes;
+    std::size_t m_class_count;
+    std::vector<StateId> m_transitions;
+    std::vector<std::uint8_t> m_accept_flags;
+    std::vector<std::uint32_t> m_accept_offsets;
+    std::vector<std::uint32_t> m_accept_ids;
+  };
+} // namespace dfa
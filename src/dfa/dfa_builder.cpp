@@ -0,0 +1,598 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include "dfa_builder.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @class StateTable
+     * @brief Sharded hash table interning the position sets of DFA states
+     *
+     * @details Any thread may intern a set. Every shard has its own lock, so
+     *          threads rarely wait for each other. Entries never move once
+     *          inserted. Besides its state id, filled in later, an entry
+     *          keeps the smallest discovery order of the transitions that
+     *          reached it.
+     */
+    class StateTable
+    {
+    public:
+      /**
+       * @struct Entry
+       * @brief The data kept for an interned set
+       *
+       */
+      struct Entry
+      {
+        std::atomic<std::uint64_t> first_seen;
+        StateId id = DFA::DEAD_STATE;
+
+        explicit Entry(std::uint64_t order) : first_seen(order)
+        {
+        }
+      };
+
+      /**
+       * @struct Interned
+       * @brief The result of interning a set
+       *
+       */
+      struct Interned
+      {
+        Entry *entry;
+        const PositionSet *key;
+        bool inserted;
+      };
+
+      /**
+       * @brief Finds or inserts a set
+       *
+       * @param[in] set The set
+       * @param[in] order The discovery order of the transition reaching it
+       * @return Interned The entry, its stored set and whether it is new
+       */
+      Interned intern(PositionSet &&set, std::uint64_t order)
+      {
+        const std::size_t hash = set.hash();
+        Shard &shard = m_shards[(hash >> 16) % SHARDS];
+        std::unique_lock<std::mutex> lock(shard.mutex);
+
+        auto [it, inserted] = shard.entries.try_emplace(
+            HashedSet{std::move(set), hash}, order);
+        lock.unlock();
+
+        std::uint64_t seen = it->second.first_seen.load(
+            std::memory_order_relaxed);
+
+        while (order < seen && !it->second.first_seen.compare_exchange_weak(
+                                   seen, order, std::memory_order_relaxed))
+        {
+        }
+
+        return {&it->second, &it->first.set, inserted};
+      }
+
+    private:
+      static constexpr std::size_t SHARDS = 64;
+
+      /**
+       * @struct HashedSet
+       * @brief A set with its hash, computed once
+       *
+       */
+      struct HashedSet
+      {
+        PositionSet set;
+        std::size_t hash;
+
+        bool operator==(const HashedSet &other) const noexcept
+        {
+          return hash == other.hash && set == other.set;
+        }
+      };
+
+      struct HashedSetHash
+      {
+        std::size_t operator()(const HashedSet &key) const noexcept
+        {
+          return key.hash;
+        }
+      };
+
+      struct Shard
+      {
+        std::mutex mutex;
+        std::unordered_map<HashedSet, Entry, HashedSetHash> entries;
+      };
+
+      std::array<Shard, SHARDS> m_shards;
+    };
+  } // namespace
+
+  /**
+   * @brief Construct a new DFABuilder:: DFABuilder object
+   *
+   * @param[in] automaton The positions and followpos to determinize
+   * @param[in] pool The pool expanding states in parallel, or nullptr to
+   *            build on the calling thread
+   * @param[in] budget The limits the DFA must stay within
+   */
+  DFABuilder::DFABuilder(const PositionAutomaton &automaton,
+                         thread_management::ThreadPool *pool,
+                         BuildBudget budget)
+      : m_automaton(automaton), m_pool(pool), m_budget(budget)
+  {
+  }
+
+  /**
+   * @brief Runs the subset construction
+   *
+   * @return DFA The deterministic automaton
+   * @throw std::length_error If the DFA exceeds the budget
+   */
+  DFA DFABuilder::build() const
+  {
+    return determinize(nullptr);
+  }
+
+  /**
+   * @brief Runs the subset construction for a DFA that matches anywhere
+   * @details Every state also holds the start positions, minus '^', so a
+   *          match may begin at any byte and an accepting state marks the
+   *          end of some match
+   *
+   * @return DFA The deterministic automaton
+   * @throw std::length_error If the DFA exceeds the budget
+   */
+  DFA DFABuilder::build_unanchored() const
+  {
+    PositionSet restart = m_automaton.first;
+    strip_start_anchors(restart);
+
+    return determinize(&restart);
+  }
+
+  /**
+   * @brief Determinizes the automaton
+   * @details States are expanded one breadth-first level at a time. The
+   *          states of a level are expanded in parallel when the builder
+   *          has a pool, and the position sets they reach are interned in
+   *          a StateTable. New states are then numbered in the order a
+   *          sequential construction would first reach them, so the
+   *          result does not depend on the number of threads.
+   *          Transitions are computed once per byte class, using the
+   *          smallest byte of the class as its representative. Every new
+   *          state is charged to the budget when it is interned, and every
+   *          transition for the positions it visits, so an exploding level
+   *          is cut short rather than finished.
+   *
+   * @param[in] restart Positions added to every state reached on a byte, or
+   *            nullptr for an anchored DFA
+   * @return DFA The deterministic automaton
+   * @throw std::length_error If the DFA exceeds the budget
+   */
+  DFA DFABuilder::determinize(const PositionSet *restart) const
+  {
+    const ByteClasses classes = byte_classes(m_automaton.symbols);
+    std::vector<std::uint8_t> representatives(classes.count, 0);
+
+    for (std::size_t byte = DFA::ALPHABET_SIZE; byte-- > 0;)
+      representatives[classes.map[byte]] = static_cast<std::uint8_t>(byte);
+
+    StateTable table;
+    std::vector<const PositionSet *> states;
+
+    auto add_state = [&](StateTable::Entry &entry, const PositionSet &set)
+    {
+      entry.id = static_cast<StateId>(states.size());
+      states.push_back(&set);
+    };
+
+    const auto dead = table.intern(PositionSet{}, 0);
+    add_state(*dead.entry, *dead.key);
+
+    const auto start = table.intern(start_set(), 0);
+
+    if (start.inserted)
+      add_state(*start.entry, *start.key);
+
+    const StateId start_state = start.entry->id;
+    std::vector<StateId> transitions(classes.count, DFA::DEAD_STATE);
+    std::vector<StateTable::Entry *> rows;
+    std::vector<std::vector<StateTable::Interned>> created;
+
+    // Approximate cost of a state beyond its position set: a row of the
+    // table and a hash table node
+    const std::size_t row_cost = classes.count * sizeof(StateId) + 64;
+    std::atomic<std::size_t> state_count = states.size();
+    std::atomic<std::size_t> memory =
+        states.size() * row_cost + start.key->memory_usage();
+    std::atomic<std::size_t> work = 0;
+    std::atomic<bool> exceeded = false;
+
+    // Positions merged into a state when a position is followed
+    std::vector<std::size_t> follow_sizes;
+
+    if (m_budget.max_work != 0)
+    {
+      follow_sizes.reserve(m_automaton.size());
+
+      for (const auto &follow : m_automaton.follow)
+        follow_sizes.push_back(follow.size());
+    }
+
+    auto charge_work = [&](std::size_t positions)
+    {
+      if (m_budget.max_work != 0 &&
+          work.fetch_add(positions, std::memory_order_relaxed) + positions >
+              m_budget.max_work)
+        exceeded.store(true, std::memory_order_relaxed);
+    };
+
+    auto charge = [&](const PositionSet &set)
+    {
+      const std::size_t count =
+          state_count.fetch_add(1, std::memory_order_relaxed) + 1;
+      const std::size_t bytes =
+          memory.fetch_add(row_cost + set.memory_usage(),
+                           std::memory_order_relaxed) +
+          row_cost + set.memory_usage();
+
+      if ((m_budget.max_states != 0 && count > m_budget.max_states) ||
+          (m_budget.max_memory != 0 && bytes > m_budget.max_memory))
+        exceeded.store(true, std::memory_order_relaxed);
+    };
+
+    for (std::size_t begin = 1; begin < states.size();)
+    {
+      const std::size_t end = states.size();
+
+      rows.assign((end - begin) * classes.count, nullptr);
+      created.assign(end - begin, {});
+
+      for_range(begin, end, [&](std::size_t state)
+                {
+        if (exceeded.load(std::memory_order_relaxed))
+          return;
+
+        std::unordered_map<PositionSet, StateTable::Entry *, PositionSetHash>
+            targets;
+        StateTable::Entry **row = &rows[(state - begin) * classes.count];
+        const std::size_t size =
+            m_budget.max_work != 0 ? states[state]->size() : 0;
+
+        for (std::size_t c = 0; c < classes.count; ++c)
+        {
+          if (exceeded.load(std::memory_order_relaxed))
+            return;
+
+          PositionSet subset = matched(*states[state], representatives[c]);
+          auto it = targets.find(subset);
+
+          charge_work(size);
+
+          if (it == targets.end())
+          {
+            if (m_budget.max_work != 0)
+            {
+              std::size_t merged = 0;
+
+              subset.for_each([&](std::uint32_t position)
+                              { merged += follow_sizes[position]; });
+              charge_work(merged);
+            }
+
+            PositionSet next = follow(subset);
+
+            if (restart != nullptr)
+              next.merge(*restart);
+
+            const auto target =
+                table.intern(std::move(next), state * classes.count + c);
+
+            if (target.inserted)
+            {
+              created[state - begin].push_back(target);
+              charge(*target.key);
+            }
+
+            it = targets.emplace(std::move(subset), target.entry).first;
+          }
+
+          row[c] = it->second;
+        } });
+
+      if (exceeded.load(std::memory_order_relaxed))
+        throw std::length_error("DFABuilder: DFA exceeds its budget of " +
+                                std::to_string(m_budget.max_states) +
+                                " states, " +
+                                std::to_string(m_budget.max_memory) +
+                                " bytes and " +
+                                std::to_string(m_budget.max_work) +
+                                " positions visited");
+
+      // Number the new states by the transition that reached them first
+      std::vector<StateTable::Interned> level;
+
+      for (auto &states_of_row : created)
+        level.insert(level.end(), states_of_row.begin(), states_of_row.end());
+
+      std::sort(level.begin(), level.end(),
+                [](const StateTable::Interned &a, const StateTable::Interned &b)
+                { return a.entry->first_seen.load(std::memory_order_relaxed) <
+                         b.entry->first_seen.load(std::memory_order_relaxed); });
+
+      for (const auto &target : level)
+        add_state(*target.entry, *target.key);
+
+      for (const auto *entry : rows)
+        transitions.push_back(entry->id);
+
+      begin = end;
+    }
+
+    std::vector<std::uint8_t> flags(states.size());
+    std::vector<std::vector<std::uint32_t>> patterns(states.size());
+
+    for_range(0, states.size(), [&](std::size_t state)
+              {
+      flags[state] = accept_flags(*states[state]);
+
+      if (flags[state] & ACCEPT_AT_EOF)
+        patterns[state] = accept_ids(*states[state]); });
+
+    return DFA(start_state, classes.map, classes.count,
+               std::move(transitions), std::move(flags), patterns);
+  }
+
+  /**
+   * @brief Calls a function for every index of a range, on the pool if
+   *        there is one
+   *
+   * @param[in] begin The first index
+   * @param[in] end One past the last index
+   * @param[in] body Called as body(index)
+   */
+  void DFABuilder::for_range(
+      std::size_t begin, std::size_t end,
+      const std::function<void(std::size_t)> &body) const
+  {
+    if (m_pool == nullptr || end - begin < 2)
+    {
+      for (std::size_t index = begin; index < end; ++index)
+        body(index);
+
+      return;
+    }
+
+    const std::size_t grain = std::max<std::size_t>(
+        1, (end - begin) / (m_pool->get_thread_count() * 8));
+
+    m_pool->parallel_for(begin, end, grain,
+                         [&](std::size_t first, std::size_t last)
+                         {
+                           for (std::size_t index = first; index < last;
+                                ++index)
+                             body(index);
+                         });
+  }
+
+  /**
+   * @brief Computes the position set of the start state
+   * @details '^' anchors can only be passed before any input is consumed,
+   *          so they are resolved here and never appear in later states.
+   *          On empty input a '$' may also be passed before any input and
+   *          lead to a '^'; such '^' positions stay in the start state,
+   *          where they consume nothing, so that accept_flags() may pass
+   *          them
+   *
+   * @return PositionSet The start state
+   */
+  PositionSet DFABuilder::start_set() const
+  {
+    PositionSet set = close_over(m_automaton.first,
+                                 [&](std::uint32_t position)
+                                 { return m_automaton.kinds[position] ==
+                                          PositionKind::START_ANCHOR; });
+
+    const PositionSet passed = set;
+    strip_start_anchors(set);
+
+    const PositionSet empty_input = close_over(
+        passed, [&](std::uint32_t position)
+        { return m_automaton.kinds[position] == PositionKind::START_ANCHOR ||
+                 m_automaton.kinds[position] == PositionKind::END_ANCHOR; });
+
+    empty_input.for_each([&](std::uint32_t position)
+                         {
+      if (m_automaton.kinds[position] == PositionKind::START_ANCHOR &&
+          !passed.contains(position))
+        set.insert(position); });
+
+    return set;
+  }
+
+  /**
+   * @brief Computes the state reached from a state on a byte
+   *
+   * @param[in] set The positions of the current state
+   * @param[in] byte The input byte
+   * @return PositionSet The positions of the next state
+   */
+  PositionSet DFABuilder::step(const PositionSet &set, std::uint8_t byte) const
+  {
+    return follow(matched(set, byte));
+  }
+
+  /**
+   * @brief Selects the positions of a state that consume a byte
+   *
+   * @param[in] set The positions of the state
+   * @param[in] byte The input byte
+   * @return PositionSet The positions whose symbols contain the byte
+   */
+  PositionSet DFABuilder::matched(const PositionSet &set,
+                                  std::uint8_t byte) const
+  {
+    PositionSet subset;
+
+    set.for_each([&](std::uint32_t position)
+                 {
+      if (m_automaton.symbols[position].test(byte))
+        subset.insert(position); });
+
+    return subset;
+  }
+
+  /**
+   * @brief Computes the union of followpos over a set of positions
+   *
+   * @param[in] matched The positions that consumed the last byte
+   * @return PositionSet The next state, without '^' positions
+   */
+  PositionSet DFABuilder::follow(const PositionSet &matched) const
+  {
+    PositionSet next;
+
+    matched.for_each([&](std::uint32_t position)
+                     { next.merge(m_automaton.follow[position]); });
+
+    strip_start_anchors(next);
+    return next;
+  }
+
+  /**
+   * @brief Adds the followpos of every passable position to the set until
+   *        nothing changes
+   *
+   * @param[in] set The set to close
+   * @param[in] passable Tells whether a zero-width position may be passed
+   * @return PositionSet The closed set
+   */
+  PositionSet DFABuilder::close_over(
+      PositionSet set,
+      const std::function<bool(std::uint32_t)> &passable) const
+  {
+    PositionSet visited;
+    bool changed = true;
+
+    while (changed)
+    {
+      changed = false;
+      PositionSet pending;
+
+      set.for_each([&](std::uint32_t position)
+                   {
+        if (!visited.contains(position) && passable(position))
+        {
+          visited.insert(position);
+          pending.merge(m_automaton.follow[position]);
+          changed = true;
+        } });
+
+      set.merge(pending);
+    }
+
+    return set;
+  }
+
+  /**
+   * @brief Closes a state over the anchors passable at the end of input
+   * @details Every '$' may be passed. A '^' is only in a state when the
+   *          state is the start state and a '$' leads to it, in which case
+   *          it may be passed too
+   *
+   * @param[in] set The positions of the state
+   * @return PositionSet The positions reached at the end of input
+   */
+  PositionSet DFABuilder::close_at_end(const PositionSet &set) const
+  {
+    return close_over(set, [&](std::uint32_t position)
+                      { return m_automaton.kinds[position] ==
+                                   PositionKind::END_ANCHOR ||
+                               (m_automaton.kinds[position] ==
+                                    PositionKind::START_ANCHOR &&
+                                set.contains(position)); });
+  }
+
+  /**
+   * @brief Removes '^' positions, which are dead after the first byte
+   *
+   * @param[in,out] set The set to clean
+   */
+  void DFABuilder::strip_start_anchors(PositionSet &set) const
+  {
+    PositionSet anchors;
+
+    set.for_each([&](std::uint32_t position)
+                 {
+      if (m_automaton.kinds[position] == PositionKind::START_ANCHOR)
+        anchors.insert(position); });
+
+    anchors.for_each([&](std::uint32_t position)
+                     { set.erase(position); });
+  }
+
+  /**
+   * @brief Computes the AcceptFlag bits of a state
+   *
+   * @param[in] set The positions of the state
+   * @return std::uint8_t The accept flags
+   */
+  std::uint8_t DFABuilder::accept_flags(const PositionSet &set) const
+  {
+    if (contains_end_marker(set))
+      return ACCEPT | ACCEPT_AT_EOF;
+
+    if (contains_end_marker(close_at_end(set)))
+      return ACCEPT_AT_EOF;
+
+    return NONE;
+  }
+
+  /**
+   * @brief Computes the patterns that match when the input ends in a state
+   *
+   * @param[in] set The positions of the state
+   * @return std::vector<std::uint32_t> The pattern ids, in increasing order
+   */
+  std::vector<std::uint32_t> DFABuilder::accept_ids(
+      const PositionSet &set) const
+  {
+    std::vector<std::uint32_t> ids;
+
+    close_at_end(set).for_each([&](std::uint32_t position)
+                               {
+      if (m_automaton.kinds[position] == PositionKind::END_MARKER)
+        ids.push_back(m_automaton.pattern_of(position)); });
+
+    return ids;
+  }
+
+  /**
+   * @brief Checks whether a set holds the end marker of any pattern
+   *
+   * @param[in] set The set to check
+   * @return true If an end marker is in the set
+   */
+  bool DFABuilder::contains_end_marker(const PositionSet &set) const
+  {
+    if (m_automaton.end_markers.size() == 1)
+      return set.contains(m_automaton.end_markers.front());
+
+    bool found = false;
+
+    set.for_each([&](std::uint32_t position)
+                 { found |= m_automaton.kinds[position] ==
+                            PositionKind::END_MARKER; });
+
+    return found;
+  }
+} // namespace dfa
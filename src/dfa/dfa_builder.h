@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+
+#include "../threads/thread_pool.h"
+#include "dfa.h"
+#include "position_automaton.h"
+
+namespace dfa
+{
+  /**
+   * @struct BuildBudget
+   * @brief Limits on the size of a DFA under construction
+   *
+   * @details max_memory counts the transition table and the interned
+   *          position sets, in bytes. max_work counts the positions the
+   *          construction visits: every position of a state once per byte
+   *          class, plus every position of the followpos sets merged into
+   *          the states it reaches. A limit of 0 is no limit.
+   */
+  struct BuildBudget
+  {
+    std::size_t max_states = 0;
+    std::size_t max_memory = 0;
+    std::size_t max_work = 0;
+  };
+
+  /**
+   * @class DFABuilder
+   * @brief Builds a DFA from a position automaton by subset construction
+   *
+   * @details Every DFA state is a set of positions. The builder starts from
+   *          firstpos of the root and follows followpos on every byte until
+   *          no new position set appears. Every state records the
+   *          patterns that match when the input ends there. Given a
+   *          ThreadPool, the states of each breadth-first level are
+   *          expanded in parallel; the state numbering stays the same.
+   *          Construction stops with std::length_error as soon as the
+   *          states found or the work done exceed the budget.
+   */
+  class DFABuilder
+  {
+  public:
+    explicit DFABuilder(const PositionAutomaton &automaton,
+                        thread_management::ThreadPool *pool = nullptr,
+                        BuildBudget budget = {});
+
+    DFA build() const;
+    DFA build_unanchored() const;
+
+    // Single steps of the construction, shared with LazyDFA
+    PositionSet start_set() const;
+    PositionSet step(const PositionSet &set, std::uint8_t byte) const;
+    std::uint8_t accept_flags(const PositionSet &set) const;
+    std::vector<std::uint32_t> accept_ids(const PositionSet &set) const;
+
+  private:
+    const PositionAutomaton &m_automaton;
+    thread_management::ThreadPool *m_pool;
+    BuildBudget m_budget;
+
+    // Helper functions
+    DFA determinize(const PositionSet *restart) const;
+    void for_range(std::size_t begin, std::size_t end,
+                   const std::function<void(std::size_t)> &body) const;
+    PositionSet matched(const PositionSet &set, std::uint8_t byte) const;
+    PositionSet follow(const PositionSet &matched) const;
+    PositionSet close_over(
+        PositionSet set,
+        const std::function<bool(std::uint32_t)> &passable) const;
+    PositionSet close_at_end(const PositionSet &set) const;
+    void strip_start_anchors(PositionSet &set) const;
+    bool contains_end_marker(const PositionSet &set) const;
+  };
+} // namespace dfa
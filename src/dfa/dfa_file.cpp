@@ -0,0 +1,456 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dfa_file.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Rounds an offset up to the section alignment
+     *
+     * @param[in] offset The offset to round
+     * @return std::uint64_t The aligned offset
+     */
+    std::uint64_t align(std::uint64_t offset)
+    {
+      return (offset + DFAFile::ALIGNMENT - 1) / DFAFile::ALIGNMENT *
+             DFAFile::ALIGNMENT;
+    }
+
+    /**
+     * @brief Checks that a section is aligned and lies inside the file
+     *
+     * @param[in] offset The offset of the section
+     * @param[in] size The size of the section in bytes
+     * @param[in] file_size The size of the file
+     * @throw std::runtime_error If the section is misplaced
+     */
+    void check_section(std::uint64_t offset, std::uint64_t size,
+                       std::uint64_t file_size)
+    {
+      if (offset % DFAFile::ALIGNMENT != 0 || offset < sizeof(DFAFileHeader) ||
+          offset > file_size || size > file_size - offset)
+        throw std::runtime_error("DFAFile: section out of bounds");
+    }
+  } // namespace
+
+  /**
+   * @brief Checks whether the whole input is matched by the automaton
+   *
+   * @param[in] input The input to match
+   * @return true If the input is in the language of the automaton
+   */
+  bool DFAView::matches(std::string_view input) const noexcept
+  {
+    StateId state = m_start_state;
+
+    for (const char character : input)
+    {
+      state = next(state, static_cast<std::uint8_t>(character));
+
+      if (state == DFA::DEAD_STATE)
+        return false;
+    }
+
+    return is_accepting_at_eof(state);
+  }
+
+  /**
+   * @brief Finds every pattern of a pattern set that matches the whole
+   *        input, in a single scan
+   *
+   * @param[in] input The input to match
+   * @return std::span<const std::uint32_t> The ids of the matching patterns
+   */
+  std::span<const std::uint32_t>
+  DFAView::matching_patterns(std::string_view input) const noexcept
+  {
+    StateId state = m_start_state;
+
+    for (const char character : input)
+    {
+      state = next(state, static_cast<std::uint8_t>(character));
+
+      if (state == DFA::DEAD_STATE)
+        return {};
+    }
+
+    return get_accept_ids(state);
+  }
+
+  /**
+   * @brief Copies the viewed tables into an owning DFA
+   *
+   * @return DFA The automaton
+   */
+  DFA DFAView::to_dfa() const
+  {
+    DFA::ByteClassMap byte_classes;
+    std::memcpy(byte_classes.data(), m_byte_classes, DFA::ALPHABET_SIZE);
+
+    std::vector<std::vector<std::uint32_t>> accept_ids;
+
+    if (m_accept_offsets != nullptr)
+      for (StateId state = 0; state < m_state_count; ++state)
+      {
+        const auto ids = get_accept_ids(state);
+        accept_ids.emplace_back(ids.begin(), ids.end());
+      }
+
+    return DFA(m_start_state, byte_classes, m_class_count,
+               std::vector<StateId>(m_transitions,
+                                    m_transitions +
+                                        m_state_count * m_class_count),
+               std::vector<std::uint8_t>(m_accept_flags,
+                                         m_accept_flags + m_state_count),
+               accept_ids);
+  }
+
+  /**
+   * @brief Gets the number of states, including the dead state
+   *
+   * @return std::size_t The number of states
+   */
+  std::size_t DFAView::get_state_count() const noexcept
+  {
+    return m_state_count;
+  }
+
+  /**
+   * @brief Gets the initial state
+   *
+   * @return StateId The start state
+   */
+  StateId DFAView::get_start_state() const noexcept
+  {
+    return m_start_state;
+  }
+
+  /**
+   * @brief Gets the number of byte classes, the width of a table row
+   *
+   * @return std::size_t The number of byte classes
+   */
+  std::size_t DFAView::get_class_count() const noexcept
+  {
+    return m_class_count;
+  }
+
+  /**
+   * @brief Gets the patterns that match when the input ends in a state
+   *
+   * @param[in] state The state
+   * @return std::span<const std::uint32_t> The pattern ids, empty if the
+   *         DFA does not track patterns
+   */
+  std::span<const std::uint32_t>
+  DFAView::get_accept_ids(StateId state) const noexcept
+  {
+    if (m_accept_offsets == nullptr)
+      return {};
+
+    return {m_accept_ids + m_accept_offsets[state],
+            m_accept_ids + m_accept_offsets[state + 1]};
+  }
+
+  /**
+   * @brief Serializes a DFA
+   *
+   * @param[in] dfa The automaton to write
+   * @param[in] output The stream to write to, opened in binary mode
+   * @throw std::runtime_error If the stream fails
+   */
+  void DFAFile::write(const DFA &dfa, std::ostream &output)
+  {
+    const std::size_t states = dfa.get_state_count();
+    std::vector<std::uint32_t> accept_offsets;
+    std::vector<std::uint32_t> accept_ids;
+
+    if (dfa.has_accept_ids())
+    {
+      accept_offsets.push_back(0);
+
+      for (StateId state = 0; state < states; ++state)
+      {
+        const auto ids = dfa.get_accept_ids(state);
+        accept_ids.insert(accept_ids.end(), ids.begin(), ids.end());
+        accept_offsets.push_back(
+            static_cast<std::uint32_t>(accept_ids.size()));
+      }
+    }
+
+    DFAFileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.endian_tag = ENDIAN_TAG;
+    header.state_count = static_cast<std::uint32_t>(states);
+    header.class_count = static_cast<std::uint32_t>(dfa.get_class_count());
+    header.start_state = dfa.get_start_state();
+    header.accept_id_count = static_cast<std::uint32_t>(accept_ids.size());
+
+    header.byte_classes_offset = align(sizeof(DFAFileHeader));
+    header.transitions_offset =
+        align(header.byte_classes_offset + DFA::ALPHABET_SIZE);
+    header.accept_flags_offset =
+        align(header.transitions_offset +
+              dfa.get_transitions().size() * sizeof(StateId));
+    header.file_size = header.accept_flags_offset + states;
+
+    if (dfa.has_accept_ids())
+    {
+      header.accept_offsets_offset = align(header.file_size);
+      header.accept_ids_offset =
+          align(header.accept_offsets_offset +
+                accept_offsets.size() * sizeof(std::uint32_t));
+      header.file_size = header.accept_ids_offset +
+                         accept_ids.size() * sizeof(std::uint32_t);
+    }
+
+    std::vector<char> buffer(header.file_size, 0);
+    auto copy = [&](std::uint64_t offset, const void *data, std::size_t size)
+    {
+      if (size != 0)
+        std::memcpy(buffer.data() + offset, data, size);
+    };
+
+    copy(0, &header, sizeof(header));
+    copy(header.byte_classes_offset, dfa.get_byte_classes().data(),
+         DFA::ALPHABET_SIZE);
+    copy(header.transitions_offset, dfa.get_transitions().data(),
+         dfa.get_transitions().size() * sizeof(StateId));
+    copy(header.accept_flags_offset, dfa.get_accept_flags().data(), states);
+    copy(header.accept_offsets_offset, accept_offsets.data(),
+         accept_offsets.size() * sizeof(std::uint32_t));
+    copy(header.accept_ids_offset, accept_ids.data(),
+         accept_ids.size() * sizeof(std::uint32_t));
+
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    if (!output)
+      throw std::runtime_error("DFAFile: write failed");
+  }
+
+  /**
+   * @brief Serializes a DFA to a file
+   *
+   * @param[in] dfa The automaton to write
+   * @param[in] path The path of the file, replaced if it exists
+   * @throw std::runtime_error If the file cannot be written
+   */
+  void DFAFile::save(const DFA &dfa, const std::string &path)
+  {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+
+    if (!output)
+      throw std::runtime_error("DFAFile: cannot open " + path);
+
+    write(dfa, output);
+  }
+
+  /**
+   * @brief Validates a serialized DFA and returns a view over it
+   * @details Every table is checked, so scanning the view can never read
+   *          out of bounds, but nothing is copied
+   *
+   * @param[in] data The serialized DFA, aligned to at least 4 bytes
+   * @return DFAView The view, valid as long as data is
+   * @throw std::runtime_error If the data is not a valid DFA file
+   */
+  DFAView DFAFile::load(std::span<const std::byte> data)
+  {
+    if (data.size() < sizeof(DFAFileHeader))
+      throw std::runtime_error("DFAFile: file too small");
+
+    if (reinterpret_cast<std::uintptr_t>(data.data()) % alignof(StateId) != 0)
+      throw std::runtime_error("DFAFile: misaligned buffer");
+
+    DFAFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+      throw std::runtime_error("DFAFile: not a DFA file");
+
+    if (header.endian_tag != ENDIAN_TAG)
+      throw std::runtime_error("DFAFile: byte order does not match this host");
+
+    if (header.version != VERSION)
+      throw std::runtime_error("DFAFile: unsupported version " +
+                               std::to_string(header.version));
+
+    if (header.file_size != data.size())
+      throw std::runtime_error("DFAFile: truncated file");
+
+    const std::uint64_t states = header.state_count;
+    const std::uint64_t classes = header.class_count;
+
+    if (states == 0 || classes == 0 || classes > DFA::ALPHABET_SIZE ||
+        header.start_state >= states)
+      throw std::runtime_error("DFAFile: invalid header");
+
+    check_section(header.byte_classes_offset, DFA::ALPHABET_SIZE, data.size());
+    check_section(header.transitions_offset,
+                  states * classes * sizeof(StateId), data.size());
+    check_section(header.accept_flags_offset, states, data.size());
+
+    const auto *base = reinterpret_cast<const std::uint8_t *>(data.data());
+    DFAView view;
+
+    view.m_start_state = header.start_state;
+    view.m_state_count = states;
+    view.m_class_count = classes;
+    view.m_byte_classes = base + header.byte_classes_offset;
+    view.m_transitions =
+        reinterpret_cast<const StateId *>(base + header.transitions_offset);
+    view.m_accept_flags = base + header.accept_flags_offset;
+
+    for (std::size_t byte = 0; byte < DFA::ALPHABET_SIZE; ++byte)
+      if (view.m_byte_classes[byte] >= classes)
+        throw std::runtime_error("DFAFile: invalid byte class");
+
+    for (std::uint64_t i = 0; i < states * classes; ++i)
+      if (view.m_transitions[i] >= states)
+        throw std::runtime_error("DFAFile: invalid transition target");
+
+    if (header.accept_offsets_offset == 0)
+      return view;
+
+    check_section(header.accept_offsets_offset,
+                  (states + 1) * sizeof(std::uint32_t), data.size());
+    check_section(header.accept_ids_offset,
+                  std::uint64_t{header.accept_id_count} *
+                      sizeof(std::uint32_t),
+                  data.size());
+
+    view.m_accept_offsets = reinterpret_cast<const std::uint32_t *>(
+        base + header.accept_offsets_offset);
+    view.m_accept_ids = reinterpret_cast<const std::uint32_t *>(
+        base + header.accept_ids_offset);
+
+    if (view.m_accept_offsets[0] != 0 ||
+        view.m_accept_offsets[states] != header.accept_id_count)
+      throw std::runtime_error("DFAFile: invalid accept id table");
+
+    for (std::uint64_t state = 0; state < states; ++state)
+      if (view.m_accept_offsets[state] > view.m_accept_offsets[state + 1])
+        throw std::runtime_error("DFAFile: invalid accept id table");
+
+    return view;
+  }
+
+  /**
+   * @brief Construct a new MappedDFA:: MappedDFA object
+   *
+   * @param[in] path The path of a file written by DFAFile
+   * @throw std::runtime_error If the file cannot be mapped or is invalid
+   */
+  MappedDFA::MappedDFA(const std::string &path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+      throw std::runtime_error("DFAFile: cannot open " + path);
+
+    struct stat status;
+
+    if (::fstat(fd, &status) != 0 || status.st_size <= 0)
+    {
+      ::close(fd);
+      throw std::runtime_error("DFAFile: cannot read " + path);
+    }
+
+    m_size = static_cast<std::size_t>(status.st_size);
+    m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (m_data == MAP_FAILED)
+    {
+      m_data = nullptr;
+      throw std::runtime_error("DFAFile: cannot map " + path);
+    }
+
+    try
+    {
+      m_view = DFAFile::load(
+          std::span(static_cast<const std::byte *>(m_data), m_size));
+    }
+    catch (...)
+    {
+      unmap();
+      throw;
+    }
+  }
+
+  /**
+   * @brief Destroy the MappedDFA:: MappedDFA object
+   *
+   */
+  MappedDFA::~MappedDFA()
+  {
+    unmap();
+  }
+
+  /**
+   * @brief Construct a new MappedDFA:: MappedDFA object
+   *
+   * @param[in] other The mapping to take over
+   */
+  MappedDFA::MappedDFA(MappedDFA &&other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)),
+        m_view(std::exchange(other.m_view, DFAView{}))
+  {
+  }
+
+  /**
+   * @brief Takes over the mapping of another MappedDFA
+   *
+   * @param[in] other The mapping to take over
+   * @return MappedDFA& This object
+   */
+  MappedDFA &MappedDFA::operator=(MappedDFA &&other) noexcept
+  {
+    if (this != &other)
+    {
+      unmap();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+      m_view = std::exchange(other.m_view, DFAView{});
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Gets the view over the mapped tables
+   *
+   * @return const DFAView& The view
+   */
+  const DFAView &MappedDFA::get_view() const noexcept
+  {
+    return m_view;
+  }
+
+  /**
+   * @brief Releases the mapping, if any
+   *
+   */
+  void MappedDFA::unmap() noexcept
+  {
+    if (m_data != nullptr)
+      ::munmap(m_data, m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_view = DFAView{};
+  }
+} // namespace dfa
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @struct DFAFileHeader
+   * @brief Fixed-size header at the start of a serialized DFA
+   *
+   * @details Every section offset is relative to the start of the file and
+   *          a multiple of DFAFile::ALIGNMENT. The endian tag holds
+   *          DFAFile::ENDIAN_TAG as written by the producing host, so a file
+   *          from a host of the other byte order is detected.
+   */
+  struct DFAFileHeader
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian_tag;
+    std::uint64_t file_size;
+    std::uint32_t state_count;
+    std::uint32_t class_count;
+    std::uint32_t start_state;
+    std::uint32_t accept_id_count;
+    std::uint64_t byte_classes_offset;
+    std::uint64_t transitions_offset;
+    std::uint64_t accept_flags_offset;
+    std::uint64_t accept_offsets_offset;
+    std::uint64_t accept_ids_offset;
+  };
+
+  static_assert(sizeof(DFAFileHeader) == 80);
+
+  /**
+   * @class DFAView
+   * @brief Read-only DFA over tables it does not own
+   *
+   * @details A view scans a serialized DFA in place, e.g. straight out of a
+   *          memory-mapped file, with the same transition function as DFA.
+   *          It stays valid as long as the underlying buffer does.
+   */
+  class DFAView
+  {
+  public:
+    DFAView() = default;
+
+    [[nodiscard]] bool matches(std::string_view input) const noexcept;
+    [[nodiscard]] std::span<const std::uint32_t>
+    matching_patterns(std::string_view input) const noexcept;
+    DFA to_dfa() const;
+
+    // Getters
+    [[nodiscard]] std::size_t get_state_count() const noexcept;
+    [[nodiscard]] StateId get_start_state() const noexcept;
+    [[nodiscard]] std::size_t get_class_count() const noexcept;
+    [[nodiscard]] std::span<const std::uint32_t>
+    get_accept_ids(StateId state) const noexcept;
+
+    /**
+     * @brief Gets the state reached from state on byte
+     *
+     * @param[in] state The current state
+     * @param[in] byte The input byte
+     * @return StateId The next state
+     */
+    [[nodiscard]] StateId next(StateId state,
+                               std::uint8_t byte) const noexcept
+    {
+      return m_transitions[state * m_class_count + m_byte_classes[byte]];
+    }
+
+    /**
+     * @brief Checks whether a match ends in state
+     *
+     * @param[in] state The state to check
+     * @return true If the state accepts
+     */
+    [[nodiscard]] bool is_accepting(StateId state) const noexcept
+    {
+      return m_accept_flags[state] & ACCEPT;
+    }
+
+    /**
+     * @brief Checks whether a match ends in state when the input ends there
+     *
+     * @param[in] state The state to check
+     * @return true If the state accepts at the end of input
+     */
+    [[nodiscard]] bool is_accepting_at_eof(StateId state) const noexcept
+    {
+      return m_accept_flags[state] & ACCEPT_AT_EOF;
+    }
+
+  private:
+    friend class DFAFile;
+
+    StateId m_start_state = 0;
+    std::size_t m_state_count = 0;
+    std::size_t m_class_count = 0;
+    const std::uint8_t *m_byte_classes = nullptr;
+    const StateId *m_transitions = nullptr;
+    const std::uint8_t *m_accept_flags = nullptr;
+    const std::uint32_t *m_accept_offsets = nullptr;
+    const std::uint32_t *m_accept_ids = nullptr;
+  };
+
+  /**
+   * @class DFAFile
+   * @brief Writes DFAs in a versioned binary format and loads them back
+   *        without copying
+   *
+   * @details The file is a DFAFileHeader followed by the byte class map,
+   *          the transition table, the accept flags and, for pattern sets,
+   *          the accept id table in compressed sparse row form. Sections
+   *          are aligned so the loaded tables can be used in place.
+   */
+  class DFAFile
+  {
+  public:
+    static constexpr char MAGIC[8] = {'R', 'E', 'G', 'E', 'X', 'D', 'F', 'A'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t ENDIAN_TAG = 0x01020304;
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    static void write(const DFA &dfa, std::ostream &output);
+    static void save(const DFA &dfa, const std::string &path);
+    static DFAView load(std::span<const std::byte> data);
+
+  private:
+    DFAFile() = default;
+  };
+
+  /**
+   * @class MappedDFA
+   * @brief Memory-maps a serialized DFA read-only
+   *
+   * @details The mapping is shared, so processes that map the same file
+   *          share its pages. The view returned by get_view() is valid for
+   *          the lifetime of the MappedDFA.
+   */
+  class MappedDFA
+  {
+  public:
+    explicit MappedDFA(const std::string &path);
+    ~MappedDFA();
+
+    MappedDFA(const MappedDFA &) = delete;
+    MappedDFA &operator=(const MappedDFA &) = delete;
+    MappedDFA(MappedDFA &&other) noexcept;
+    MappedDFA &operator=(MappedDFA &&other) noexcept;
+
+    // Getters
+    [[nodiscard]] const DFAView &get_view() const noexcept;
+
+  private:
+    void *m_data = nullptr;
+    std::size_t m_size = 0;
+    DFAView m_view;
+
+    // Helper functions
+    void unmap() noexcept;
+  };
+} // namespace dfa
@@ -0,0 +1,462 @@
+#include <stdexcept>
+#include "followpos_visitor.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Largest number of positions a quantifier may expand to
+     *
+     */
+    constexpr std::uint64_t MAX_POSITIONS = std::uint64_t{1} << 22;
+
+    /**
+     * @brief Copies a set of positions moved by a fixed offset
+     *
+     * @param[in] set The set to copy
+     * @param[in] offset The distance to move every position by
+     * @return PositionSet The moved set
+     */
+    PositionSet shifted(const PositionSet &set, std::size_t offset)
+    {
+      PositionSet result;
+
+      set.for_each([&](std::uint32_t position)
+                   { result.insert(static_cast<std::uint32_t>(position +
+                                                              offset)); });
+      return result;
+    }
+  } // namespace
+
+  /**
+   * @brief Analyzes an AST, augmented with an end marker
+   *
+   * @param[in] tree The AST, with its root set
+   * @return PositionAutomaton The positions and followpos of the AST
+   * @throw std::invalid_argument If the AST has nodes a DFA cannot express
+   */
+  PositionAutomaton FollowposVisitor::analyze(const ast::Arena &tree)
+  {
+    m_tree = &tree;
+    m_automaton = PositionAutomaton{};
+
+    NodeInfo info = visit(tree.get_root());
+    const NodeInfo marker = leaf(PositionKind::END_MARKER, ByteSet{});
+
+    m_automaton.end_markers.push_back(
+        static_cast<std::uint32_t>(m_automaton.size() - 1));
+
+    info = concatenate(std::move(info), marker);
+    m_automaton.first = std::move(info.first);
+
+    return std::move(m_automaton);
+  }
+
+  /**
+   * @brief Computes the position automaton of a pattern set
+   * @details Every child of the root is augmented with its own end marker,
+   *          so the patterns share one automaton but accept separately
+   *
+   * @param[in] tree The AST, whose root children are the patterns
+   * @return PositionAutomaton The positions and followpos of the set
+   * @throw std::invalid_argument If the set is empty or has unsupported
+   *        nodes
+   */
+  PositionAutomaton FollowposVisitor::analyze_set(const ast::Arena &tree)
+  {
+    m_tree = &tree;
+    m_automaton = PositionAutomaton{};
+
+    for (const auto pattern : tree.get_children(tree.get_root()))
+    {
+      NodeInfo info = visit(pattern);
+      const NodeInfo marker = leaf(PositionKind::END_MARKER, ByteSet{});
+
+      m_automaton.end_markers.push_back(
+          static_cast<std::uint32_t>(m_automaton.size() - 1));
+
+      info = concatenate(std::move(info), marker);
+      m_automaton.first.merge(info.first);
+    }
+
+    if (m_automaton.end_markers.empty())
+      throw std::invalid_argument("Empty pattern set");
+
+    return std::move(m_automaton);
+  }
+
+  /**
+   * @brief Visits a literal node as the concatenation of its characters
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_literal_node(const ast::LiteralNode &node)
+  {
+    NodeInfo info;
+
+    for (const char character : node.value)
+      info = concatenate(std::move(info),
+                         leaf(PositionKind::SYMBOL, literal_bytes(character)));
+
+    m_result = std::move(info);
+  }
+
+  /**
+   * @brief Visits a metacharacter node
+   * @details '.' behaves as a wildcard, '^' and '$' as anchors and any other
+   *          metacharacter matches itself
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_metacharacter_node(
+      const ast::MetacharacterNode &node)
+  {
+    if (node.character == '.')
+      m_result = leaf(PositionKind::SYMBOL, wildcard_bytes());
+
+    else if (node.character == '^' || node.character == '$')
+      m_result = anchor(node.character);
+
+    else
+      m_result = leaf(PositionKind::SYMBOL, literal_bytes(node.character));
+  }
+
+  /**
+   * @brief Visits a character class node
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_character_class_node(
+      const ast::CharacterClassNode &node)
+  {
+    m_result = leaf(PositionKind::SYMBOL, character_class_bytes(node.value));
+  }
+
+  /**
+   * @brief Visits a grouping node as the concatenation of its children
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_grouping_node(const ast::GroupingNode &node)
+  {
+    NodeInfo info;
+
+    for (const ast::NodeIndex child : node.children)
+      info = concatenate(std::move(info), visit(child));
+
+    m_result = std::move(info);
+  }
+
+  /**
+   * @brief Visits a quantifier node
+   * @details x{m,n} is expanded to m copies of x followed by n - m optional
+   *          copies; an unbounded maximum adds a starred copy instead. The
+   *          optional copies nest as x(x(x)?)? rather than x?x?x?, which
+   *          keeps followpos linear in the number of copies.
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument If the minimum exceeds the maximum
+   * @throw std::length_error If the expansion has too many positions
+   */
+  void FollowposVisitor::visit_quantifier_node(const ast::QuantifierNode &node)
+  {
+    const std::uint32_t min = node.min_occurrences;
+    const std::uint32_t max = node.max_occurrences;
+
+    if (min > max || min == ast::UNBOUNDED)
+      throw std::invalid_argument("Invalid quantifier bounds");
+
+    if (max == 0)
+    {
+      m_result = NodeInfo{};
+      return;
+    }
+
+    const bool unbounded = max == ast::UNBOUNDED;
+    const std::uint64_t count = unbounded ? std::uint64_t{min} + 1 : max;
+    const std::size_t begin = m_automaton.size();
+
+    NodeInfo child = visit(node.child);
+    const std::size_t end = m_automaton.size();
+
+    if ((end - begin) * count > MAX_POSITIONS)
+      throw std::length_error("Too many positions in quantifier");
+
+    // Every copy is taken before any concatenation adds edges that leave
+    // the child
+    std::vector<NodeInfo> copies;
+    copies.reserve(count);
+    copies.push_back(std::move(child));
+
+    for (std::uint64_t i = 1; i < count; ++i)
+      copies.push_back(copy_of(copies.front(), begin, end));
+
+    NodeInfo info;
+
+    for (std::uint32_t i = 0; i < min; ++i)
+      info = concatenate(std::move(info), copies[i]);
+
+    if (unbounded)
+      info = concatenate(std::move(info), star(std::move(copies.back())));
+
+    else if (max > min)
+    {
+      NodeInfo tail = std::move(copies.back());
+      tail.nullable = true;
+
+      for (std::size_t i = max - 1; i-- > min;)
+      {
+        tail = concatenate(std::move(copies[i]), tail);
+        tail.nullable = true;
+      }
+
+      info = concatenate(std::move(info), tail);
+    }
+
+    m_result = std::move(info);
+  }
+
+  /**
+   * @brief Visits an anchor node
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument If the anchor is not '^' or '$'
+   */
+  void FollowposVisitor::visit_anchor_node(const ast::AnchorNode &node)
+  {
+    if (node.value.size() != 1)
+      throw std::invalid_argument("Invalid anchor: " + std::string(node.value));
+
+    m_result = anchor(node.value.front());
+  }
+
+  /**
+   * @brief Visits an escape sequence node
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_escape_sequence_node(
+      const ast::EscapeSequenceNode &node)
+  {
+    m_result = leaf(PositionKind::SYMBOL, escape_bytes(node.character));
+  }
+
+  /**
+   * @brief Visits a wildcard node
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_wildcard_node(const ast::WildcardNode &)
+  {
+    m_result = leaf(PositionKind::SYMBOL, wildcard_bytes());
+  }
+
+  /**
+   * @brief Visits an alternation node
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_alternation_node(
+      const ast::AlternationNode &node)
+  {
+    NodeInfo info;
+    info.nullable = false;
+
+    for (const ast::NodeIndex child : node.children)
+      info = alternate(std::move(info), visit(child));
+
+    m_result = std::move(info);
+  }
+
+  /**
+   * @brief Rejects boundary nodes, which need lookaround a DFA lacks
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument Always
+   */
+  void FollowposVisitor::visit_boundary_node(const ast::BoundaryNode &node)
+  {
+    throw std::invalid_argument("Unsupported boundary: " +
+                                std::string(node.value));
+  }
+
+  /**
+   * @brief Rejects modifier nodes, which are not supported yet
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument Always
+   */
+  void FollowposVisitor::visit_modifier_node(const ast::ModifierNode &node)
+  {
+    throw std::invalid_argument("Unsupported modifier: " +
+                                std::string(node.value));
+  }
+
+  /**
+   * @brief Rejects invalid nodes
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument Always
+   */
+  void FollowposVisitor::visit_invalid_node(const ast::InvalidNode &node)
+  {
+    throw std::invalid_argument("Invalid token: " + std::string(node.value));
+  }
+
+  /**
+   * @brief Visits an end of input node as a '$' anchor
+   *
+   * @param[in] node The node to visit
+   */
+  void FollowposVisitor::visit_end_of_input_node(const ast::EndOfInputNode &)
+  {
+    m_result = anchor('$');
+  }
+
+  /**
+   * @brief Visits a subtree and returns its result
+   *
+   * @param[in] node The root of the subtree
+   * @return NodeInfo The nullable, firstpos and lastpos of the subtree
+   */
+  FollowposVisitor::NodeInfo FollowposVisitor::visit(ast::NodeIndex node)
+  {
+    m_tree->accept(node, *this);
+    return std::move(m_result);
+  }
+
+  /**
+   * @brief Creates a new leaf position
+   *
+   * @param[in] kind How the position consumes input
+   * @param[in] symbols The bytes the position consumes
+   * @return NodeInfo The info of a single-position subtree
+   */
+  FollowposVisitor::NodeInfo FollowposVisitor::leaf(PositionKind kind,
+                                                    const ByteSet &symbols)
+  {
+    const auto position = static_cast<std::uint32_t>(m_automaton.size());
+
+    m_automaton.symbols.push_back(symbols);
+    m_automaton.kinds.push_back(kind);
+    m_automaton.follow.emplace_back();
+
+    NodeInfo info;
+    info.nullable = false;
+    info.first.insert(position);
+    info.last.insert(position);
+
+    return info;
+  }
+
+  /**
+   * @brief Appends a copy of an analyzed subtree at new positions
+   *
+   * @param[in] info The info of the subtree
+   * @param[in] begin The first position of the subtree
+   * @param[in] end One past the last position of the subtree, which must
+   *            not have followpos leaving the range yet
+   * @return NodeInfo The info of the copy
+   */
+  FollowposVisitor::NodeInfo FollowposVisitor::copy_of(const NodeInfo &info,
+                                                       std::size_t begin,
+                                                       std::size_t end)
+  {
+    const std::size_t offset = m_automaton.size() - begin;
+
+    for (std::size_t position = begin; position < end; ++position)
+    {
+      ByteSet symbols = m_automaton.symbols[position];
+      const PositionKind kind = m_automaton.kinds[position];
+      PositionSet follow = shifted(m_automaton.follow[position], offset);
+
+      m_automaton.symbols.push_back(symbols);
+      m_automaton.kinds.push_back(kind);
+      m_automaton.follow.push_back(std::move(follow));
+    }
+
+    NodeInfo copy;
+    copy.nullable = info.nullable;
+    copy.first = shifted(info.first, offset);
+    copy.last = shifted(info.last, offset);
+
+    return copy;
+  }
+
+  /**
+   * @brief Combines two subtrees matched one after the other
+   *
+   * @param[in] left The first subtree
+   * @param[in] right The second subtree
+   * @return NodeInfo The info of the concatenation
+   */
+  FollowposVisitor::NodeInfo FollowposVisitor::concatenate(
+      NodeInfo left, const NodeInfo &right)
+  {
+    left.last.for_each([&](std::uint32_t position)
+                       { m_automaton.follow[position].merge(right.first); });
+
+    if (left.nullable)
+      left.first.merge(right.first);
+
+    if (right.nullable)
+      left.last.merge(right.last);
+
+    else
+      left.last = right.last;
+
+    left.nullable = left.nullable && right.nullable;
+    return left;
+  }
+
+  /**
+   * @brief Combines two subtrees matched as alternatives
+   *
+   * @param[in] left The first alternative
+   * @param[in] right The second alternative
+   * @return NodeInfo The info of the alternation
+   */
+  FollowposVisitor::NodeInfo FollowposVisitor::alternate(
+      NodeInfo left, const NodeInfo &right) const
+  {
+    left.first.merge(right.first);
+    left.last.merge(right.last);
+    left.nullable = left.nullable || right.nullable;
+
+    return left;
+  }
+
+  /**
+   * @brief Applies the Kleene star to a subtree
+   *
+   * @param[in] info The subtree
+   * @return NodeInfo The info of the starred subtree
+   */
+  FollowposVisitor::NodeInfo FollowposVisitor::star(NodeInfo info)
+  {
+    info.last.for_each([&](std::uint32_t position)
+                       { m_automaton.follow[position].merge(info.first); });
+
+    info.nullable = true;
+    return info;
+  }
+
+  /**
+   * @brief Creates the position of a '^' or '$' anchor
+   *
+   * @param[in] character The anchor character
+   * @return NodeInfo The info of the anchor
+   * @throw std::invalid_argument If the character is not an anchor
+   */
+  FollowposVisitor::NodeInfo FollowposVisitor::anchor(char character)
+  {
+    if (character == '^')
+      return leaf(PositionKind::START_ANCHOR, ByteSet{});
+
+    if (character == '$')
+      return leaf(PositionKind::END_ANCHOR, ByteSet{});
+
+    throw std::invalid_argument(std::string("Invalid anchor: ") + character);
+  }
+} // namespace dfa
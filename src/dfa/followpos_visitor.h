@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../ast/arena.h"
+#include "position_automaton.h"
+
+namespace dfa
+{
+  /**
+   * @class FollowposVisitor
+   * @brief Numbers the leaf positions of an AST and computes nullable,
+   *        firstpos, lastpos and followpos for every node
+   *
+   * @details Grouping nodes are treated as the concatenation of their
+   *          children, and bounded quantifiers are expanded into copies of
+   *          their child. The child is analyzed once and every copy reuses
+   *          its followpos shifted to new positions, so a repeat costs time
+   *          linear in its expanded size. analyze_set() treats every child
+   *          of the root as a separate pattern with its own end marker.
+   */
+  class FollowposVisitor : public ast::AstVisitor
+  {
+  public:
+    FollowposVisitor() = default;
+
+    PositionAutomaton analyze(const ast::Arena &tree);
+    PositionAutomaton analyze_set(const ast::Arena &tree);
+
+    void visit_literal_node(const ast::LiteralNode &node) override;
+    void visit_metacharacter_node(
+        const ast::MetacharacterNode &node) override;
+
+    void visit_character_class_node(
+        const ast::CharacterClassNode &node) override;
+
+    void visit_grouping_node(const ast::GroupingNode &node) override;
+    void visit_quantifier_node(const ast::QuantifierNode &node) override;
+    void visit_anchor_node(const ast::AnchorNode &node) override;
+    void visit_escape_sequence_node(
+        const ast::EscapeSequenceNode &node) override;
+
+    void visit_wildcard_node(const ast::WildcardNode &node) override;
+    void visit_alternation_node(const ast::AlternationNode &node) override;
+    void visit_boundary_node(const ast::BoundaryNode &node) override;
+    void visit_modifier_node(const ast::ModifierNode &node) override;
+    void visit_invalid_node(const ast::InvalidNode &node) override;
+    void visit_end_of_input_node(const ast::EndOfInputNode &node) override;
+
+  private:
+    /**
+     * @struct NodeInfo
+     * @brief The nullable, firstpos and lastpos of a visited subtree
+     *
+     */
+    struct NodeInfo
+    {
+      bool nullable = true;
+      PositionSet first;
+      PositionSet last;
+    };
+
+    const ast::Arena *m_tree = nullptr;
+    PositionAutomaton m_automaton;
+    NodeInfo m_result;
+
+    // Helper functions
+    NodeInfo visit(ast::NodeIndex node);
+    NodeInfo leaf(PositionKind kind, const ByteSet &symbols);
+    NodeInfo copy_of(const NodeInfo &info, std::size_t begin,
+                     std::size_t end);
+    NodeInfo concatenate(NodeInfo left, const NodeInfo &right);
+    NodeInfo alternate(NodeInfo left, const NodeInfo &right) const;
+    NodeInfo star(NodeInfo info);
+    NodeInfo anchor(char character);
+  };
+} // namespace dfa
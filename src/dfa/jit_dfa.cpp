@@ -0,0 +1,384 @@
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "jit_dfa.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define REGEX_DFA_X86_JIT 1
+#endif
+
+namespace dfa
+{
+#ifdef REGEX_DFA_X86_JIT
+  namespace
+  {
+    using Label = std::size_t;
+
+    /**
+     * @class Assembler
+     * @brief Emits x86-64 machine code into a buffer, resolving jumps to
+     *        labels once all code is written
+     *
+     */
+    class Assembler
+    {
+    public:
+      [[nodiscard]] Label new_label()
+      {
+        m_labels.push_back(UNBOUND);
+        return m_labels.size() - 1;
+      }
+
+      void bind(Label label)
+      {
+        m_labels[label] = m_code.size();
+      }
+
+      void emit(std::initializer_list<std::uint8_t> bytes)
+      {
+        m_code.insert(m_code.end(), bytes);
+      }
+
+      void emit32(std::uint32_t value)
+      {
+        for (int shift = 0; shift < 32; shift += 8)
+          m_code.push_back(static_cast<std::uint8_t>(value >> shift));
+      }
+
+      /**
+       * @brief Emits a rel32 operand pointing at label
+       *
+       * @param[in] label The target of the operand
+       */
+      void emit_rel32(Label label)
+      {
+        m_fixups.push_back({m_code.size(), label, m_code.size() + 4});
+        emit32(0);
+      }
+
+      /**
+       * @brief Emits a jump table entry, the offset of label from the
+       *        table at base
+       *
+       * @param[in] label The target of the entry
+       * @param[in] base The table label, already bound
+       */
+      void emit_entry(Label label, Label base)
+      {
+        m_fixups.push_back({m_code.size(), label, m_labels[base]});
+        emit32(0);
+      }
+
+      void align(std::size_t alignment)
+      {
+        while (m_code.size() % alignment != 0)
+          m_code.push_back(0xCC);
+      }
+
+      /**
+       * @brief Resolves every label reference
+       *
+       * @return std::vector<std::uint8_t> The finished code
+       */
+      std::vector<std::uint8_t> finish()
+      {
+        for (const Fixup &fixup : m_fixups)
+        {
+          const auto value = static_cast<std::uint32_t>(
+              static_cast<std::int64_t>(m_labels[fixup.label]) -
+              static_cast<std::int64_t>(fixup.base));
+
+          std::memcpy(m_code.data() + fixup.position, &value, sizeof(value));
+        }
+
+        return std::move(m_code);
+      }
+
+    private:
+      static constexpr std::size_t UNBOUND = ~std::size_t{0};
+
+      struct Fixup
+      {
+        std::size_t position;
+        Label label;
+        std::size_t base;
+      };
+
+      std::vector<std::uint8_t> m_code;
+      std::vector<std::size_t> m_labels;
+      std::vector<Fixup> m_fixups;
+    };
+
+    struct ByteRange
+    {
+      std::uint32_t first;
+      Label target;
+    };
+
+    /**
+     * @brief Emits a binary search over byte ranges, with the byte in eax
+     *
+     * @param[in] assembler The code buffer
+     * @param[in] ranges The ranges, sorted by first byte
+     */
+    void emit_compare_tree(Assembler &assembler,
+                           std::span<const ByteRange> ranges)
+    {
+      if (ranges.size() == 1)
+      {
+        assembler.emit({0xE9}); // jmp rel32
+        assembler.emit_rel32(ranges[0].target);
+        return;
+      }
+
+      const std::size_t middle = ranges.size() / 2;
+      const Label upper = assembler.new_label();
+
+      assembler.emit({0x3D}); // cmp eax, imm32
+      assembler.emit32(ranges[middle].first);
+      assembler.emit({0x0F, 0x83}); // jae rel32
+      assembler.emit_rel32(upper);
+      emit_compare_tree(assembler, ranges.first(middle));
+      assembler.bind(upper);
+      emit_compare_tree(assembler, ranges.subspan(middle));
+    }
+
+    /**
+     * @brief Translates a DFA into a function taking the input bounds in
+     *        rdi and rsi and returning whether it matches in al
+     *
+     * @param[in] dfa The automaton
+     * @return std::vector<std::uint8_t> The machine code
+     */
+    std::vector<std::uint8_t> translate(const DFA &dfa)
+    {
+      Assembler assembler;
+      const std::size_t states = dfa.get_state_count();
+      const std::size_t class_count = dfa.get_class_count();
+
+      std::vector<Label> blocks(states);
+
+      for (auto &block : blocks)
+        block = assembler.new_label();
+
+      const Label accept = assembler.new_label();
+      const Label reject = assembler.new_label();
+      const Label classes = assembler.new_label();
+      // Label 0 belongs to the dead state, which has no code, so it marks
+      // states without a jump table
+      std::vector<Label> tables(states, 0);
+
+      // The dead state rejects on every byte, so jumps to it end the scan
+      blocks[DFA::DEAD_STATE] = reject;
+
+      // Enter at the start state
+      assembler.emit({0xE9});
+      assembler.emit_rel32(blocks[dfa.get_start_state()]);
+
+      for (StateId state = 1; state < states; ++state)
+      {
+        assembler.align(16);
+        assembler.bind(blocks[state]);
+        assembler.emit({0x48, 0x39, 0xF7}); // cmp rdi, rsi
+        assembler.emit({0x0F, 0x84});       // je rel32
+        assembler.emit_rel32(dfa.is_accepting_at_eof(state) ? accept : reject);
+        assembler.emit({0x0F, 0xB6, 0x07});       // movzx eax, byte [rdi]
+        assembler.emit({0x48, 0x83, 0xC7, 0x01}); // add rdi, 1
+
+        std::vector<ByteRange> ranges;
+
+        for (std::uint32_t byte = 0; byte < DFA::ALPHABET_SIZE; ++byte)
+        {
+          const Label target =
+              blocks[dfa.next(state, static_cast<std::uint8_t>(byte))];
+
+          if (ranges.empty() || ranges.back().target != target)
+            ranges.push_back({byte, target});
+        }
+
+        if (ranges.size() <= JitDFA::MAX_COMPARE_RANGES)
+        {
+          emit_compare_tree(assembler, ranges);
+          continue;
+        }
+
+        tables[state] = assembler.new_label();
+        assembler.emit({0x48, 0x8D, 0x0D}); // lea rcx, [rip + classes]
+        assembler.emit_rel32(classes);
+        assembler.emit({0x0F, 0xB6, 0x04, 0x01}); // movzx eax, [rcx + rax]
+        assembler.emit({0x48, 0x8D, 0x0D});       // lea rcx, [rip + table]
+        assembler.emit_rel32(tables[state]);
+        assembler.emit({0x48, 0x63, 0x04, 0x81}); // movsxd rax, [rcx + rax*4]
+        assembler.emit({0x48, 0x01, 0xC8});       // add rax, rcx
+        assembler.emit({0xFF, 0xE0});             // jmp rax
+      }
+
+      assembler.bind(accept);
+      assembler.emit({0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3}); // mov eax, 1; ret
+      assembler.bind(reject);
+      assembler.emit({0x31, 0xC0, 0xC3}); // xor eax, eax; ret
+
+      assembler.align(64);
+      assembler.bind(classes);
+
+      for (const std::uint8_t byte_class : dfa.get_byte_classes())
+        assembler.emit({byte_class});
+
+      for (StateId state = 1; state < states; ++state)
+      {
+        if (tables[state] == 0)
+          continue;
+
+        assembler.align(4);
+        assembler.bind(tables[state]);
+
+        for (std::size_t byte_class = 0; byte_class < class_count;
+             ++byte_class)
+          assembler.emit_entry(blocks[dfa.next_class(state, byte_class)],
+                               tables[state]);
+      }
+
+      return assembler.finish();
+    }
+  } // namespace
+#endif
+
+  /**
+   * @brief Construct a new JitDFA:: JitDFA object
+   *
+   * @param[in] dfa The automaton, usually minimized, to compile
+   */
+  JitDFA::JitDFA(DFA dfa) : m_dfa(std::move(dfa))
+  {
+    compile();
+  }
+
+  /**
+   * @brief Destroy the JitDFA:: JitDFA object
+   *
+   */
+  JitDFA::~JitDFA()
+  {
+    unmap();
+  }
+
+  /**
+   * @brief Construct a new JitDFA:: JitDFA object
+   *
+   * @param[in] other The compiled automaton to take over
+   */
+  JitDFA::JitDFA(JitDFA &&other) noexcept
+      : m_dfa(std::move(other.m_dfa)),
+        m_code(std::exchange(other.m_code, nullptr)),
+        m_mapped_size(std::exchange(other.m_mapped_size, 0)),
+        m_code_size(std::exchange(other.m_code_size, 0)),
+        m_function(std::exchange(other.m_function, nullptr))
+  {
+  }
+
+  /**
+   * @brief Takes over the compiled automaton of another JitDFA
+   *
+   * @param[in] other The compiled automaton to take over
+   * @return JitDFA& This object
+   */
+  JitDFA &JitDFA::operator=(JitDFA &&other) noexcept
+  {
+    if (this != &other)
+    {
+      unmap();
+      m_dfa = std::move(other.m_dfa);
+      m_code = std::exchange(other.m_code, nullptr);
+      m_mapped_size = std::exchange(other.m_mapped_size, 0);
+      m_code_size = std::exchange(other.m_code_size, 0);
+      m_function = std::exchange(other.m_function, nullptr);
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Checks whether matches() runs native code
+   *
+   * @return true If the automaton was compiled to machine code
+   */
+  bool JitDFA::is_native() const noexcept
+  {
+    return m_function != nullptr;
+  }
+
+  /**
+   * @brief Gets the size of the machine code and its tables
+   *
+   * @return std::size_t The number of bytes, 0 without native code
+   */
+  std::size_t JitDFA::get_code_size() const noexcept
+  {
+    return m_code_size;
+  }
+
+  /**
+   * @brief Gets the table-driven automaton the code was compiled from
+   *
+   * @return const DFA& The automaton
+   */
+  const DFA &JitDFA::get_dfa() const noexcept
+  {
+    return m_dfa;
+  }
+
+  /**
+   * @brief Emits the machine code and maps it executable
+   * @details The mapping is writable while the code is copied in and only
+   *          executable afterwards. Any failure leaves the matcher on the
+   *          table-driven DFA.
+   *
+   */
+  void JitDFA::compile()
+  {
+#ifdef REGEX_DFA_X86_JIT
+    const std::vector<std::uint8_t> code = translate(m_dfa);
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t size = (code.size() + page - 1) / page * page;
+
+    void *memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED)
+      return;
+
+    std::memcpy(memory, code.data(), code.size());
+
+    if (::mprotect(memory, size, PROT_READ | PROT_EXEC) != 0)
+    {
+      ::munmap(memory, size);
+      return;
+    }
+
+    m_code = memory;
+    m_mapped_size = size;
+    m_code_size = code.size();
+    m_function = reinterpret_cast<MatchFunction>(m_code);
+#endif
+  }
+
+  /**
+   * @brief Releases the machine code, if any
+   *
+   */
+  void JitDFA::unmap() noexcept
+  {
+    if (m_code != nullptr)
+      ::munmap(m_code, m_mapped_size);
+
+    m_code = nullptr;
+    m_mapped_size = 0;
+    m_code_size = 0;
+    m_function = nullptr;
+  }
+} // namespace dfa
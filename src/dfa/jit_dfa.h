@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @class JitDFA
+   * @brief A DFA compiled to native x86-64 code
+   *
+   * @details Every live state becomes a block of machine code that reads
+   *          one byte and jumps straight to the block of the next state,
+   *          so the current state is the program counter rather than a
+   *          table index. A state with few distinct byte ranges dispatches
+   *          through a binary tree of compares; the others go through a
+   *          jump table indexed by byte class. The code lives in its own
+   *          mapping, made executable only after it is written. On other
+   *          architectures, or where executable memory cannot be mapped,
+   *          the matcher runs the table-driven DFA instead, and
+   *          is_native() returns false.
+   */
+  class JitDFA
+  {
+  public:
+    // States with more byte ranges than this use a jump table
+    static constexpr std::size_t MAX_COMPARE_RANGES = 8;
+
+    explicit JitDFA(DFA dfa);
+    ~JitDFA();
+
+    JitDFA(const JitDFA &) = delete;
+    JitDFA &operator=(const JitDFA &) = delete;
+    JitDFA(JitDFA &&other) noexcept;
+    JitDFA &operator=(JitDFA &&other) noexcept;
+
+    /**
+     * @brief Checks whether the automaton matches the whole input
+     *
+     * @param[in] input The input to match
+     * @return true If the input matches
+     */
+    [[nodiscard]] bool matches(std::string_view input) const noexcept
+    {
+      if (m_function == nullptr)
+        return m_dfa.matches(input);
+
+      const auto *begin = reinterpret_cast<const std::uint8_t *>(input.data());
+      return m_function(begin, begin + input.size());
+    }
+
+    // Getters
+    [[nodiscard]] bool is_native() const noexcept;
+    [[nodiscard]] std::size_t get_code_size() const noexcept;
+    [[nodiscard]] const DFA &get_dfa() const noexcept;
+
+  private:
+    using MatchFunction = bool (*)(const std::uint8_t *, const std::uint8_t *);
+
+    DFA m_dfa;
+    void *m_code = nullptr;
+    std::size_t m_mapped_size = 0;
+    std::size_t m_code_size = 0;
+    MatchFunction m_function = nullptr;
+
+    // Helper functions
+    void compile();
+    void unmap() noexcept;
+  };
+} // namespace dfa
@@ -0,0 +1,179 @@
+#include "lazy_dfa.h"
+
+namespace dfa
+{
+  /**
+   * @brief Construct a new LazyDFA:: LazyDFA object
+   *
+   * @param[in] automaton The positions and followpos to determinize
+   * @param[in] options The cache options
+   */
+  LazyDFA::LazyDFA(PositionAutomaton automaton, LazyDFAOptions options)
+      : m_automaton(std::move(automaton)), m_options(options),
+        m_classes(byte_classes(m_automaton.symbols)),
+        m_representatives(m_classes.count, 0),
+        m_start_set(DFABuilder(m_automaton).start_set())
+  {
+    for (std::size_t byte = DFA::ALPHABET_SIZE; byte-- > 0;)
+      m_representatives[m_classes.map[byte]] = static_cast<std::uint8_t>(byte);
+
+    clear_cache();
+  }
+
+  /**
+   * @brief Checks whether the whole input is matched by the automaton
+   *
+   * @param[in] input The input to match
+   * @return true If the input is in the language of the automaton
+   */
+  bool LazyDFA::matches(std::string_view input)
+  {
+    const std::size_t class_count = m_classes.count;
+    StateId state = m_start_state;
+
+    for (const char character : input)
+    {
+      const std::uint8_t byte_class =
+          m_classes.map[static_cast<std::uint8_t>(character)];
+      StateId next = m_transitions[state * class_count + byte_class];
+
+      if (next == UNKNOWN)
+        next = transition(state, byte_class);
+
+      else
+        ++m_stats.hits;
+
+      if (next == DFA::DEAD_STATE)
+        return false;
+
+      state = next;
+    }
+
+    return m_accept_flags[state] & ACCEPT_AT_EOF;
+  }
+
+  /**
+   * @brief Drops every cached state except the dead and start states
+   *
+   */
+  void LazyDFA::clear_cache()
+  {
+    m_ids.clear();
+    m_states.clear();
+    m_transitions.clear();
+    m_accept_flags.clear();
+    m_stats.states = 0;
+    m_stats.memory = 0;
+
+    intern(PositionSet{});
+    m_start_state = intern(m_start_set);
+  }
+
+  /**
+   * @brief Gets the cache counters
+   *
+   * @return const LazyDFAStats& The counters
+   */
+  const LazyDFAStats &LazyDFA::get_stats() const noexcept
+  {
+    return m_stats;
+  }
+
+  /**
+   * @brief Gets the number of byte classes, the width of a cached row
+   *
+   * @return std::size_t The number of byte classes
+   */
+  std::size_t LazyDFA::get_class_count() const noexcept
+  {
+    return m_classes.count;
+  }
+
+  /**
+   * @brief Gets the number of positions of the underlying automaton
+   *
+   * @return std::size_t The number of positions
+   */
+  std::size_t LazyDFA::get_position_count() const noexcept
+  {
+    return m_automaton.size();
+  }
+
+  /**
+   * @brief Determinizes a missing transition and caches it
+   * @details If the new state does not fit the cache, the cache is flushed
+   *          and the current state is interned again before the target, so
+   *          the scan can continue from it
+   *
+   * @param[in] state The current state
+   * @param[in] byte_class The class of the input byte
+   * @return StateId The next state
+   */
+  StateId LazyDFA::transition(StateId state, std::uint8_t byte_class)
+  {
+    ++m_stats.misses;
+
+    PositionSet target = DFABuilder(m_automaton)
+                             .step(*m_states[state],
+                                   m_representatives[byte_class]);
+
+    if (auto it = m_ids.find(target); it != m_ids.end())
+      return m_transitions[state * m_classes.count + byte_class] = it->second;
+
+    if (m_stats.memory + state_cost(target) > m_options.cache_capacity)
+    {
+      PositionSet current = *m_states[state];
+
+      ++m_stats.flushes;
+      clear_cache();
+      state = intern(std::move(current));
+    }
+
+    const StateId next = intern(std::move(target));
+
+    m_transitions[state * m_classes.count + byte_class] = next;
+    return next;
+  }
+
+  /**
+   * @brief Adds a state to the cache unless it is already there
+   *
+   * @param[in] set The positions of the state
+   * @return StateId The id of the state
+   */
+  StateId LazyDFA::intern(PositionSet set)
+  {
+    auto [it, inserted] = m_ids.try_emplace(
+        std::move(set), static_cast<StateId>(m_states.size()));
+
+    if (!inserted)
+      return it->second;
+
+    const StateId state = it->second;
+    const bool dead = state == DFA::DEAD_STATE;
+
+    m_states.push_back(&it->first);
+    m_transitions.resize(m_transitions.size() + m_classes.count,
+                         dead ? DFA::DEAD_STATE : UNKNOWN);
+    m_accept_flags.push_back(DFABuilder(m_automaton).accept_flags(it->first));
+
+    ++m_stats.states;
+    m_stats.memory += state_cost(it->first);
+
+    return state;
+  }
+
+  /**
+   * @brief Estimates the memory a cached state takes
+   *
+   * @param[in] set The positions of the state
+   * @return std::size_t The approximate number of bytes
+   */
+  std::size_t LazyDFA::state_cost(const PositionSet &set) const noexcept
+  {
+    // Transition row, accept flags, the set and its hash table node
+    return m_classes.count * sizeof(StateId) + sizeof(std::uint8_t) +
+           sizeof(const PositionSet *) + sizeof(PositionSet) +
+           set.memory_usage() + 4 * sizeof(void *);
+  }
+} // namespace dfa
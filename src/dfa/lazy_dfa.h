@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "dfa.h"
+#include "dfa_builder.h"
+#include "position_automaton.h"
+
+namespace dfa
+{
+  /**
+   * @struct LazyDFAOptions
+   * @brief Options of a LazyDFA
+   *
+   */
+  struct LazyDFAOptions
+  {
+    // Approximate memory limit of the state cache, in bytes
+    std::size_t cache_capacity = std::size_t{2} << 20;
+  };
+
+  /**
+   * @struct LazyDFAStats
+   * @brief Counters describing how well the state cache performs
+   *
+   * @details
+   *       - hits: Transitions taken from the cache.
+   *       - misses: Transitions that had to be determinized.
+   *       - flushes: Times the cache filled up and was cleared.
+   *       - states: States currently cached, including the dead state.
+   *       - memory: Approximate bytes currently used by the cache.
+   */
+  struct LazyDFAStats
+  {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t flushes = 0;
+    std::size_t states = 0;
+    std::size_t memory = 0;
+  };
+
+  /**
+   * @class LazyDFA
+   * @brief A DFA whose states are determinized only when a scan reaches
+   *        them
+   *
+   * @details States are the same position sets DFABuilder creates, kept in
+   *          a cache with a row of byte class transitions each. Unknown
+   *          transitions are computed on first use. When the cache would
+   *          exceed its memory limit it is cleared and rebuilt from the state
+   *          the scan is in, so patterns whose full DFA is exponential still
+   *          run in bounded memory. Matching mutates the cache, so a LazyDFA
+   *          must not be shared between threads.
+   */
+  class LazyDFA
+  {
+  public:
+    explicit LazyDFA(PositionAutomaton automaton, LazyDFAOptions options = {});
+
+    LazyDFA(const LazyDFA &) = delete;
+    LazyDFA &operator=(const LazyDFA &) = delete;
+    LazyDFA(LazyDFA &&) = default;
+    LazyDFA &operator=(LazyDFA &&) = default;
+
+    [[nodiscard]] bool matches(std::string_view input);
+    void clear_cache();
+
+    // Getters
+    [[nodiscard]] const LazyDFAStats &get_stats() const noexcept;
+    [[nodiscard]] std::size_t get_class_count() const noexcept;
+    [[nodiscard]] std::size_t get_position_count() const noexcept;
+
+  private:
+    static constexpr StateId UNKNOWN = ~StateId{0};
+
+    PositionAutomaton m_automaton;
+    LazyDFAOptions m_options;
+    LazyDFAStats m_stats;
+
+    ByteClasses m_classes;
+    std::vector<std::uint8_t> m_representatives;
+    PositionSet m_start_set;
+    StateId m_start_state = DFA::DEAD_STATE;
+
+    // The cache: position sets by id, and transition rows of class_count
+    std::unordered_map<PositionSet, StateId, PositionSetHash> m_ids;
+    std::vector<const PositionSet *> m_states;
+    std::vector<StateId> m_transitions;
+    std::vector<std::uint8_t> m_accept_flags;
+
+    // Helper functions
+    StateId transition(StateId state, std::uint8_t byte_class);
+    StateId intern(PositionSet set);
+    std::size_t state_cost(const PositionSet &set) const noexcept;
+  };
+} // namespace dfa
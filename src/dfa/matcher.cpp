@@ -0,0 +1,71 @@
+#include "matcher.h"
+
+namespace dfa
+{
+  /**
+   * @brief Construct a new Matcher:: Matcher object running a DFA
+   *
+   * @param[in] dfa The automaton
+   */
+  Matcher::Matcher(DFA dfa) : m_engine(std::move(dfa))
+  {
+  }
+
+  /**
+   * @brief Construct a new Matcher:: Matcher object running a PikeVM
+   *
+   * @param[in] vm The simulation
+   */
+  Matcher::Matcher(PikeVM vm) : m_engine(std::move(vm))
+  {
+  }
+
+  /**
+   * @brief Construct a new Matcher:: Matcher object running a
+   *        BitParallelNFA
+   *
+   * @param[in] nfa The simulation
+   */
+  Matcher::Matcher(BitParallelNFA nfa) : m_engine(std::move(nfa))
+  {
+  }
+
+  /**
+   * @brief Checks whether the pattern matches the whole input
+   *
+   * @param[in] input The input to match
+   * @return true If the input matches
+   */
+  bool Matcher::matches(std::string_view input) const
+  {
+    return std::visit([&](const auto &engine)
+                      { return engine.matches(input); },
+                      m_engine);
+  }
+
+  /**
+   * @brief Gets the engine that runs the pattern
+   *
+   * @return Engine The engine
+   */
+  Engine Matcher::get_engine() const noexcept
+  {
+    if (std::holds_alternative<DFA>(m_engine))
+      return Engine::DFA;
+
+    return std::holds_alternative<PikeVM>(m_engine) ? Engine::PIKE_VM
+                                                    : Engine::BIT_PARALLEL;
+  }
+
+  /**
+   * @brief Gets the heap memory held by the engine
+   *
+   * @return std::size_t The number of bytes
+   */
+  std::size_t Matcher::memory_usage() const noexcept
+  {
+    return std::visit([](const auto &engine)
+                      { return engine.memory_usage(); },
+                      m_engine);
+  }
+} // namespace dfa
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <variant>
+
+#include "bit_parallel_nfa.h"
+#include "dfa.h"
+#include "pike_vm.h"
+
+namespace dfa
+{
+  /**
+   * @brief The Engine enum lists the ways a Matcher can run a pattern
+   *
+   * @details
+   *       - DFA: A fully built, minimized DFA; one table lookup per byte.
+   *       - PIKE_VM: A simulation of the Thompson NFA, used when the DFA
+   *                  would exceed its budget.
+   *       - BIT_PARALLEL: A one-word simulation of an automaton of at most
+   *                       64 positions, which skips determinization.
+   */
+  enum class Engine : std::uint8_t
+  {
+    DFA,
+    PIKE_VM,
+    BIT_PARALLEL
+  };
+
+  /**
+   * @class Matcher
+   * @brief Matches whole inputs against a pattern with whichever engine the
+   *        compiler could afford
+   *
+   * @details Compiler::compile_matcher() picks a BitParallelNFA for
+   *          patterns of at most 64 positions, then a DFA when it fits the
+   *          budget and a PikeVM otherwise. All accept the same inputs;
+   *          get_engine() tells which one runs.
+   */
+  class Matcher
+  {
+  public:
+    explicit Matcher(DFA dfa);
+    explicit Matcher(PikeVM vm);
+    explicit Matcher(BitParallelNFA nfa);
+
+    [[nodiscard]] bool matches(std::string_view input) const;
+
+    // Getters
+    [[nodiscard]] Engine get_engine() const noexcept;
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+  private:
+    std::variant<DFA, PikeVM, BitParallelNFA> m_engine;
+  };
+} // namespace dfa
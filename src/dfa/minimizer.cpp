@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <map>
+#include "minimizer.h"
+
+namespace dfa
+{
+  /**
+   * @brief Construct a new Minimizer:: Minimizer object
+   *
+   * @param[in] dfa The automaton to minimize
+   */
+  Minimizer::Minimizer(const DFA &dfa)
+      : m_dfa(dfa), m_states_removed(0)
+  {
+  }
+
+  /**
+   * @brief Builds the minimal DFA accepting the same language
+   * @details States are renumbered in breadth-first order from the start
+   *          state, so equal languages always give identical tables
+   *
+   * @return DFA The minimized automaton
+   */
+  DFA Minimizer::minimize()
+  {
+    compute_byte_classes();
+
+    const std::vector<StateId> states = reachable_states();
+    const std::vector<std::uint32_t> block_of = refine(states);
+
+    std::vector<std::uint32_t> local(m_dfa.get_state_count(), 0);
+
+    for (std::uint32_t i = 0; i < states.size(); ++i)
+      local[states[i]] = i;
+
+    // Pick a representative state for every block
+    const std::uint32_t block_count =
+        *std::max_element(block_of.begin(), block_of.end()) + 1;
+    std::vector<StateId> representative(block_count, DFA::DEAD_STATE);
+
+    for (std::uint32_t i = 0; i < states.size(); ++i)
+      representative[block_of[i]] = states[i];
+
+    // Number blocks breadth-first, keeping the dead block at 0
+    constexpr std::uint32_t UNNUMBERED = ~std::uint32_t{0};
+    std::vector<std::uint32_t> ids(block_count, UNNUMBERED);
+    std::vector<std::uint32_t> order;
+
+    auto number = [&](std::uint32_t block)
+    {
+      if (ids[block] == UNNUMBERED)
+      {
+        ids[block] = static_cast<std::uint32_t>(order.size());
+        order.push_back(block);
+      }
+    };
+
+    number(block_of[local[DFA::DEAD_STATE]]);
+    number(block_of[local[m_dfa.get_start_state()]]);
+
+    for (std::size_t i = 1; i < order.size(); ++i)
+      for (const auto byte : m_representatives)
+        number(block_of[local[m_dfa.next_class(representative[order[i]],
+                                               byte)]]);
+
+    std::vector<StateId> transitions;
+    std::vector<std::uint8_t> accept_flags;
+    std::vector<std::vector<std::uint32_t>> accept_ids;
+
+    transitions.reserve(order.size() * m_representatives.size());
+    accept_flags.reserve(order.size());
+
+    for (const auto block : order)
+    {
+      const StateId state = representative[block];
+
+      for (const auto byte_class : m_representatives)
+        transitions.push_back(
+            ids[block_of[local[m_dfa.next_class(state, byte_class)]]]);
+
+      accept_flags.push_back(m_dfa.get_accept_flags()[state]);
+
+      if (m_dfa.has_accept_ids())
+      {
+        const auto patterns = m_dfa.get_accept_ids(state);
+        accept_ids.emplace_back(patterns.begin(), patterns.end());
+      }
+    }
+
+    DFA::ByteClassMap byte_classes;
+
+    for (std::size_t byte = 0; byte < DFA::ALPHABET_SIZE; ++byte)
+      byte_classes[byte] = m_class_merge[m_dfa.get_byte_classes()[byte]];
+
+    m_states_removed = m_dfa.get_state_count() - order.size();
+
+    return DFA(ids[block_of[local[m_dfa.get_start_state()]]], byte_classes,
+               m_representatives.size(), std::move(transitions),
+               std::move(accept_flags), accept_ids);
+  }
+
+  /**
+   * @brief Gets the number of states removed by the last minimization
+   *
+   * @return std::size_t The number of removed states
+   */
+  std::size_t Minimizer::get_states_removed() const noexcept
+  {
+    return m_states_removed;
+  }
+
+  /**
+   * @brief Merges byte classes whose transition columns are identical
+   * @details The input classes come from the leaf byte sets, which can
+   *          still tell apart bytes that every state treats alike
+   *
+   */
+  void Minimizer::compute_byte_classes()
+  {
+    std::map<std::vector<StateId>, std::uint8_t> classes;
+    std::vector<StateId> column(m_dfa.get_state_count());
+
+    m_representatives.clear();
+    m_class_merge.assign(m_dfa.get_class_count(), 0);
+
+    for (std::size_t byte_class = 0; byte_class < m_dfa.get_class_count();
+         ++byte_class)
+    {
+      for (StateId state = 0; state < column.size(); ++state)
+        column[state] = m_dfa.next_class(state, byte_class);
+
+      auto [it, inserted] = classes.try_emplace(
+          column, static_cast<std::uint8_t>(m_representatives.size()));
+
+      if (inserted)
+        m_representatives.push_back(static_cast<std::uint8_t>(byte_class));
+
+      m_class_merge[byte_class] = it->second;
+    }
+  }
+
+  /**
+   * @brief Collects the dead state and every state reachable from the start
+   *
+   * @return std::vector<StateId> The reachable states
+   */
+  std::vector<StateId> Minimizer::reachable_states() const
+  {
+    std::vector<bool> seen(m_dfa.get_state_count(), false);
+    std::vector<StateId> states = {DFA::DEAD_STATE};
+
+    seen[DFA::DEAD_STATE] = true;
+
+    if (!seen[m_dfa.get_start_state()])
+    {
+      seen[m_dfa.get_start_state()] = true;
+      states.push_back(m_dfa.get_start_state());
+    }
+
+    for (std::size_t i = 0; i < states.size(); ++i)
+      for (const auto byte : m_representatives)
+      {
+        const StateId target = m_dfa.next_class(states[i], byte);
+
+        if (!seen[target])
+        {
+          seen[target] = true;
+          states.push_back(target);
+        }
+      }
+
+    return states;
+  }
+
+  /**
+   * @brief Runs Hopcroft's refinement over the given states
+   * @details Blocks are stored as ranges of one element array. When a block
+   *          splits, the smaller half becomes the new block and is queued
+   *          for every byte class, which bounds the work by O(n k log n).
+   *
+   * @param[in] states The states to partition
+   * @return std::vector<std::uint32_t> The block of every state, indexed
+   *         like states
+   */
+  std::vector<std::uint32_t> Minimizer::refine(
+      const std::vector<StateId> &states) const
+  {
+    const std::size_t size = states.size();
+    const std::size_t class_count = m_representatives.size();
+
+    std::vector<std::uint32_t> local(m_dfa.get_state_count(), 0);
+
+    for (std::uint32_t i = 0; i < size; ++i)
+      local[states[i]] = i;
+
+    // Inverse transitions per class, in compressed sparse row form
+    std::vector<std::uint32_t> offsets(class_count * size + 1, 0);
+    std::vector<std::uint32_t> sources(class_count * size);
+
+    for (std::size_t c = 0; c < class_count; ++c)
+      for (std::uint32_t s = 0; s < size; ++s)
+        ++offsets[c * size +
+                  local[m_dfa.next_class(states[s], m_representatives[c])] +
+                  1];
+
+    for (std::size_t i = 1; i < offsets.size(); ++i)
+      offsets[i] += offsets[i - 1];
+
+    {
+      std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+
+      for (std::size_t c = 0; c < class_count; ++c)
+        for (std::uint32_t s = 0; s < size; ++s)
+          sources[fill[c * size + local[m_dfa.next_class(
+                                      states[s], m_representatives[c])]]++] =
+              s;
+    }
+
+    // Initial partition by accept flags and matching patterns
+    std::vector<std::uint32_t> elements(size);
+    std::vector<std::uint32_t> location(size);
+    std::vector<std::uint32_t> block_of(size);
+    std::vector<std::uint32_t> first;
+    std::vector<std::uint32_t> end;
+    std::vector<std::uint32_t> marked;
+
+    for (std::uint32_t i = 0; i < size; ++i)
+      elements[i] = i;
+
+    const auto &flags = m_dfa.get_accept_flags();
+
+    auto compare = [&](std::uint32_t a, std::uint32_t b)
+    {
+      if (flags[states[a]] != flags[states[b]])
+        return flags[states[a]] < flags[states[b]] ? -1 : 1;
+
+      const auto ids_a = m_dfa.get_accept_ids(states[a]);
+      const auto ids_b = m_dfa.get_accept_ids(states[b]);
+
+      if (std::ranges::equal(ids_a, ids_b))
+        return 0;
+
+      return std::ranges::lexicographical_compare(ids_a, ids_b) ? -1 : 1;
+    };
+
+    std::stable_sort(elements.begin(), elements.end(),
+                     [&](std::uint32_t a, std::uint32_t b)
+                     { return compare(a, b) < 0; });
+
+    for (std::uint32_t i = 0; i < size; ++i)
+    {
+      if (i == 0 || compare(elements[i], elements[i - 1]) != 0)
+      {
+        first.push_back(i);
+        end.push_back(i);
+        marked.push_back(0);
+      }
+
+      location[elements[i]] = i;
+      block_of[elements[i]] = static_cast<std::uint32_t>(first.size() - 1);
+      ++end.back();
+    }
+
+    // Queue every initial block but the largest one
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> worklist;
+
+    std::uint32_t largest = 0;
+
+    for (std::uint32_t b = 1; b < first.size(); ++b)
+      if (end[b] - first[b] > end[largest] - first[largest])
+        largest = b;
+
+    for (std::uint32_t b = 0; b < first.size(); ++b)
+      if (b != largest)
+        for (std::uint32_t c = 0; c < class_count; ++c)
+          worklist.emplace_back(b, c);
+
+    std::vector<std::uint32_t> splitter;
+    std::vector<std::uint32_t> touched;
+
+    while (!worklist.empty())
+    {
+      const auto [block, c] = worklist.back();
+      worklist.pop_back();
+
+      splitter.assign(elements.begin() + first[block],
+                      elements.begin() + end[block]);
+
+      // Move every predecessor to the front of its block
+      for (const auto target : splitter)
+        for (std::uint32_t i = offsets[c * size + target];
+             i < offsets[c * size + target + 1]; ++i)
+        {
+          const std::uint32_t state = sources[i];
+          const std::uint32_t b = block_of[state];
+          const std::uint32_t boundary = first[b] + marked[b];
+
+          if (location[state] < boundary)
+            continue;
+
+          const std::uint32_t other = elements[boundary];
+
+          std::swap(elements[location[state]], elements[boundary]);
+          location[other] = location[state];
+          location[state] = boundary;
+
+          if (marked[b]++ == 0)
+            touched.push_back(b);
+        }
+
+      // Split every block that is only partly marked
+      for (const auto b : touched)
+      {
+        const std::uint32_t split = first[b] + marked[b];
+        marked[b] = 0;
+
+        if (split == end[b])
+          continue;
+
+        const auto new_block = static_cast<std::uint32_t>(first.size());
+
+        if (split - first[b] <= end[b] - split)
+        {
+          first.push_back(first[b]);
+          end.push_back(split);
+          first[b] = split;
+        }
+        else
+        {
+          first.push_back(split);
+          end.push_back(end[b]);
+          end[b] = split;
+        }
+
+        marked.push_back(0);
+
+        for (std::uint32_t i = first[new_block]; i < end[new_block]; ++i)
+          block_of[elements[i]] = new_block;
+
+        // The new block is the smaller half, so it is queued for every
+        // class whether or not the old block was already waiting
+        for (std::uint32_t a = 0; a < class_count; ++a)
+          worklist.emplace_back(new_block, a);
+      }
+
+      touched.clear();
+    }
+
+    return block_of;
+  }
+} // namespace dfa
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @class Minimizer
+   * @brief Minimizes a DFA with Hopcroft's partition refinement
+   *
+   * @details Byte classes whose columns are identical in the whole table
+   *          are first merged, so refinement runs over the k remaining byte
+   *          classes in O(n k log n) time. Unreachable states
+   *          are dropped and the dead state stays at index 0.
+   */
+  class Minimizer
+  {
+  public:
+    explicit Minimizer(const DFA &dfa);
+
+    DFA minimize();
+
+    // Getters
+    [[nodiscard]] std::size_t get_states_removed() const noexcept;
+
+  private:
+    const DFA &m_dfa;
+    std::vector<std::uint8_t> m_representatives;
+    std::vector<std::uint8_t> m_class_merge;
+    std::size_t m_states_removed;
+
+    // Helper functions
+    void compute_byte_classes();
+    std::vector<StateId> reachable_states() const;
+    std::vector<std::uint32_t> refine(const std::vector<StateId> &states) const;
+  };
+} // namespace dfa
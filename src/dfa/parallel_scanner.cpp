@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <numeric>
+#include "parallel_scanner.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Number of bytes every speculative walk advances between two
+     *        attempts to merge walks
+     *
+     */
+    constexpr std::size_t MERGE_INTERVAL = 16;
+  } // namespace
+
+  /**
+   * @brief Construct a new ParallelScanner:: ParallelScanner object
+   *
+   * @param[in] dfa The automaton to run, which must outlive the scanner
+   * @param[in] pool The pool running the chunks
+   * @param[in] options The chunking options
+   */
+  ParallelScanner::ParallelScanner(const DFA &dfa,
+                                   thread_management::ThreadPool &pool,
+                                   ParallelScanOptions options)
+      : m_dfa(dfa), m_pool(pool), m_options(options)
+  {
+    m_options.chunk_size = std::max<std::size_t>(m_options.chunk_size, 1);
+  }
+
+  /**
+   * @brief Scans a whole input
+   *
+   * @param[in] input The input, which must stay alive during the call
+   * @return ScanResult The match ends in order and the final state
+   */
+  ScanResult ParallelScanner::scan(std::string_view input) const
+  {
+    ScanResult result;
+    const StateId start = m_dfa.get_start_state();
+
+    if (input.empty())
+    {
+      result.final_state = start;
+      result.accepted = m_dfa.is_accepting_at_eof(start);
+
+      if (result.accepted)
+        result.match_ends.push_back(0);
+
+      return result;
+    }
+
+    const std::size_t chunk_size = m_options.chunk_size;
+    const std::size_t chunk_count =
+        (input.size() + chunk_size - 1) / chunk_size;
+    std::vector<ChunkResult> chunks(chunk_count);
+
+    m_pool.parallel_for(
+        0, chunk_count, 1, [&](std::size_t first, std::size_t last)
+        {
+          for (std::size_t k = first; k < last; ++k)
+            chunks[k] = run_chunk(input, k * chunk_size,
+                                  std::min(input.size(), (k + 1) * chunk_size),
+                                  k == 0);
+        });
+
+    // Compose the chunk mappings to find the state entering every chunk
+    std::vector<StateId> entry(chunk_count);
+    StateId state = start;
+
+    for (std::size_t k = 0; k < chunk_count; ++k)
+    {
+      entry[k] = state;
+      const auto &end_states = chunks[k].end_states;
+
+      if (state != DFA::DEAD_STATE)
+        state = end_states.size() == 1 ? end_states.front()
+                                       : end_states[state];
+    }
+
+    // Rescan the bytes each chunk read before its walks merged
+    std::vector<std::vector<std::uint64_t>> prefixes(chunk_count);
+
+    m_pool.parallel_for(
+        1, chunk_count, 1, [&](std::size_t first, std::size_t last)
+        {
+          for (std::size_t k = first; k < last; ++k)
+            if (chunks[k].converged > k * chunk_size &&
+                entry[k] != DFA::DEAD_STATE)
+              walk(input, k * chunk_size, chunks[k].converged, entry[k],
+                   prefixes[k]);
+        });
+
+    if (m_dfa.is_accepting(start))
+      result.match_ends.push_back(0);
+
+    for (std::size_t k = 0; k < chunk_count; ++k)
+    {
+      // The dead state never leaves, so no later chunk can match
+      if (entry[k] == DFA::DEAD_STATE)
+        break;
+
+      result.match_ends.insert(result.match_ends.end(), prefixes[k].begin(),
+                               prefixes[k].end());
+      result.match_ends.insert(result.match_ends.end(),
+                               chunks[k].match_ends.begin(),
+                               chunks[k].match_ends.end());
+    }
+
+    result.final_state = state;
+    result.accepted = m_dfa.is_accepting_at_eof(state);
+
+    if (result.accepted && !m_dfa.is_accepting(state))
+      result.match_ends.push_back(input.size());
+
+    return result;
+  }
+
+  /**
+   * @brief Runs one chunk from every state it may be entered in
+   * @details The dead state is left out: a chunk entered dead stays dead
+   *
+   * @param[in] input The whole input
+   * @param[in] begin The first byte of the chunk
+   * @param[in] end One past the last byte of the chunk
+   * @param[in] first Whether this is the first chunk, entered in the start
+   *            state
+   * @return ChunkResult The state mapping and matches of the chunk
+   */
+  ParallelScanner::ChunkResult ParallelScanner::run_chunk(
+      std::string_view input, std::size_t begin, std::size_t end,
+      bool first) const
+  {
+    ChunkResult result;
+
+    if (first)
+    {
+      result.converged = begin;
+      result.end_states.push_back(walk(input, begin, end,
+                                       m_dfa.get_start_state(),
+                                       result.match_ends));
+      return result;
+    }
+
+    const std::size_t state_count = m_dfa.get_state_count();
+    constexpr std::uint32_t UNSET = ~std::uint32_t{0};
+
+    std::vector<StateId> lanes(state_count - 1);
+    std::vector<std::uint32_t> lane_of(state_count - 1);
+    std::vector<std::uint32_t> index_of(state_count, UNSET);
+    std::vector<std::uint32_t> remap;
+    std::vector<StateId> merged;
+
+    std::iota(lanes.begin(), lanes.end(), StateId{1});
+    std::iota(lane_of.begin(), lane_of.end(), std::uint32_t{0});
+
+    if (lanes.empty())
+    {
+      result.converged = begin;
+      result.end_states.push_back(DFA::DEAD_STATE);
+      return result;
+    }
+
+    std::size_t position = begin;
+
+    while (lanes.size() > 1 && position < end)
+    {
+      const std::size_t stop = std::min(end, position + MERGE_INTERVAL);
+
+      for (auto &lane : lanes)
+        for (std::size_t i = position; i < stop; ++i)
+          lane = m_dfa.next(lane, static_cast<std::uint8_t>(input[i]));
+
+      position = stop;
+
+      // Merge the walks that reached the same state
+      merged.clear();
+      remap.resize(lanes.size());
+
+      for (std::size_t i = 0; i < lanes.size(); ++i)
+      {
+        if (index_of[lanes[i]] == UNSET)
+        {
+          index_of[lanes[i]] = static_cast<std::uint32_t>(merged.size());
+          merged.push_back(lanes[i]);
+        }
+
+        remap[i] = index_of[lanes[i]];
+      }
+
+      for (const auto lane : merged)
+        index_of[lane] = UNSET;
+
+      for (auto &lane : lane_of)
+        lane = remap[lane];
+
+      lanes.swap(merged);
+    }
+
+    if (lanes.size() == 1)
+    {
+      result.converged = position;
+      result.end_states.push_back(
+          walk(input, position, end, lanes.front(), result.match_ends));
+      return result;
+    }
+
+    result.converged = end;
+    result.end_states.resize(state_count, DFA::DEAD_STATE);
+
+    for (StateId state = 1; state < state_count; ++state)
+      result.end_states[state] = lanes[lane_of[state - 1]];
+
+    return result;
+  }
+
+  /**
+   * @brief Runs the DFA over a range of the input
+   *
+   * @param[in] input The whole input
+   * @param[in] begin The first byte to read
+   * @param[in] end One past the last byte to read
+   * @param[in] state The state before begin
+   * @param[out] match_ends Receives the offsets in (begin, end] at which the
+   *             DFA accepts
+   * @return StateId The state after end
+   */
+  StateId ParallelScanner::walk(std::string_view input, std::size_t begin,
+                                std::size_t end, StateId state,
+                                std::vector<std::uint64_t> &match_ends) const
+  {
+    // Local copies of the tables, which match_ends cannot alias
+    const StateId *transitions = m_dfa.get_transitions().data();
+    const std::uint8_t *accept_flags = m_dfa.get_accept_flags().data();
+    const DFA::ByteClassMap &byte_classes = m_dfa.get_byte_classes();
+    const std::size_t class_count = m_dfa.get_class_count();
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      state = transitions[state * class_count +
+                          byte_classes[static_cast<std::uint8_t>(input[i])]];
+
+      if (accept_flags[state] & ACCEPT)
+        match_ends.push_back(i + 1);
+    }
+
+    return state;
+  }
+} // namespace dfa
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../threads/thread_pool.h"
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @struct ParallelScanOptions
+   * @brief Options controlling how a ParallelScanner splits its input
+   *
+   */
+  struct ParallelScanOptions
+  {
+    std::size_t chunk_size = std::size_t{1} << 20;
+  };
+
+  /**
+   * @struct ScanResult
+   * @brief Outcome of scanning a whole input
+   *
+   * @details match_ends holds, in increasing order, every offset at which
+   *          the DFA accepts, the same offsets a StreamMatcher reports for
+   *          the input fed in one piece and then finished.
+   */
+  struct ScanResult
+  {
+    std::vector<std::uint64_t> match_ends;
+    StateId final_state = DFA::DEAD_STATE;
+    bool accepted = false;
+  };
+
+  /**
+   * @class ParallelScanner
+   * @brief Scans one large input on several threads
+   *
+   * @details The input is split into chunks. Every chunk but the first is
+   *          run speculatively from all DFA states at once, merging walks
+   *          that reach the same state, which usually leaves a single walk
+   *          after a few bytes. The per-chunk state mappings are then
+   *          composed in order to find the true state at every chunk
+   *          boundary, and only the bytes read before a chunk's walks
+   *          merged are scanned again to report their matches.
+   */
+  class ParallelScanner
+  {
+  public:
+    ParallelScanner(const DFA &dfa, thread_management::ThreadPool &pool,
+                    ParallelScanOptions options = {});
+
+    ScanResult scan(std::string_view input) const;
+
+  private:
+    /**
+     * @struct ChunkResult
+     * @brief Speculative run of one chunk
+     *
+     * @details Before converged, the state reached depends on the entry
+     *          state and end_states maps each entry state to it. From
+     *          converged on, all walks agree and match_ends are final,
+     *          unless the chunk is entered in the dead state.
+     */
+    struct ChunkResult
+    {
+      std::size_t converged = 0;
+      std::vector<StateId> end_states;
+      std::vector<std::uint64_t> match_ends;
+    };
+
+    const DFA &m_dfa;
+    thread_management::ThreadPool &m_pool;
+    ParallelScanOptions m_options;
+
+    // Helper functions
+    ChunkResult run_chunk(std::string_view input, std::size_t begin,
+                          std::size_t end, bool first) const;
+    StateId walk(std::string_view input, std::size_t begin, std::size_t end,
+                 StateId state, std::vector<std::uint64_t> &match_ends) const;
+  };
+} // namespace dfa
@@ -0,0 +1,203 @@
+#include <utility>
+#include "pike_vm.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @class SparseSet
+     * @brief Set of states with constant time insert, lookup and clear,
+     *        iterated in insertion order
+     *
+     */
+    class SparseSet
+    {
+    public:
+      /**
+       * @brief Construct a new Sparse Set:: Sparse Set object
+       *
+       * @param[in] capacity One past the largest state to hold
+       */
+      explicit SparseSet(std::size_t capacity)
+          : m_dense(capacity), m_sparse(capacity)
+      {
+      }
+
+      /**
+       * @brief Inserts a state unless it is already in the set
+       *
+       * @param[in] state The state to insert
+       */
+      void insert(std::uint32_t state) noexcept
+      {
+        if (contains(state))
+          return;
+
+        m_sparse[state] = m_size;
+        m_dense[m_size++] = state;
+      }
+
+      [[nodiscard]] bool contains(std::uint32_t state) const noexcept
+      {
+        const std::uint32_t index = m_sparse[state];
+        return index < m_size && m_dense[index] == state;
+      }
+
+      void clear() noexcept
+      {
+        m_size = 0;
+      }
+
+      [[nodiscard]] bool empty() const noexcept
+      {
+        return m_size == 0;
+      }
+
+      [[nodiscard]] const std::uint32_t *begin() const noexcept
+      {
+        return m_dense.data();
+      }
+
+      [[nodiscard]] const std::uint32_t *end() const noexcept
+      {
+        return m_dense.data() + m_size;
+      }
+
+    private:
+      std::vector<std::uint32_t> m_dense;
+      std::vector<std::uint32_t> m_sparse;
+      std::uint32_t m_size = 0;
+    };
+
+    /**
+     * @brief Adds a state and every state its epsilon moves reach
+     *
+     * @param[in] nfa The automaton
+     * @param[in,out] set The set to add to
+     * @param[in,out] stack Scratch space, empty on return
+     * @param[in] state The state to add
+     * @param[in] at_start Whether no input was consumed, so '^' passes
+     * @param[in] at_end Whether the input is over, so '$' passes
+     */
+    void add_closure(const ThompsonNFA &nfa, SparseSet &set,
+                     std::vector<std::uint32_t> &stack, std::uint32_t state,
+                     bool at_start, bool at_end)
+    {
+      stack.push_back(state);
+
+      while (!stack.empty())
+      {
+        const std::uint32_t top = stack.back();
+        stack.pop_back();
+
+        if (set.contains(top))
+          continue;
+
+        set.insert(top);
+
+        switch (nfa.kinds[top])
+        {
+        case NFAStateKind::SPLIT:
+          stack.push_back(nfa.out1[top]);
+          stack.push_back(nfa.out[top]);
+          break;
+
+        case NFAStateKind::EPSILON:
+          stack.push_back(nfa.out[top]);
+          break;
+
+        case NFAStateKind::START_ANCHOR:
+          if (at_start)
+            stack.push_back(nfa.out[top]);
+          break;
+
+        case NFAStateKind::END_ANCHOR:
+          if (at_end)
+            stack.push_back(nfa.out[top]);
+          break;
+
+        default:
+          break;
+        }
+      }
+    }
+  } // namespace
+
+  /**
+   * @brief Construct a new PikeVM:: PikeVM object
+   *
+   * @param[in] nfa The automaton to simulate
+   */
+  PikeVM::PikeVM(ThompsonNFA nfa) : m_nfa(std::move(nfa))
+  {
+  }
+
+  /**
+   * @brief Checks whether the automaton matches the whole input
+   * @details States reached through a '$' are kept in the set unpassed;
+   *          once the input is consumed a last closure passes them
+   *
+   * @param[in] input The input to match
+   * @return true If the input matches
+   */
+  bool PikeVM::matches(std::string_view input) const
+  {
+    const std::size_t size = m_nfa.size();
+    SparseSet current(size);
+    SparseSet next(size);
+    std::vector<std::uint32_t> stack;
+
+    add_closure(m_nfa, current, stack, m_nfa.start, true, false);
+
+    for (const char character : input)
+    {
+      const auto byte = static_cast<std::uint8_t>(character);
+      next.clear();
+
+      for (const auto state : current)
+        if (m_nfa.kinds[state] == NFAStateKind::SYMBOL &&
+            m_nfa.symbols[state].test(byte))
+          add_closure(m_nfa, next, stack, m_nfa.out[state], false, false);
+
+      if (next.empty())
+        return false;
+
+      std::swap(current, next);
+    }
+
+    next.clear();
+
+    for (const auto state : current)
+      add_closure(m_nfa, next, stack, state, input.empty(), true);
+
+    for (const auto state : next)
+      if (m_nfa.kinds[state] == NFAStateKind::MATCH)
+        return true;
+
+    return false;
+  }
+
+  /**
+   * @brief Gets the number of states, including the match state
+   *
+   * @return std::size_t The number of states
+   */
+  std::size_t PikeVM::get_state_count() const noexcept
+  {
+    return m_nfa.size();
+  }
+
+  /**
+   * @brief Gets the heap memory held by the automaton
+   *
+   * @return std::size_t The number of bytes
+   */
+  std::size_t PikeVM::memory_usage() const noexcept
+  {
+    return m_nfa.kinds.capacity() +
+           m_nfa.symbols.capacity() * sizeof(ByteSet) +
+           (m_nfa.out.capacity() + m_nfa.out1.capacity()) *
+               sizeof(std::uint32_t);
+  }
+} // namespace dfa
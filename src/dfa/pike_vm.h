@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "thompson_nfa.h"
+
+namespace dfa
+{
+  /**
+   * @class PikeVM
+   * @brief Matches by simulating a Thompson NFA directly, without
+   *        determinizing it
+   *
+   * @details Like Pike's VM, the simulation keeps every live state in a
+   *          sparse set and advances all of them in lockstep, one input
+   *          byte at a time, following epsilon moves as it adds them. Each
+   *          state is live at most once per byte, so a scan takes time
+   *          linear in the input times the automaton size. The automaton
+   *          grows linearly with the pattern, unlike the followpos sets of
+   *          the position automaton, so the VM is the fallback for
+   *          patterns whose DFA exceeds its budget. matches() keeps its
+   *          state on the stack, so one PikeVM may be shared between
+   *          threads.
+   */
+  class PikeVM
+  {
+  public:
+    explicit PikeVM(ThompsonNFA nfa);
+
+    [[nodiscard]] bool matches(std::string_view input) const;
+
+    // Getters
+    [[nodiscard]] std::size_t get_state_count() const noexcept;
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+  private:
+    ThompsonNFA m_nfa;
+  };
+} // namespace dfa
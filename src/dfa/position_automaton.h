@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "byte_set.h"
+#include "position_set.h"
+
+namespace dfa
+{
+  /**
+   * @brief The PositionKind enum tells how a leaf position consumes input
+   *
+   * @details
+   *       - SYMBOL: Consumes one byte out of its byte set.
+   *       - START_ANCHOR: Consumes nothing, only passable before any input.
+   *       - END_ANCHOR: Consumes nothing, only passable at the end of input.
+   *       - END_MARKER: The augmented end marker; reaching it accepts.
+   */
+  enum class PositionKind : std::uint8_t
+  {
+    SYMBOL,
+    START_ANCHOR,
+    END_ANCHOR,
+    END_MARKER
+  };
+
+  /**
+   * @struct PositionAutomaton
+   * @brief Result of the followpos analysis of an augmented regex AST
+   *
+   * @details Position i consumes a byte of symbols[i] and may be followed by
+   *          any position of follow[i]. The automaton starts in first and
+   *          accepts once an end marker is reached. A pattern set has one
+   *          end marker per pattern, end_markers[id] being the marker of
+   *          pattern id, in increasing position order.
+   */
+  struct PositionAutomaton
+  {
+    std::vector<ByteSet> symbols;
+    std::vector<PositionKind> kinds;
+    std::vector<PositionSet> follow;
+    PositionSet first;
+    std::vector<std::uint32_t> end_markers;
+
+    /**
+     * @brief Gets the number of positions, including the end marker
+     *
+     * @return std::size_t The number of positions
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return kinds.size();
+    }
+
+    /**
+     * @brief Gets the pattern an end marker belongs to
+     *
+     * @param[in] marker The position of the end marker
+     * @return std::uint32_t The pattern id
+     */
+    [[nodiscard]] std::uint32_t pattern_of(std::uint32_t marker) const
+    {
+      return static_cast<std::uint32_t>(
+          std::lower_bound(end_markers.begin(), end_markers.end(), marker) -
+          end_markers.begin());
+    }
+  };
+} // namespace dfa
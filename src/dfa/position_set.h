@@ -0,0 +1,264 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dfa
+{
+  /**
+   * @class PositionSet
+   * @brief Compact set of leaf positions stored as a growable bitset
+   *
+   * @details The bitset starts at the word of the lowest position ever
+   *          inserted, so a few positions late in a large automaton take a
+   *          few words rather than one bit per earlier position. Sets
+   *          compare and hash equal regardless of leading and trailing zero
+   *          words, so sets of different extents can share one intern
+   *          table.
+   */
+  class PositionSet
+  {
+  public:
+    PositionSet() = default;
+
+    /**
+     * @brief Construct a new Position Set:: Position Set object
+     *
+     * @param[in] capacity Number of positions to reserve room for
+     */
+    explicit PositionSet(std::size_t capacity)
+        : m_words((capacity + 63) / 64, 0)
+    {
+    }
+
+    /**
+     * @brief Inserts a position into the set
+     *
+     * @param[in] position The position to insert
+     */
+    void insert(std::uint32_t position)
+    {
+      const std::size_t word = position / 64;
+
+      extend(word, word + 1);
+      m_words[word - m_base] |= std::uint64_t{1} << (position % 64);
+    }
+
+    /**
+     * @brief Removes a position from the set
+     *
+     * @param[in] position The position to remove
+     */
+    void erase(std::uint32_t position) noexcept
+    {
+      const std::size_t word = position / 64;
+
+      if (word >= m_base && word - m_base < m_words.size())
+        m_words[word - m_base] &= ~(std::uint64_t{1} << (position % 64));
+    }
+
+    /**
+     * @brief Checks whether the set contains a position
+     *
+     * @param[in] position The position to look up
+     * @return true If the position is in the set
+     */
+    [[nodiscard]] bool contains(std::uint32_t position) const noexcept
+    {
+      const std::size_t word = position / 64;
+
+      return word >= m_base && word - m_base < m_words.size() &&
+             (m_words[word - m_base] >> (position % 64)) & 1;
+    }
+
+    /**
+     * @brief Adds every position of another set to this one
+     *
+     * @param[in] other The set to merge
+     */
+    void merge(const PositionSet &other)
+    {
+      const auto [first, last] = other.significant_range();
+
+      if (first == last)
+        return;
+
+      extend(other.m_base + first, other.m_base + last);
+
+      const std::size_t shift = other.m_base - m_base;
+
+      for (std::size_t i = first; i < last; ++i)
+        m_words[shift + i] |= other.m_words[i];
+    }
+
+    /**
+     * @brief Checks whether the set has no positions
+     *
+     * @return true If the set is empty
+     */
+    [[nodiscard]] bool empty() const noexcept
+    {
+      for (const auto word : m_words)
+        if (word != 0)
+          return false;
+
+      return true;
+    }
+
+    /**
+     * @brief Counts the positions in the set
+     *
+     * @return std::size_t The number of positions
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      std::size_t count = 0;
+
+      for (const auto word : m_words)
+        count += std::popcount(word);
+
+      return count;
+    }
+
+    /**
+     * @brief Gets the heap memory held by the set
+     *
+     * @return std::size_t The number of bytes allocated for the bitset
+     */
+    [[nodiscard]] std::size_t memory_usage() const noexcept
+    {
+      return m_words.capacity() * sizeof(std::uint64_t);
+    }
+
+    /**
+     * @brief Calls a function for every position in ascending order
+     *
+     * @tparam Function Callable taking a std::uint32_t
+     * @param[in] function The function to call
+     */
+    template <typename Function>
+    void for_each(Function &&function) const
+    {
+      for (std::size_t i = 0; i < m_words.size(); ++i)
+      {
+        std::uint64_t word = m_words[i];
+
+        while (word != 0)
+        {
+          const auto bit = static_cast<std::uint32_t>(std::countr_zero(word));
+
+          function(static_cast<std::uint32_t>((m_base + i) * 64 + bit));
+          word &= word - 1;
+        }
+      }
+    }
+
+    /**
+     * @brief Computes a hash of the positions in the set
+     *
+     * @return std::size_t The hash
+     */
+    [[nodiscard]] std::size_t hash() const noexcept
+    {
+      const auto [first, last] = significant_range();
+      std::uint64_t hash = 0xcbf29ce484222325ULL ^ (m_base + first);
+
+      for (std::size_t i = first; i < last; ++i)
+      {
+        hash ^= m_words[i];
+        hash *= 0x100000001b3ULL;
+        hash ^= hash >> 29;
+      }
+
+      return static_cast<std::size_t>(hash);
+    }
+
+    /**
+     * @brief Compares two sets by their positions
+     *
+     * @param[in] other The set to compare with
+     * @return true If both sets hold the same positions
+     */
+    bool operator==(const PositionSet &other) const noexcept
+    {
+      const auto [first, last] = significant_range();
+      const auto [other_first, other_last] = other.significant_range();
+
+      if (last - first != other_last - other_first ||
+          (first != last && m_base + first != other.m_base + other_first))
+        return false;
+
+      for (std::size_t i = 0; i < last - first; ++i)
+        if (m_words[first + i] != other.m_words[other_first + i])
+          return false;
+
+      return true;
+    }
+
+  private:
+    std::size_t m_base = 0;
+    std::vector<std::uint64_t> m_words;
+
+    // Helper functions
+    /**
+     * @brief Grows the bitset to cover a range of words
+     *
+     * @param[in] first The first word to cover
+     * @param[in] last One past the last word to cover
+     */
+    void extend(std::size_t first, std::size_t last)
+    {
+      if (m_words.empty())
+      {
+        m_base = first;
+        m_words.assign(last - first, 0);
+        return;
+      }
+
+      if (first < m_base)
+      {
+        m_words.insert(m_words.begin(), m_base - first, 0);
+        m_base = first;
+      }
+
+      if (last - m_base > m_words.size())
+        m_words.resize(last - m_base, 0);
+    }
+
+    /**
+     * @brief Gets the indices of the first and one past the last non-zero
+     *        word
+     *
+     * @return std::pair<std::size_t, std::size_t> The range, empty if the
+     *         set is empty
+     */
+    std::pair<std::size_t, std::size_t> significant_range() const noexcept
+    {
+      std::size_t first = 0;
+      std::size_t last = m_words.size();
+
+      while (last > 0 && m_words[last - 1] == 0)
+        --last;
+
+      while (first < last && m_words[first] == 0)
+        ++first;
+
+      return {first, last};
+    }
+  };
+
+  /**
+   * @struct PositionSetHash
+   * @brief Hash functor for using PositionSet as an unordered container key
+   *
+   */
+  struct PositionSetHash
+  {
+    std::size_t operator()(const PositionSet &set) const noexcept
+    {
+      return set.hash();
+    }
+  };
+} // namespace dfa
@@ -0,0 +1,636 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define REGEX_DFA_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#include "dfa_builder.h"
+#include "prefilter.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Longest prefix kept, enough to make candidates rare
+     *
+     */
+    constexpr std::size_t MAX_PREFIX = 64;
+
+    /**
+     * @class PrefixVisitor
+     * @brief Computes the literal every match of a subtree starts with
+     *
+     * @details The result is exact when the subtree matches that literal
+     *          and nothing else, so a following sibling can extend it.
+     *          Zero-width anchors are exact empty literals.
+     */
+    class PrefixVisitor : public ast::AstVisitor
+    {
+    public:
+      /**
+       * @struct Prefix
+       * @brief A required prefix and whether it is the whole match
+       *
+       */
+      struct Prefix
+      {
+        std::string literal;
+        bool exact = false;
+      };
+
+      /**
+       * @brief Construct a new Prefix Visitor:: Prefix Visitor object
+       *
+       * @param[in] tree The AST to analyze
+       */
+      explicit PrefixVisitor(const ast::Arena &tree) : m_tree(tree) {}
+
+      /**
+       * @brief Computes the prefix of a subtree
+       *
+       * @param[in] node The root of the subtree
+       * @return Prefix The required prefix
+       */
+      Prefix visit(ast::NodeIndex node)
+      {
+        m_tree.accept(node, *this);
+        return std::move(m_result);
+      }
+
+      void visit_literal_node(const ast::LiteralNode &node) override
+      {
+        m_result = {std::string(node.value), true};
+      }
+
+      void visit_metacharacter_node(
+          const ast::MetacharacterNode &node) override
+      {
+        if (node.character == '.')
+          m_result = {};
+
+        else if (node.character == '^' || node.character == '$')
+          m_result = {"", true};
+
+        else
+          m_result = {std::string(1, node.character), true};
+      }
+
+      void visit_character_class_node(
+          const ast::CharacterClassNode &node) override
+      {
+        single_byte(character_class_bytes(node.value));
+      }
+
+      void visit_grouping_node(const ast::GroupingNode &node) override
+      {
+        Prefix prefix{"", true};
+
+        for (const ast::NodeIndex child : node.children)
+        {
+          const Prefix next = visit(child);
+
+          prefix.literal += next.literal;
+
+          if (!next.exact || prefix.literal.size() >= MAX_PREFIX)
+          {
+            prefix.exact = false;
+            break;
+          }
+        }
+
+        m_result = std::move(prefix);
+      }
+
+      void visit_quantifier_node(const ast::QuantifierNode &node) override
+      {
+        if (node.min_occurrences == 0)
+        {
+          m_result = {};
+          return;
+        }
+
+        Prefix child = visit(node.child);
+
+        if (!child.exact || child.literal.empty())
+        {
+          m_result = std::move(child);
+          return;
+        }
+
+        Prefix prefix{"", node.min_occurrences == node.max_occurrences};
+
+        for (std::uint32_t i = 0; i < node.min_occurrences &&
+                                 prefix.literal.size() < MAX_PREFIX;
+             ++i)
+          prefix.literal += child.literal;
+
+        if (prefix.literal.size() >= MAX_PREFIX)
+          prefix.exact = false;
+
+        m_result = std::move(prefix);
+      }
+
+      void visit_anchor_node(const ast::AnchorNode &) override
+      {
+        m_result = {"", true};
+      }
+
+      void visit_escape_sequence_node(
+          const ast::EscapeSequenceNode &node) override
+      {
+        single_byte(escape_bytes(node.character));
+      }
+
+      void visit_wildcard_node(const ast::WildcardNode &) override
+      {
+        m_result = {};
+      }
+
+      void visit_alternation_node(const ast::AlternationNode &node) override
+      {
+        bool first = true;
+        Prefix prefix;
+
+        for (const ast::NodeIndex child : node.children)
+        {
+          Prefix branch = visit(child);
+
+          if (first)
+          {
+            prefix = std::move(branch);
+            first = false;
+            continue;
+          }
+
+          const auto mismatch = std::mismatch(
+              prefix.literal.begin(), prefix.literal.end(),
+              branch.literal.begin(), branch.literal.end());
+
+          prefix.exact = prefix.exact && branch.exact &&
+                         prefix.literal == branch.literal;
+          prefix.literal.erase(mismatch.first, prefix.literal.end());
+        }
+
+        m_result = std::move(prefix);
+      }
+
+      void visit_boundary_node(const ast::BoundaryNode &) override
+      {
+        m_result = {};
+      }
+
+      void visit_modifier_node(const ast::ModifierNode &) override
+      {
+        m_result = {};
+      }
+
+      void visit_invalid_node(const ast::InvalidNode &) override
+      {
+        m_result = {};
+      }
+
+      void visit_end_of_input_node(const ast::EndOfInputNode &) override
+      {
+        m_result = {"", true};
+      }
+
+    private:
+      const ast::Arena &m_tree;
+      Prefix m_result;
+
+      /**
+       * @brief Sets the result for a set of bytes, exact if it has one byte
+       *
+       * @param[in] bytes The bytes the node matches
+       */
+      void single_byte(const ByteSet &bytes)
+      {
+        m_result = {};
+
+        if (bytes.count() != 1)
+          return;
+
+        for (std::size_t byte = 0; byte < bytes.size(); ++byte)
+          if (bytes.test(byte))
+            m_result = {std::string(1, static_cast<char>(byte)), true};
+      }
+    };
+
+#ifdef REGEX_DFA_X86_SIMD
+    /**
+     * @brief Finds the prefix by comparing its first and last bytes against
+     *        16 offsets at a time, verifying each candidate
+     *
+     * @param[in] text The text to scan
+     * @param[in] from The first position to consider
+     * @param[in] prefix The literal, at least two bytes long
+     * @return std::size_t The position of the prefix, or npos
+     */
+    std::size_t find_literal_sse2(std::string_view text, std::size_t from,
+                                  std::string_view prefix) noexcept
+    {
+      const __m128i first = _mm_set1_epi8(prefix.front());
+      const __m128i last = _mm_set1_epi8(prefix.back());
+      const std::size_t tail = prefix.size() - 1;
+      std::size_t index = from;
+
+      while (index + tail + 16 <= text.size())
+      {
+        const __m128i head_bytes = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(text.data() + index));
+        const __m128i tail_bytes = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(text.data() + index + tail));
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(head_bytes, first),
+                          _mm_cmpeq_epi8(tail_bytes, last))));
+
+        while (mask != 0)
+        {
+          const std::size_t candidate = index + std::countr_zero(mask);
+
+          if (std::memcmp(text.data() + candidate + 1, prefix.data() + 1,
+                          tail - 1) == 0)
+            return candidate;
+
+          mask &= mask - 1;
+        }
+
+        index += 16;
+      }
+
+      return text.find(prefix, index);
+    }
+
+    /**
+     * @brief AVX2 version of find_literal_sse2, 32 offsets at a time
+     *
+     * @param[in] text The text to scan
+     * @param[in] from The first position to consider
+     * @param[in] prefix The literal, at least two bytes long
+     * @return std::size_t The position of the prefix, or npos
+     */
+    __attribute__((target("avx2"))) std::size_t
+    find_literal_avx2(std::string_view text, std::size_t from,
+                      std::string_view prefix) noexcept
+    {
+      const __m256i first = _mm256_set1_epi8(prefix.front());
+      const __m256i last = _mm256_set1_epi8(prefix.back());
+      const std::size_t tail = prefix.size() - 1;
+      std::size_t index = from;
+
+      while (index + tail + 32 <= text.size())
+      {
+        const __m256i head_bytes = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(text.data() + index));
+        const __m256i tail_bytes = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(text.data() + index + tail));
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(head_bytes, first),
+                             _mm256_cmpeq_epi8(tail_bytes, last))));
+
+        while (mask != 0)
+        {
+          const std::size_t candidate = index + std::countr_zero(mask);
+
+          if (std::memcmp(text.data() + candidate + 1, prefix.data() + 1,
+                          tail - 1) == 0)
+            return candidate;
+
+          mask &= mask - 1;
+        }
+
+        index += 32;
+      }
+
+      return text.find(prefix, index);
+    }
+
+    /**
+     * @brief Skips 16 bytes at a time until one of up to three bytes shows
+     *        up
+     *
+     * @param[in] text The text to scan
+     * @param[in] from The first position to consider
+     * @param[in] bytes The bytes to look for
+     * @param[in] count How many of bytes are used
+     * @return std::size_t The position of the first hit, or where the
+     *         vector loop stopped
+     */
+    std::size_t find_bytes_sse2(std::string_view text, std::size_t from,
+                                const std::array<std::uint8_t, 3> &bytes,
+                                std::size_t count) noexcept
+    {
+      const __m128i first = _mm_set1_epi8(static_cast<char>(bytes[0]));
+      const __m128i second = _mm_set1_epi8(static_cast<char>(bytes[1]));
+      const __m128i third = _mm_set1_epi8(static_cast<char>(bytes[2]));
+      std::size_t index = from;
+
+      for (; index + 16 <= text.size(); index += 16)
+      {
+        const __m128i block = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(text.data() + index));
+        __m128i hits = _mm_cmpeq_epi8(block, first);
+
+        if (count > 1)
+          hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, second));
+
+        if (count > 2)
+          hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, third));
+
+        if (const int mask = _mm_movemask_epi8(hits); mask != 0)
+          return index + std::countr_zero(static_cast<std::uint32_t>(mask));
+      }
+
+      return index;
+    }
+
+    /**
+     * @brief AVX2 version of find_bytes_sse2, 32 bytes at a time
+     *
+     * @param[in] text The text to scan
+     * @param[in] from The first position to consider
+     * @param[in] bytes The bytes to look for
+     * @param[in] count How many of bytes are used
+     * @return std::size_t The position of the first hit, or where the
+     *         vector loop stopped
+     */
+    __attribute__((target("avx2"))) std::size_t
+    find_bytes_avx2(std::string_view text, std::size_t from,
+                    const std::array<std::uint8_t, 3> &bytes,
+                    std::size_t count) noexcept
+    {
+      const __m256i first = _mm256_set1_epi8(static_cast<char>(bytes[0]));
+      const __m256i second = _mm256_set1_epi8(static_cast<char>(bytes[1]));
+      const __m256i third = _mm256_set1_epi8(static_cast<char>(bytes[2]));
+      std::size_t index = from;
+
+      for (; index + 32 <= text.size(); index += 32)
+      {
+        const __m256i block = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(text.data() + index));
+        __m256i hits = _mm256_cmpeq_epi8(block, first);
+
+        if (count > 1)
+          hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, second));
+
+        if (count > 2)
+          hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, third));
+
+        if (const int mask = _mm256_movemask_epi8(hits); mask != 0)
+          return index + std::countr_zero(static_cast<std::uint32_t>(mask));
+      }
+
+      return index;
+    }
+#endif // REGEX_DFA_X86_SIMD
+  } // namespace
+
+  /**
+   * @brief Derives the prefilter of a pattern
+   * @details A required literal prefix of two or more bytes is preferred;
+   *          otherwise the bytes the start state can consume are used. A
+   *          pattern that can match the empty string or starts with '$' gets
+   *          no prefilter, since a match may start anywhere.
+   *
+   * @param[in] tree The AST of the pattern
+   * @param[in] automaton The followpos analysis of the same AST
+   * @return Prefilter The prefilter
+   */
+  Prefilter Prefilter::build(const ast::Arena &tree,
+                             const PositionAutomaton &automaton)
+  {
+    const PositionSet start = DFABuilder(automaton).start_set();
+    ByteSet first_bytes;
+    bool consumes = true;
+
+    start.for_each([&](std::uint32_t position)
+                   {
+      if (automaton.kinds[position] != PositionKind::SYMBOL)
+        consumes = false;
+
+      first_bytes |= automaton.symbols[position]; });
+
+    if (!consumes)
+      return Prefilter();
+
+    const auto prefix = PrefixVisitor(tree).visit(tree.get_root());
+
+    if (prefix.literal.size() >= 2)
+      return from_literal(prefix.literal);
+
+    return from_bytes(first_bytes);
+  }
+
+  /**
+   * @brief Creates a prefilter for matches starting with a literal
+   *
+   * @param[in] prefix The literal
+   * @return Prefilter The prefilter
+   */
+  Prefilter Prefilter::from_literal(std::string_view prefix)
+  {
+    if (prefix.size() < 2)
+    {
+      ByteSet bytes;
+
+      if (prefix.empty())
+        bytes.set();
+
+      else
+        bytes.set(static_cast<unsigned char>(prefix.front()));
+
+      return from_bytes(bytes);
+    }
+
+    Prefilter prefilter;
+
+    prefilter.m_kind = Kind::LITERAL;
+    prefilter.m_prefix = prefix;
+
+    return prefilter;
+  }
+
+  /**
+   * @brief Creates a prefilter for matches starting with one of some bytes
+   *
+   * @param[in] bytes The possible first bytes
+   * @return Prefilter The prefilter
+   */
+  Prefilter Prefilter::from_bytes(const ByteSet &bytes)
+  {
+    Prefilter prefilter;
+
+    if (bytes.all())
+      return prefilter;
+
+    prefilter.m_kind = bytes.count() <= prefilter.m_bytes.size()
+                           ? Kind::BYTES
+                           : Kind::BYTE_TABLE;
+
+    for (std::size_t byte = 0; byte < bytes.size(); ++byte)
+    {
+      if (!bytes.test(byte))
+        continue;
+
+      prefilter.m_table[byte] = true;
+
+      if (prefilter.m_byte_count < prefilter.m_bytes.size())
+        prefilter.m_bytes[prefilter.m_byte_count++] =
+            static_cast<std::uint8_t>(byte);
+    }
+
+    return prefilter;
+  }
+
+  /**
+   * @brief Finds the next position a match can start at
+   *
+   * @param[in] text The text to scan
+   * @param[in] from The first position to consider
+   * @return std::size_t The candidate position, from itself when every
+   *         position is a candidate, or npos if no match can start at or
+   *         after from
+   */
+  std::size_t Prefilter::find(std::string_view text,
+                              std::size_t from) const noexcept
+  {
+    if (from > text.size())
+      return std::string_view::npos;
+
+    switch (m_kind)
+    {
+    case Kind::LITERAL:
+      return find_literal(text, from);
+
+    case Kind::BYTES:
+      return find_bytes(text, from);
+
+    case Kind::BYTE_TABLE:
+      return find_in_table(text, from);
+
+    default:
+      return from;
+    }
+  }
+
+  /**
+   * @brief Gets the best instruction set the CPU supports
+   *
+   * @return SimdLevel The instruction set
+   */
+  SimdLevel Prefilter::supported_simd_level() noexcept
+  {
+#ifdef REGEX_DFA_X86_SIMD
+    if (__builtin_cpu_supports("avx2"))
+      return SimdLevel::AVX2;
+
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::SCALAR;
+#endif
+  }
+
+  /**
+   * @brief Gets how the prefilter finds candidates
+   *
+   * @return Kind The kind of the prefilter
+   */
+  Prefilter::Kind Prefilter::get_kind() const noexcept
+  {
+    return m_kind;
+  }
+
+  /**
+   * @brief Gets the required prefix of a LITERAL prefilter
+   *
+   * @return const std::string& The prefix, empty for other kinds
+   */
+  const std::string &Prefilter::get_prefix() const noexcept
+  {
+    return m_prefix;
+  }
+
+  /**
+   * @brief Gets the instruction set used to scan
+   *
+   * @return SimdLevel The instruction set
+   */
+  SimdLevel Prefilter::get_simd_level() const noexcept
+  {
+    return m_simd_level;
+  }
+
+  /**
+   * @brief Selects the instruction set used to scan
+   * @details Levels above what the CPU supports are lowered to it
+   *
+   * @param[in] level The instruction set
+   */
+  void Prefilter::set_simd_level(SimdLevel level) noexcept
+  {
+    m_simd_level = std::min(level, supported_simd_level());
+  }
+
+  /**
+   * @brief Finds the next occurrence of the prefix
+   *
+   * @param[in] text The text to scan
+   * @param[in] from The first position to consider
+   * @return std::size_t The position of the prefix, or npos
+   */
+  std::size_t Prefilter::find_literal(std::string_view text,
+                                      std::size_t from) const noexcept
+  {
+#ifdef REGEX_DFA_X86_SIMD
+    if (m_simd_level == SimdLevel::AVX2)
+      return find_literal_avx2(text, from, m_prefix);
+
+    if (m_simd_level == SimdLevel::SSE2)
+      return find_literal_sse2(text, from, m_prefix);
+#endif
+
+    return text.find(m_prefix, from);
+  }
+
+  /**
+   * @brief Finds the next occurrence of one of up to three bytes
+   *
+   * @param[in] text The text to scan
+   * @param[in] from The first position to consider
+   * @return std::size_t The position of the byte, or npos
+   */
+  std::size_t Prefilter::find_bytes(std::string_view text,
+                                    std::size_t from) const noexcept
+  {
+#ifdef REGEX_DFA_X86_SIMD
+    if (m_simd_level == SimdLevel::AVX2)
+      from = find_bytes_avx2(text, from, m_bytes, m_byte_count);
+
+    else if (m_simd_level == SimdLevel::SSE2)
+      from = find_bytes_sse2(text, from, m_bytes, m_byte_count);
+#endif
+
+    return find_in_table(text, from);
+  }
+
+  /**
+   * @brief Finds the next byte of the first byte table
+   *
+   * @param[in] text The text to scan
+   * @param[in] from The first position to consider
+   * @return std::size_t The position of the byte, or npos
+   */
+  std::size_t Prefilter::find_in_table(std::string_view text,
+                                       std::size_t from) const noexcept
+  {
+    for (std::size_t index = from; index < text.size(); ++index)
+      if (m_table[static_cast<std::uint8_t>(text[index])])
+        return index;
+
+    return std::string_view::npos;
+  }
+} // namespace dfa
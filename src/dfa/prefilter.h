@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../ast/arena.h"
+#include "byte_set.h"
+#include "position_automaton.h"
+
+namespace dfa
+{
+  /**
+   * @brief The SimdLevel enum lists the instruction sets a Prefilter can
+   *        scan with
+   *
+   */
+  enum class SimdLevel : std::uint8_t
+  {
+    SCALAR,
+    SSE2,
+    AVX2
+  };
+
+  /**
+   * @class Prefilter
+   * @brief Skips input that cannot start a match before the DFA runs
+   *
+   * @details A prefilter is derived from a pattern as either
+   *          - LITERAL: a prefix every match starts with, found by comparing
+   *            its first and last bytes 16 or 32 positions at a time and
+   *            verifying the candidates;
+   *          - BYTES: up to three bytes a match can start with, compared
+   *            against 16 or 32 input bytes at a time;
+   *          - BYTE_TABLE: a larger set of first bytes, looked up one byte
+   *            at a time;
+   *          - NONE: every position is a candidate.
+   *          find() never skips a position a match can start at. SIMD paths
+   *          are used on x86-64, AVX2 only when the CPU supports it.
+   */
+  class Prefilter
+  {
+  public:
+    /**
+     * @brief The Kind enum tells how a Prefilter finds candidates
+     *
+     */
+    enum class Kind : std::uint8_t
+    {
+      NONE,
+      LITERAL,
+      BYTES,
+      BYTE_TABLE
+    };
+
+    Prefilter() = default;
+
+    static Prefilter build(const ast::Arena &tree,
+                           const PositionAutomaton &automaton);
+    static Prefilter from_literal(std::string_view prefix);
+    static Prefilter from_bytes(const ByteSet &bytes);
+
+    [[nodiscard]] std::size_t find(std::string_view text,
+                                   std::size_t from) const noexcept;
+
+    static SimdLevel supported_simd_level() noexcept;
+
+    // Getters
+    [[nodiscard]] Kind get_kind() const noexcept;
+    [[nodiscard]] const std::string &get_prefix() const noexcept;
+    [[nodiscard]] SimdLevel get_simd_level() const noexcept;
+
+    // Setters
+    void set_simd_level(SimdLevel level) noexcept;
+
+  private:
+    Kind m_kind = Kind::NONE;
+    SimdLevel m_simd_level = supported_simd_level();
+    std::string m_prefix;
+    std::array<std::uint8_t, 3> m_bytes{};
+    std::size_t m_byte_count = 0;
+    std::array<bool, 256> m_table{};
+
+    // Helper functions
+    std::size_t find_literal(std::string_view text,
+                             std::size_t from) const noexcept;
+    std::size_t find_bytes(std::string_view text,
+                           std::size_t from) const noexcept;
+    std::size_t find_in_table(std::string_view text,
+                              std::size_t from) const noexcept;
+  };
+} // namespace dfa
@@ -0,0 +1,172 @@
+#include "searcher.h"
+
+namespace dfa
+{
+  /**
+   * @brief Construct a new Searcher:: Searcher object
+   *
+   * @param[in] dfa The automaton of the pattern
+   * @param[in] inner_dfa The automaton with '^' made impassable, if the
+   *            pattern has '^' anchors
+   * @param[in] forward_dfa The unanchored automaton with '^' made
+   *            impassable, or none if it is too large to build
+   * @param[in] prefilter The prefilter of the pattern
+   */
+  Searcher::Searcher(DFA dfa, std::optional<DFA> inner_dfa,
+                     std::optional<DFA> forward_dfa, Prefilter prefilter)
+      : m_dfa(std::move(dfa)), m_inner_dfa(std::move(inner_dfa)),
+        m_forward_dfa(std::move(forward_dfa)),
+        m_prefilter(std::move(prefilter))
+  {
+  }
+
+  /**
+   * @brief Finds the leftmost-longest match starting at or after from
+   * @details A match starting at 0 may pass '^' and is tried first. Any
+   *          other match starts at or before the end of the first match
+   *          the forward DFA finds, which bounds the candidates tried.
+   *
+   * @param[in] text The text to search
+   * @param[in] from The first position a match may start at
+   * @return std::optional<Match> The match, if there is one
+   */
+  std::optional<Match> Searcher::find(std::string_view text,
+                                      std::size_t from) const
+  {
+    if (from == 0 && m_inner_dfa)
+      if (const auto end = longest_match(m_dfa, text, 0))
+        return Match{0, *end};
+
+    const std::size_t first = m_prefilter.find(text, from);
+    std::size_t last = text.size();
+
+    if (m_forward_dfa)
+    {
+      const auto end = first_match_end(text, first);
+
+      if (!end)
+        return std::nullopt;
+
+      last = *end;
+    }
+
+    const DFA &dfa = m_inner_dfa ? *m_inner_dfa : m_dfa;
+
+    for (std::size_t start = first;
+         start != std::string_view::npos && start <= last;
+         start = m_prefilter.find(text, start + 1))
+    {
+      if (const auto end = longest_match(dfa, text, start))
+        return Match{start, *end};
+    }
+
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Gets the automaton of the pattern
+   *
+   * @return const DFA& The automaton
+   */
+  const DFA &Searcher::get_dfa() const noexcept
+  {
+    return m_dfa;
+  }
+
+  /**
+   * @brief Gets the prefilter
+   *
+   * @return const Prefilter& The prefilter
+   */
+  const Prefilter &Searcher::get_prefilter() const noexcept
+  {
+    return m_prefilter;
+  }
+
+  /**
+   * @brief Gets the prefilter, e.g. to select its instruction set
+   *
+   * @return Prefilter& The prefilter
+   */
+  Prefilter &Searcher::get_prefilter() noexcept
+  {
+    return m_prefilter;
+  }
+
+  /**
+   * @brief Scans the text once with the forward DFA for the earliest end
+   *        of a match that does not pass '^'
+   * @details The forward DFA starts a new attempt at every byte. Whenever
+   *          it is back in its start state no earlier attempt is alive, so
+   *          the scan skips ahead to the next prefilter candidate.
+   *
+   * @param[in] text The text to search
+   * @param[in] first The first prefilter candidate, or npos
+   * @return std::optional<std::size_t> The end of the first match, if
+   *         there is one
+   */
+  std::optional<std::size_t> Searcher::first_match_end(
+      std::string_view text, std::size_t first) const
+  {
+    const DFA &dfa = *m_forward_dfa;
+    const StateId start = dfa.get_start_state();
+    std::size_t index = first;
+    StateId state = start;
+
+    while (index != std::string_view::npos)
+    {
+      if (dfa.is_accepting(state))
+        return index;
+
+      if (index == text.size())
+        break;
+
+      state = dfa.next(state, static_cast<std::uint8_t>(text[index++]));
+
+      if (state == DFA::DEAD_STATE)
+        return std::nullopt;
+
+      if (state == start)
+        index = m_prefilter.find(text, index);
+    }
+
+    if (index == text.size() && dfa.is_accepting_at_eof(state))
+      return index;
+
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Runs the automaton from start until it dies or the text ends
+   *
+   * @param[in] dfa The automaton to run
+   * @param[in] text The text to search
+   * @param[in] start The position the match starts at
+   * @return std::optional<std::size_t> The end of the longest match
+   */
+  std::optional<std::size_t> Searcher::longest_match(
+      const DFA &dfa, std::string_view text, std::size_t start) const noexcept
+  {
+    std::optional<std::size_t> end;
+    StateId state = dfa.get_start_state();
+
+    if (dfa.is_accepting(state))
+      end = start;
+
+    for (std::size_t index = start; index < text.size(); ++index)
+    {
+      state = dfa.next(state, static_cast<std::uint8_t>(text[index]));
+
+      if (state == DFA::DEAD_STATE)
+        return end;
+
+      if (dfa.is_accepting(state))
+        end = index + 1;
+    }
+
+    if (dfa.is_accepting_at_eof(state))
+      end = text.size();
+
+    return end;
+  }
+} // namespace dfa
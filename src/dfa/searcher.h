@@ -0,0 +1,65 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+#include "dfa.h"
+#include "prefilter.h"
+
+namespace dfa
+{
+  /**
+   * @struct Match
+   * @brief Byte range [start, end) of a match in the searched text
+   *
+   */
+  struct Match
+  {
+    std::size_t start = 0;
+    std::size_t end = 0;
+
+    bool operator==(const Match &) const = default;
+  };
+
+  /**
+   * @class Searcher
+   * @brief Finds matches of a pattern inside a larger text
+   *
+   * @details The prefilter jumps to the positions a match can start at, and
+   *          the DFA is run from each candidate to find the longest match
+   *          starting there. The first candidate with a match wins, so the
+   *          result is the leftmost-longest match. Patterns with '^' carry a
+   *          second DFA in which '^' cannot be passed, used for candidates
+   *          after the start of the text. Before any candidate is tried, an
+   *          unanchored DFA scans the text once to find where the first
+   *          match ends, so a text without a match is rejected in linear
+   *          time and only candidates before that end are tried.
+   */
+  class Searcher
+  {
+  public:
+    Searcher(DFA dfa, std::optional<DFA> inner_dfa,
+             std::optional<DFA> forward_dfa, Prefilter prefilter);
+
+    [[nodiscard]] std::optional<Match> find(std::string_view text,
+                                            std::size_t from = 0) const;
+
+    // Getters
+    [[nodiscard]] const DFA &get_dfa() const noexcept;
+    [[nodiscard]] const Prefilter &get_prefilter() const noexcept;
+    [[nodiscard]] Prefilter &get_prefilter() noexcept;
+
+  private:
+    DFA m_dfa;
+    std::optional<DFA> m_inner_dfa;
+    std::optional<DFA> m_forward_dfa;
+    Prefilter m_prefilter;
+
+    // Helper functions
+    std::optional<std::size_t> first_match_end(std::string_view text,
+                                               std::size_t first) const;
+    std::optional<std::size_t> longest_match(const DFA &dfa,
+                                             std::string_view text,
+                                             std::size_t start) const noexcept;
+  };
+} // namespace dfa
@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cmath>
+#include "state_estimator.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Largest power of two a single repeat multiplies the estimate
+     *        by
+     *
+     */
+    constexpr std::uint32_t MAX_EXPONENT = 62;
+  } // namespace
+
+  /**
+   * @brief Estimates the DFA states of an AST
+   *
+   * @param[in] tree The AST, with its root set
+   * @param[in] unanchored Whether a match may start at any byte
+   * @return StateEstimate The estimated states, construction work and
+   *         positions
+   */
+  StateEstimate StateEstimator::estimate(const ast::Arena &tree,
+                                         bool unanchored)
+  {
+    m_tree = &tree;
+    m_reentrant = unanchored;
+    m_trigger.reset();
+
+    const Estimate result = visit(tree.get_root());
+
+    // One more position for the end marker
+    const double states = (result.positions + 1) * result.factor;
+
+    return {states, states * (result.width + 1), result.positions + 1};
+  }
+
+  /**
+   * @brief Visits a literal node as the concatenation of its characters
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_literal_node(const ast::LiteralNode &node)
+  {
+    Estimate result;
+
+    for (const char character : node.value)
+      result = concatenate(std::move(result), leaf(literal_bytes(character)));
+
+    m_result = std::move(result);
+  }
+
+  /**
+   * @brief Visits a metacharacter node
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_metacharacter_node(
+      const ast::MetacharacterNode &node)
+  {
+    if (node.character == '.')
+      m_result = leaf(wildcard_bytes());
+
+    else if (node.character == '^' || node.character == '$')
+      m_result = zero_width();
+
+    else
+      m_result = leaf(literal_bytes(node.character));
+  }
+
+  /**
+   * @brief Visits a character class node
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_character_class_node(
+      const ast::CharacterClassNode &node)
+  {
+    m_result = leaf(character_class_bytes(node.value));
+  }
+
+  /**
+   * @brief Visits a grouping node as the concatenation of its children
+   * @details A child after a loop can be re-entered by the bytes the
+   *          children before it end with
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_grouping_node(const ast::GroupingNode &node)
+  {
+    const bool reentrant = m_reentrant;
+    const std::optional<ByteSet> trigger = m_trigger;
+    Estimate result;
+
+    for (const ast::NodeIndex child : node.children)
+    {
+      m_reentrant = reentrant || result.loops;
+
+      if (result.last.any())
+        m_trigger = result.nullable && trigger ? *trigger | result.last
+                                               : result.last;
+
+      result = concatenate(std::move(result), visit(child));
+    }
+
+    m_reentrant = reentrant;
+    m_trigger = trigger;
+    m_result = std::move(result);
+  }
+
+  /**
+   * @brief Visits a quantifier node
+   * @details A re-entrant bounded repeat whose trigger bytes overlap its own
+   *          bytes without covering them multiplies the estimate by
+   *          2^max. A state may hold the positions of every copy when
+   *          the repeat is re-entrant or the input does not decide how
+   *          many copies it has passed
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_quantifier_node(const ast::QuantifierNode &node)
+  {
+    const std::uint32_t min = node.min_occurrences;
+    const std::uint32_t max = node.max_occurrences;
+
+    if (max == 0)
+    {
+      m_result = Estimate{};
+      return;
+    }
+
+    const bool unbounded = max == ast::UNBOUNDED;
+    const bool reentrant = m_reentrant;
+
+    m_reentrant = reentrant || unbounded;
+    const Estimate child = visit(node.child);
+    m_reentrant = reentrant;
+
+    Estimate result = child;
+    result.positions *= unbounded ? static_cast<double>(min) + 1 : max;
+    result.nullable = min == 0 || child.nullable;
+    result.loops = child.loops || unbounded;
+    result.stretches = child.stretches || unbounded || min != max;
+
+    if (result.positions > child.positions &&
+        (reentrant || child.nullable || child.stretches))
+      result.width = result.positions;
+
+    if (reentrant && !unbounded && max > 1)
+    {
+      const ByteSet trigger = m_trigger.value_or(child.first);
+
+      if ((trigger & child.bytes).any() && (child.bytes & ~trigger).any())
+        result.factor *= std::ldexp(1.0, static_cast<int>(
+                                             std::min(max, MAX_EXPONENT)));
+    }
+
+    m_result = std::move(result);
+  }
+
+  /**
+   * @brief Visits an anchor node, which consumes no input
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_anchor_node(const ast::AnchorNode &)
+  {
+    m_result = zero_width();
+  }
+
+  /**
+   * @brief Visits an escape sequence node
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_escape_sequence_node(
+      const ast::EscapeSequenceNode &node)
+  {
+    m_result = leaf(escape_bytes(node.character));
+  }
+
+  /**
+   * @brief Visits a wildcard node
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_wildcard_node(const ast::WildcardNode &)
+  {
+    m_result = leaf(wildcard_bytes());
+  }
+
+  /**
+   * @brief Visits an alternation node
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_alternation_node(
+      const ast::AlternationNode &node)
+  {
+    Estimate result;
+    result.nullable = false;
+
+    for (const ast::NodeIndex child : node.children)
+      result = alternate(std::move(result), visit(child));
+
+    m_result = std::move(result);
+  }
+
+  /**
+   * @brief Visits a boundary node, left for the followpos analysis to
+   *        reject
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_boundary_node(const ast::BoundaryNode &)
+  {
+    m_result = zero_width();
+  }
+
+  /**
+   * @brief Visits a modifier node, left for the followpos analysis to
+   *        reject
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_modifier_node(const ast::ModifierNode &)
+  {
+    m_result = zero_width();
+  }
+
+  /**
+   * @brief Visits an invalid node, left for the followpos analysis to
+   *        reject
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_invalid_node(const ast::InvalidNode &)
+  {
+    m_result = zero_width();
+  }
+
+  /**
+   * @brief Visits an end of input node
+   *
+   * @param[in] node The node to visit
+   */
+  void StateEstimator::visit_end_of_input_node(const ast::EndOfInputNode &)
+  {
+    m_result = zero_width();
+  }
+
+  /**
+   * @brief Visits a subtree and returns its estimate
+   *
+   * @param[in] node The root of the subtree
+   * @return Estimate The estimate of the subtree
+   */
+  StateEstimator::Estimate StateEstimator::visit(ast::NodeIndex node)
+  {
+    m_tree->accept(node, *this);
+    return std::move(m_result);
+  }
+
+  /**
+   * @brief Creates the estimate of a single position
+   *
+   * @param[in] bytes The bytes the position consumes
+   * @return Estimate The estimate
+   */
+  StateEstimator::Estimate StateEstimator::leaf(const ByteSet &bytes)
+  {
+    Estimate result;
+    result.positions = 1;
+    result.width = 1;
+    result.first = bytes;
+    result.last = bytes;
+    result.bytes = bytes;
+    result.nullable = false;
+
+    return result;
+  }
+
+  /**
+   * @brief Creates the estimate of a position that consumes nothing
+   *
+   * @return Estimate The estimate
+   */
+  StateEstimator::Estimate StateEstimator::zero_width()
+  {
+    Estimate result;
+    result.positions = 1;
+    result.width = 1;
+
+    return result;
+  }
+
+  /**
+   * @brief Combines two subtrees matched one after the other
+   * @details Positions of both subtrees share a state when the first one
+   *          is nullable
+   *
+   * @param[in] left The first subtree
+   * @param[in] right The second subtree
+   * @return Estimate The estimate of the concatenation
+   */
+  StateEstimator::Estimate StateEstimator::concatenate(Estimate left,
+                                                       const Estimate &right)
+  {
+    if (left.nullable)
+      left.first |= right.first;
+
+    left.last = right.nullable ? left.last | right.last : right.last;
+    left.bytes |= right.bytes;
+    left.width = left.nullable ? left.width + right.width
+                               : std::max(left.width, right.width);
+    left.positions += right.positions;
+    left.factor *= right.factor;
+    left.nullable = left.nullable && right.nullable;
+    left.loops = left.loops || right.loops;
+    left.stretches = left.stretches || right.stretches;
+
+    return left;
+  }
+
+  /**
+   * @brief Combines two subtrees matched as alternatives
+   *
+   * @param[in] left The first alternative
+   * @param[in] right The second alternative
+   * @return Estimate The estimate of the alternation
+   */
+  StateEstimator::Estimate StateEstimator::alternate(Estimate left,
+                                                     const Estimate &right)
+  {
+    left.first |= right.first;
+    left.last |= right.last;
+    left.bytes |= right.bytes;
+    left.positions += right.positions;
+    left.width += right.width;
+    left.factor = std::max(left.factor, right.factor);
+    left.nullable = left.nullable || right.nullable;
+    left.loops = left.loops || right.loops;
+    left.stretches = left.stretches || right.stretches;
+
+    return left;
+  }
+} // namespace dfa
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <optional>
+
+#include "../ast/arena.h"
+#include "byte_set.h"
+
+namespace dfa
+{
+  /**
+   * @struct StateEstimate
+   * @brief The predicted size of a DFA and of the work to build it
+   *
+   * @details work is the number of states times the positions a single
+   *          state may hold, which the subset construction visits for
+   *          every state. positions is the expanded number of positions,
+   *          including the end marker.
+   */
+  struct StateEstimate
+  {
+    double states = 0;
+    double work = 0;
+    double positions = 0;
+  };
+
+  /**
+   * @class StateEstimator
+   * @brief Estimates the number of DFA states a pattern determinizes to,
+   *        before any position is created
+   *
+   * @details The estimate is the expanded number of positions times a
+   *          blow-up factor. A bounded repeat x{m,n} that can be entered
+   *          again while it is still running, because the match is
+   *          unanchored or an earlier loop precedes it, may have to track
+   *          up to n overlapping attempts at once. When the bytes that
+   *          re-enter it overlap the bytes of x without covering them, as
+   *          in .*a.{n}, the factor grows by 2^n. The positions a state
+   *          may hold stay few while the input decides how many copies of
+   *          a repeat it has passed. They grow to every position of the
+   *          repeat when it can be re-entered, or when its child is
+   *          nullable or holds a repeat of varying count, so that the
+   *          same input splits into different numbers of copies, as in
+   *          (a{1,200}){1,200}. The estimate is a heuristic meant to
+   *          reject hopeless patterns cheaply, not a bound.
+   */
+  class StateEstimator : public ast::AstVisitor
+  {
+  public:
+    StateEstimator() = default;
+
+    StateEstimate estimate(const ast::Arena &tree, bool unanchored);
+
+    void visit_literal_node(const ast::LiteralNode &node) override;
+    void visit_metacharacter_node(
+        const ast::MetacharacterNode &node) override;
+
+    void visit_character_class_node(
+        const ast::CharacterClassNode &node) override;
+
+    void visit_grouping_node(const ast::GroupingNode &node) override;
+    void visit_quantifier_node(const ast::QuantifierNode &node) override;
+    void visit_anchor_node(const ast::AnchorNode &node) override;
+    void visit_escape_sequence_node(
+        const ast::EscapeSequenceNode &node) override;
+
+    void visit_wildcard_node(const ast::WildcardNode &node) override;
+    void visit_alternation_node(const ast::AlternationNode &node) override;
+    void visit_boundary_node(const ast::BoundaryNode &node) override;
+    void visit_modifier_node(const ast::ModifierNode &node) override;
+    void visit_invalid_node(const ast::InvalidNode &node) override;
+    void visit_end_of_input_node(const ast::EndOfInputNode &node) override;
+
+  private:
+    /**
+     * @struct Estimate
+     * @brief The size and shape of a visited subtree
+     *
+     */
+    struct Estimate
+    {
+      double positions = 0;
+      double factor = 1;
+      double width = 0;
+      ByteSet first;
+      ByteSet last;
+      ByteSet bytes;
+      bool nullable = true;
+      bool loops = false;
+      bool stretches = false;
+    };
+
+    const ast::Arena *m_tree = nullptr;
+    Estimate m_result;
+
+    // Whether the visited subtree can be entered again while it runs, and
+    // the bytes that enter it; none means its own first bytes
+    bool m_reentrant = false;
+    std::optional<ByteSet> m_trigger;
+
+    // Helper functions
+    Estimate visit(ast::NodeIndex node);
+    static Estimate leaf(const ByteSet &bytes);
+    static Estimate zero_width();
+    static Estimate concatenate(Estimate left, const Estimate &right);
+    static Estimate alternate(Estimate left, const Estimate &right);
+  };
+} // namespace dfa
@@ -0,0 +1,1158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @struct FixedString
+   * @brief String literal usable as a template argument
+   *
+   * @tparam N The size of the literal, including the terminating null
+   */
+  template <std::size_t N>
+  struct FixedString
+  {
+    char value[N]{};
+
+    /**
+     * @brief Construct a new Fixed String:: Fixed String object
+     *
+     * @param[in] literal The string literal
+     */
+    constexpr FixedString(const char (&literal)[N])
+    {
+      std::copy_n(literal, N, value);
+    }
+
+    /**
+     * @brief Gets the characters of the literal, without the null
+     *
+     * @return std::string_view The string
+     */
+    [[nodiscard]] constexpr std::string_view view() const noexcept
+    {
+      return std::string_view(value, N - 1);
+    }
+  };
+
+  namespace detail
+  {
+    /**
+     * @struct StaticByteSet
+     * @brief constexpr set of bytes, standing in for ByteSet
+     *
+     */
+    struct StaticByteSet
+    {
+      std::array<std::uint64_t, 4> words{};
+
+      constexpr void set(unsigned int byte) noexcept
+      {
+        words[byte / 64] |= std::uint64_t{1} << (byte % 64);
+      }
+
+      constexpr void set_range(unsigned int first, unsigned int last) noexcept
+      {
+        for (unsigned int byte = first; byte <= last; ++byte)
+          set(byte);
+      }
+
+      [[nodiscard]] constexpr bool test(unsigned int byte) const noexcept
+      {
+        return (words[byte / 64] >> (byte % 64)) & 1;
+      }
+
+      constexpr void merge(const StaticByteSet &other) noexcept
+      {
+        for (std::size_t i = 0; i < words.size(); ++i)
+          words[i] |= other.words[i];
+      }
+
+      constexpr void flip() noexcept
+      {
+        for (auto &word : words)
+          word = ~word;
+      }
+
+      [[nodiscard]] constexpr std::size_t count() const noexcept
+      {
+        std::size_t count = 0;
+
+        for (const auto word : words)
+          count += std::popcount(word);
+
+        return count;
+      }
+    };
+
+    /**
+     * @class StaticPositionSet
+     * @brief constexpr growable bitset of positions, standing in for
+     *        PositionSet
+     *
+     */
+    class StaticPositionSet
+    {
+    public:
+      constexpr void insert(std::uint32_t position)
+      {
+        if (position / 64 >= m_words.size())
+          m_words.resize(position / 64 + 1, 0);
+
+        m_words[position / 64] |= std::uint64_t{1} << (position % 64);
+      }
+
+      constexpr void erase(std::uint32_t position) noexcept
+      {
+        if (position / 64 < m_words.size())
+          m_words[position / 64] &= ~(std::uint64_t{1} << (position % 64));
+      }
+
+      [[nodiscard]] constexpr bool contains(
+          std::uint32_t position) const noexcept
+      {
+        return position / 64 < m_words.size() &&
+               (m_words[position / 64] >> (position % 64)) & 1;
+      }
+
+      constexpr void merge(const StaticPositionSet &other)
+      {
+        if (other.m_words.size() > m_words.size())
+          m_words.resize(other.m_words.size(), 0);
+
+        for (std::size_t i = 0; i < other.m_words.size(); ++i)
+          m_words[i] |= other.m_words[i];
+      }
+
+      template <typename Function>
+      constexpr void for_each(Function &&function) const
+      {
+        for (std::size_t i = 0; i < m_words.size(); ++i)
+          for (std::uint64_t word = m_words[i]; word != 0; word &= word - 1)
+            function(static_cast<std::uint32_t>(
+                i * 64 + std::countr_zero(word)));
+      }
+
+      constexpr bool operator==(const StaticPositionSet &other) const noexcept
+      {
+        const std::size_t size = std::max(m_words.size(),
+                                          other.m_words.size());
+
+        for (std::size_t i = 0; i < size; ++i)
+          if (word(i) != other.word(i))
+            return false;
+
+        return true;
+      }
+
+    private:
+      std::vector<std::uint64_t> m_words;
+
+      [[nodiscard]] constexpr std::uint64_t word(std::size_t i) const noexcept
+      {
+        return i < m_words.size() ? m_words[i] : 0;
+      }
+    };
+
+    /**
+     * @struct StaticTable
+     * @brief Minimal DFA produced by StaticCompiler, in DFA's layout
+     *
+     */
+    struct StaticTable
+    {
+      std::array<std::uint8_t, DFA::ALPHABET_SIZE> byte_classes{};
+      std::size_t class_count = 0;
+      std::vector<StateId> transitions;
+      std::vector<std::uint8_t> accept_flags;
+      StateId start_state = DFA::DEAD_STATE;
+    };
+
+    /**
+     * @class StaticCompiler
+     * @brief constexpr version of the Compiler pipeline
+     *
+     * @details Mirrors the runtime stages on constexpr-friendly containers:
+     *          the pattern is parsed with the grammar and token rules of
+     *          Lexer and Parser into a small tree, followpos is computed as
+     *          in FollowposVisitor, states are built by subset construction
+     *          over byte classes as in DFABuilder, and the result is
+     *          minimized by partition refinement with identical columns
+     *          merged, as Minimizer does. Invalid or unsupported patterns
+     *          throw, which makes a constant evaluation fail to compile.
+     */
+    class StaticCompiler
+    {
+    public:
+      /**
+       * @brief Construct a new Static Compiler:: Static Compiler object
+       *
+       * @param[in] pattern The pattern to compile
+       */
+      constexpr explicit StaticCompiler(std::string_view pattern)
+          : m_pattern(pattern)
+      {
+      }
+
+      /**
+       * @brief Runs the whole pipeline
+       *
+       * @return StaticTable The minimal DFA of the pattern
+       * @throw std::invalid_argument If the pattern is invalid or unsupported
+       */
+      constexpr StaticTable compile()
+      {
+        const std::uint32_t root = parse_alternation();
+
+        if (m_cursor != m_pattern.size())
+          throw std::invalid_argument("StaticRegex: unexpected character");
+
+        Info info = visit(root);
+        const Info marker = leaf(Kind::END_MARKER, StaticByteSet{});
+
+        m_end_marker = static_cast<std::uint32_t>(m_kinds.size() - 1);
+        info = concatenate(std::move(info), marker);
+
+        return minimize(determinize(info.first));
+      }
+
+    private:
+      /**
+       * @brief Node and position kinds of the compile-time tree
+       *
+       */
+      enum class Kind : std::uint8_t
+      {
+        SYMBOL,
+        START_ANCHOR,
+        END_ANCHOR,
+        END_MARKER,
+        SEQUENCE,
+        ALTERNATION,
+        REPEAT
+      };
+
+      static constexpr std::uint32_t NO_NODE = ~std::uint32_t{0};
+      static constexpr std::uint32_t UNBOUNDED = 255;
+
+      struct Node
+      {
+        Kind kind = Kind::SEQUENCE;
+        StaticByteSet symbols;
+        std::uint32_t min = 0;
+        std::uint32_t max = 0;
+        std::uint32_t first_child = NO_NODE;
+        std::uint32_t last_child = NO_NODE;
+        std::uint32_t next_sibling = NO_NODE;
+      };
+
+      struct Info
+      {
+        bool nullable = true;
+        StaticPositionSet first;
+        StaticPositionSet last;
+      };
+
+      std::string_view m_pattern;
+      std::size_t m_cursor = 0;
+      std::vector<Node> m_nodes;
+
+      std::vector<StaticByteSet> m_symbols;
+      std::vector<Kind> m_kinds;
+      std::vector<StaticPositionSet> m_follow;
+      std::uint32_t m_end_marker = 0;
+
+      // Parser, following parser::Parser
+      constexpr std::uint32_t add_node(Kind kind, StaticByteSet symbols = {})
+      {
+        m_nodes.push_back(Node{kind, symbols});
+        return static_cast<std::uint32_t>(m_nodes.size() - 1);
+      }
+
+      constexpr void add_child(std::uint32_t parent, std::uint32_t child)
+      {
+        if (m_nodes[parent].last_child == NO_NODE)
+          m_nodes[parent].first_child = child;
+
+        else
+          m_nodes[m_nodes[parent].last_child].next_sibling = child;
+
+        m_nodes[parent].last_child = child;
+      }
+
+      [[nodiscard]] constexpr bool at(char character) const noexcept
+      {
+        return m_cursor < m_pattern.size() && m_pattern[m_cursor] == character;
+      }
+
+      constexpr std::uint32_t parse_alternation()
+      {
+        std::uint32_t node = parse_sequence();
+
+        if (!at('|'))
+          return node;
+
+        const std::uint32_t alternation = add_node(Kind::ALTERNATION);
+        add_child(alternation, node);
+
+        while (at('|'))
+        {
+          ++m_cursor;
+          node = parse_sequence();
+          add_child(alternation, node);
+        }
+
+        return alternation;
+      }
+
+      constexpr std::uint32_t parse_sequence()
+      {
+        const std::uint32_t sequence = add_node(Kind::SEQUENCE);
+
+        while (m_cursor < m_pattern.size() && !at('|') && !at(')'))
+        {
+          const std::uint32_t child = parse_repeat();
+          add_child(sequence, child);
+        }
+
+        return sequence;
+      }
+
+      constexpr std::uint32_t parse_repeat()
+      {
+        std::uint32_t node = parse_atom();
+
+        while (m_cursor < m_pattern.size())
+        {
+          std::uint32_t min = 0;
+          std::uint32_t max = UNBOUNDED;
+
+          if (at('+'))
+            min = 1;
+
+          else if (at('?'))
+            max = 1;
+
+          else if (at('{') && scan_quantifier(m_cursor) != NO_NODE)
+          {
+            const std::size_t end = scan_quantifier(m_cursor);
+
+            ++m_cursor;
+            min = parse_bound();
+            max = min;
+
+            if (at(','))
+            {
+              ++m_cursor;
+              max = at('}') ? UNBOUNDED : parse_bound();
+            }
+
+            if (min > max)
+              throw std::invalid_argument("StaticRegex: invalid quantifier");
+
+            // Leave the cursor on the '}', consumed below
+            m_cursor = end - 1;
+          }
+
+          else if (!at('*'))
+            break;
+
+          ++m_cursor;
+
+          const std::uint32_t repeat = add_node(Kind::REPEAT);
+          m_nodes[repeat].min = min;
+          m_nodes[repeat].max = max;
+          add_child(repeat, node);
+          node = repeat;
+        }
+
+        return node;
+      }
+
+      constexpr std::uint32_t parse_atom()
+      {
+        const char character = m_pattern[m_cursor++];
+
+        switch (character)
+        {
+        case '(':
+        {
+          if (at('?') && scan_modifier(m_cursor - 1) != NO_NODE)
+            throw std::invalid_argument("StaticRegex: unsupported modifier");
+
+          const std::uint32_t inner = parse_alternation();
+
+          if (!at(')'))
+            throw std::invalid_argument("StaticRegex: unclosed group");
+
+          ++m_cursor;
+          return inner;
+        }
+
+        case '[':
+        {
+          const std::size_t end = scan_character_class(m_cursor - 1);
+
+          if (end == NO_NODE)
+            throw std::invalid_argument("StaticRegex: unclosed class");
+
+          const std::string_view value =
+              m_pattern.substr(m_cursor, end - m_cursor - 1);
+
+          m_cursor = end;
+          return add_node(Kind::SYMBOL, character_class_bytes(value));
+        }
+
+        case '{':
+          if (scan_quantifier(m_cursor - 1) != NO_NODE)
+            throw std::invalid_argument("StaticRegex: nothing to repeat");
+          break;
+
+        case '*':
+        case '+':
+        case '?':
+          throw std::invalid_argument("StaticRegex: nothing to repeat");
+
+        case ')':
+          throw std::invalid_argument("StaticRegex: unexpected ')'");
+
+        case '^':
+          return add_node(Kind::START_ANCHOR);
+
+        case '$':
+          return add_node(Kind::END_ANCHOR);
+
+        case '.':
+          return add_node(Kind::SYMBOL, wildcard_bytes());
+
+        case '\\':
+          if (m_cursor == m_pattern.size())
+            throw std::invalid_argument("StaticRegex: trailing backslash");
+
+          if (at('b') || at('B'))
+            throw std::invalid_argument("StaticRegex: unsupported boundary");
+
+          return add_node(Kind::SYMBOL, escape_bytes(m_pattern[m_cursor++]));
+
+        default:
+          break;
+        }
+
+        StaticByteSet symbols;
+        symbols.set(static_cast<unsigned char>(character));
+
+        return add_node(Kind::SYMBOL, symbols);
+      }
+
+      constexpr std::uint32_t parse_bound()
+      {
+        std::uint32_t bound = 0;
+
+        while (m_pattern[m_cursor] >= '0' && m_pattern[m_cursor] <= '9')
+        {
+          bound = bound * 10 + static_cast<std::uint32_t>(
+                                   m_pattern[m_cursor++] - '0');
+
+          if (bound >= UNBOUNDED)
+            throw std::invalid_argument("StaticRegex: bound too large");
+        }
+
+        return bound;
+      }
+
+      // Scanners, following lexer::Lexer
+      [[nodiscard]] constexpr std::size_t scan_character_class(
+          std::size_t position) const noexcept
+      {
+        std::size_t index = position + 1;
+
+        if (index < m_pattern.size() && m_pattern[index] == '^')
+          ++index;
+
+        if (index < m_pattern.size() && m_pattern[index] == ']')
+          ++index;
+
+        while (index < m_pattern.size())
+        {
+          if (m_pattern[index] == '\\')
+            index += 2;
+
+          else if (m_pattern[index] == ']')
+            return index + 1;
+
+          else
+            ++index;
+        }
+
+        return NO_NODE;
+      }
+
+      [[nodiscard]] constexpr std::size_t scan_quantifier(
+          std::size_t position) const noexcept
+      {
+        auto digit = [this](std::size_t index)
+        {
+          return index < m_pattern.size() && m_pattern[index] >= '0' &&
+                 m_pattern[index] <= '9';
+        };
+
+        std::size_t index = position + 1;
+
+        if (!digit(index))
+          return NO_NODE;
+
+        while (digit(index))
+          ++index;
+
+        if (index < m_pattern.size() && m_pattern[index] == ',')
+          while (digit(++index))
+            ;
+
+        if (index < m_pattern.size() && m_pattern[index] == '}')
+          return index + 1;
+
+        return NO_NODE;
+      }
+
+      [[nodiscard]] constexpr std::size_t scan_modifier(
+          std::size_t position) const noexcept
+      {
+        std::size_t index = position + 2;
+        const std::size_t flags_start = index;
+
+        while (index < m_pattern.size() &&
+               ((m_pattern[index] >= 'a' && m_pattern[index] <= 'z') ||
+                m_pattern[index] == '-'))
+          ++index;
+
+        if (index == flags_start || index >= m_pattern.size() ||
+            m_pattern[index] != ')')
+          return NO_NODE;
+
+        return index + 1;
+      }
+
+      // Byte sets, following byte_set.h
+      static constexpr unsigned char escaped_byte(char character) noexcept
+      {
+        switch (character)
+        {
+        case 'n':
+          return '\n';
+
+        case 't':
+          return '\t';
+
+        case 'r':
+          return '\r';
+
+        case 'f':
+          return '\f';
+
+        case 'v':
+          return '\v';
+
+        case '0':
+          return '\0';
+
+        default:
+          return static_cast<unsigned char>(character);
+        }
+      }
+
+      static constexpr StaticByteSet wildcard_bytes() noexcept
+      {
+        StaticByteSet set;
+
+        set.set('\n');
+        set.flip();
+
+        return set;
+      }
+
+      static constexpr StaticByteSet escape_bytes(char character) noexcept
+      {
+        StaticByteSet set;
+
+        switch (character)
+        {
+        case 'd':
+        case 'D':
+          set.set_range('0', '9');
+          break;
+
+        case 'w':
+        case 'W':
+          set.set_range('a', 'z');
+          set.set_range('A', 'Z');
+          set.set_range('0', '9');
+          set.set('_');
+          break;
+
+        case 's':
+        case 'S':
+          for (const char space : {' ', '\t', '\n', '\r', '\f', '\v'})
+            set.set(static_cast<unsigned char>(space));
+          break;
+
+        default:
+          set.set(escaped_byte(character));
+          return set;
+        }
+
+        if (character == 'D' || character == 'W' || character == 'S')
+          set.flip();
+
+        return set;
+      }
+
+      static constexpr StaticByteSet character_class_bytes(
+          std::string_view value)
+      {
+        bool negated = false;
+
+        if (!value.empty() && value.front() == '^')
+        {
+          negated = true;
+          value.remove_prefix(1);
+        }
+
+        StaticByteSet set;
+        std::size_t index = 0;
+
+        while (index < value.size())
+        {
+          unsigned char first = static_cast<unsigned char>(value[index]);
+
+          if (first == '\\' && index + 1 < value.size())
+          {
+            const char escaped = value[index + 1];
+            const StaticByteSet escaped_set = escape_bytes(escaped);
+            index += 2;
+
+            if (escaped_set.count() != 1)
+            {
+              set.merge(escaped_set);
+              continue;
+            }
+
+            first = escaped_byte(escaped);
+          }
+          else
+            ++index;
+
+          if (index + 1 < value.size() && value[index] == '-')
+          {
+            unsigned char last = static_cast<unsigned char>(value[index + 1]);
+            index += 2;
+
+            if (last == '\\' && index < value.size())
+              last = escaped_byte(value[index++]);
+
+            if (last < first)
+              throw std::invalid_argument("StaticRegex: invalid range");
+
+            set.set_range(first, last);
+          }
+          else
+            set.set(first);
+        }
+
+        if (negated)
+          set.flip();
+
+        return set;
+      }
+
+      // Followpos, following FollowposVisitor
+      constexpr Info visit(std::uint32_t index)
+      {
+        const Node &node = m_nodes[index];
+
+        switch (node.kind)
+        {
+        case Kind::SYMBOL:
+        case Kind::START_ANCHOR:
+        case Kind::END_ANCHOR:
+          return leaf(node.kind, node.symbols);
+
+        case Kind::ALTERNATION:
+        {
+          Info info;
+          info.nullable = false;
+
+          for (auto child = node.first_child; child != NO_NODE;
+               child = m_nodes[child].next_sibling)
+          {
+            const Info branch = visit(child);
+
+            info.first.merge(branch.first);
+            info.last.merge(branch.last);
+            info.nullable = info.nullable || branch.nullable;
+          }
+
+          return info;
+        }
+
+        case Kind::REPEAT:
+        {
+          const std::uint32_t child = node.first_child;
+          const std::uint32_t min = node.min;
+          const std::uint32_t max = node.max;
+          Info info;
+
+          for (std::uint32_t i = 0; i < min; ++i)
+            info = concatenate(std::move(info), visit(child));
+
+          if (max == UNBOUNDED)
+            info = concatenate(std::move(info), star(visit(child)));
+
+          else
+            for (std::uint32_t i = min; i < max; ++i)
+            {
+              Info optional = visit(child);
+
+              optional.nullable = true;
+              info = concatenate(std::move(info), optional);
+            }
+
+          return info;
+        }
+
+        default:
+        {
+          Info info;
+
+          for (auto child = node.first_child; child != NO_NODE;
+               child = m_nodes[child].next_sibling)
+            info = concatenate(std::move(info), visit(child));
+
+          return info;
+        }
+        }
+      }
+
+      constexpr Info leaf(Kind kind, const StaticByteSet &symbols)
+      {
+        const auto position = static_cast<std::uint32_t>(m_kinds.size());
+
+        m_symbols.push_back(symbols);
+        m_kinds.push_back(kind);
+        m_follow.emplace_back();
+
+        Info info;
+        info.nullable = false;
+        info.first.insert(position);
+        info.last.insert(position);
+
+        return info;
+      }
+
+      constexpr Info concatenate(Info left, const Info &right)
+      {
+        left.last.for_each([&](std::uint32_t position)
+                           { m_follow[position].merge(right.first); });
+
+        if (left.nullable)
+          left.first.merge(right.first);
+
+        if (right.nullable)
+          left.last.merge(right.last);
+
+        else
+          left.last = right.last;
+
+        left.nullable = left.nullable && right.nullable;
+        return left;
+      }
+
+      constexpr Info star(Info info)
+      {
+        info.last.for_each([&](std::uint32_t position)
+                           { m_follow[position].merge(info.first); });
+
+        info.nullable = true;
+        return info;
+      }
+
+      // Subset construction, following DFABuilder
+      template <typename Passable>
+      constexpr StaticPositionSet close_over(StaticPositionSet set,
+                                             Passable passable) const
+      {
+        StaticPositionSet visited;
+        bool changed = true;
+
+        while (changed)
+        {
+          changed = false;
+          StaticPositionSet pending;
+
+          set.for_each([&](std::uint32_t position)
+                       {
+            if (!visited.contains(position) && passable(position))
+            {
+              visited.insert(position);
+              pending.merge(m_follow[position]);
+              changed = true;
+            } });
+
+          set.merge(pending);
+        }
+
+        return set;
+      }
+
+      constexpr void strip_start_anchors(StaticPositionSet &set) const
+      {
+        for (std::uint32_t position = 0; position < m_kinds.size();
+             ++position)
+          if (m_kinds[position] == Kind::START_ANCHOR)
+            set.erase(position);
+      }
+
+      constexpr std::uint8_t accept_flags(const StaticPositionSet &set) const
+      {
+        if (set.contains(m_end_marker))
+          return ACCEPT | ACCEPT_AT_EOF;
+
+        // A '^' is only in the start state, where a '$' led to it
+        const auto at_end = [&](std::uint32_t position)
+        {
+          return m_kinds[position] == Kind::END_ANCHOR ||
+                 (m_kinds[position] == Kind::START_ANCHOR &&
+                  set.contains(position));
+        };
+
+        if (close_over(set, at_end).contains(m_end_marker))
+          return ACCEPT_AT_EOF;
+
+        return NONE;
+      }
+
+      constexpr StaticTable determinize(const StaticPositionSet &first) const
+      {
+        StaticTable table;
+        std::vector<unsigned int> representatives;
+
+        // Bytes share a class when every position treats them alike
+        for (unsigned int byte = 0; byte < DFA::ALPHABET_SIZE; ++byte)
+        {
+          std::size_t byte_class = 0;
+
+          while (byte_class < representatives.size() &&
+                 !same_class(byte, representatives[byte_class]))
+            ++byte_class;
+
+          if (byte_class == representatives.size())
+            representatives.push_back(byte);
+
+          table.byte_classes[byte] = static_cast<std::uint8_t>(byte_class);
+        }
+
+        table.class_count = representatives.size();
+
+        std::vector<StaticPositionSet> states;
+
+        auto intern = [&states](StaticPositionSet &&set)
+        {
+          for (std::size_t state = 0; state < states.size(); ++state)
+            if (states[state] == set)
+              return static_cast<StateId>(state);
+
+          states.push_back(std::move(set));
+          return static_cast<StateId>(states.size() - 1);
+        };
+
+        const StaticPositionSet passed =
+            close_over(first, [&](std::uint32_t position)
+                       { return m_kinds[position] == Kind::START_ANCHOR; });
+        StaticPositionSet start = passed;
+        strip_start_anchors(start);
+
+        // On empty input a '$' may lead to a '^', which stays in the start
+        // state so that accept_flags() may pass it
+        close_over(passed, [&](std::uint32_t position)
+                   { return m_kinds[position] == Kind::START_ANCHOR ||
+                            m_kinds[position] == Kind::END_ANCHOR; })
+            .for_each([&](std::uint32_t position)
+                      {
+              if (m_kinds[position] == Kind::START_ANCHOR &&
+                  !passed.contains(position))
+                start.insert(position); });
+
+        intern(StaticPositionSet{});
+        table.start_state = intern(std::move(start));
+
+        for (std::size_t state = 0; state < states.size(); ++state)
+          for (const unsigned int byte : representatives)
+          {
+            StaticPositionSet next;
+
+            states[state].for_each([&](std::uint32_t position)
+                                   {
+              if (m_symbols[position].test(byte))
+                next.merge(m_follow[position]); });
+
+            strip_start_anchors(next);
+            table.transitions.push_back(intern(std::move(next)));
+          }
+
+        for (const auto &set : states)
+          table.accept_flags.push_back(accept_flags(set));
+
+        return table;
+      }
+
+      [[nodiscard]] constexpr bool same_class(unsigned int byte,
+                                              unsigned int other) const
+      {
+        for (const auto &symbols : m_symbols)
+          if (symbols.test(byte) != symbols.test(other))
+            return false;
+
+        return true;
+      }
+
+      // Minimization, following Minimizer
+      static constexpr StaticTable minimize(const StaticTable &table)
+      {
+        const std::size_t states = table.accept_flags.size();
+        const std::size_t classes = table.class_count;
+
+        // Moore refinement: split blocks by the blocks of their targets
+        std::vector<std::uint32_t> block(states);
+        std::size_t block_count = 0;
+
+        for (std::size_t state = 0; state < states; ++state)
+          block[state] = table.accept_flags[state];
+
+        while (true)
+        {
+          std::vector<std::vector<std::uint32_t>> signatures;
+          std::vector<std::uint32_t> refined(states);
+
+          for (std::size_t state = 0; state < states; ++state)
+          {
+            std::vector<std::uint32_t> signature{block[state]};
+
+            for (std::size_t c = 0; c < classes; ++c)
+              signature.push_back(
+                  block[table.transitions[state * classes + c]]);
+
+            std::size_t id = 0;
+
+            while (id < signatures.size() && signatures[id] != signature)
+              ++id;
+
+            if (id == signatures.size())
+              signatures.push_back(std::move(signature));
+
+            refined[state] = static_cast<std::uint32_t>(id);
+          }
+
+          block = std::move(refined);
+
+          if (signatures.size() == block_count)
+            break;
+
+          block_count = signatures.size();
+        }
+
+        // Renumber blocks breadth first, with the dead state's block first
+        std::vector<StateId> order(block_count, NO_NODE);
+        std::vector<std::size_t> members(block_count, 0);
+        std::vector<std::size_t> queue;
+
+        for (std::size_t state = states; state-- > 0;)
+          members[block[state]] = state;
+
+        auto visit = [&](std::size_t state)
+        {
+          if (order[block[state]] == NO_NODE)
+          {
+            order[block[state]] = static_cast<StateId>(queue.size());
+            queue.push_back(members[block[state]]);
+          }
+        };
+
+        visit(DFA::DEAD_STATE);
+        visit(table.start_state);
+
+        for (std::size_t i = 0; i < queue.size(); ++i)
+          for (std::size_t c = 0; c < classes; ++c)
+            visit(table.transitions[queue[i] * classes + c]);
+
+        // Merge byte classes whose columns became identical
+        std::vector<std::size_t> columns;
+        std::array<std::uint8_t, DFA::ALPHABET_SIZE> merged{};
+
+        for (std::size_t c = 0; c < classes; ++c)
+        {
+          std::size_t column = 0;
+
+          auto same_column = [&](std::size_t other)
+          {
+            for (const std::size_t state : queue)
+              if (block[table.transitions[state * classes + c]] !=
+                  block[table.transitions[state * classes + other]])
+                return false;
+
+            return true;
+          };
+
+          while (column < columns.size() && !same_column(columns[column]))
+            ++column;
+
+          if (column == columns.size())
+            columns.push_back(c);
+
+          merged[c] = static_cast<std::uint8_t>(column);
+        }
+
+        StaticTable minimal;
+        minimal.class_count = columns.size();
+        minimal.start_state = order[block[table.start_state]];
+
+        for (std::size_t byte = 0; byte < DFA::ALPHABET_SIZE; ++byte)
+          minimal.byte_classes[byte] = merged[table.byte_classes[byte]];
+
+        for (const std::size_t state : queue)
+        {
+          for (const std::size_t c : columns)
+            minimal.transitions.push_back(
+                order[block[table.transitions[state * classes + c]]]);
+
+          minimal.accept_flags.push_back(table.accept_flags[state]);
+        }
+
+        return minimal;
+      }
+    };
+
+    /**
+     * @brief Picks the smallest unsigned type able to hold a state id
+     *
+     * @tparam States The number of states
+     */
+    template <std::size_t States>
+    using StaticStateId = std::conditional_t<
+        (States <= 0x100), std::uint8_t,
+        std::conditional_t<(States <= 0x10000), std::uint16_t, StateId>>;
+  } // namespace detail
+
+  /**
+   * @class StaticRegex
+   * @brief A pattern compiled to a minimal DFA at compile time
+   *
+   * @details The tables are constexpr std::arrays sized for the pattern, with
+   *          the narrowest state type that fits, so matches() compiles to a
+   *          specialized loop with no startup cost. An invalid or unsupported
+   *          pattern is a compile error. Usage:
+   *          @code
+   *          using Email = dfa::StaticRegex<"[a-z]+@[a-z]+\\.com">;
+   *          static_assert(Email::matches("joe@example.com"));
+   *          @endcode
+   *
+   * @tparam Pattern The pattern, with the same syntax as Compiler accepts
+   */
+  template <FixedString Pattern>
+  class StaticRegex
+  {
+  private:
+    static constexpr detail::StaticTable compile()
+    {
+      return detail::StaticCompiler(Pattern.view()).compile();
+    }
+
+    static constexpr std::array<std::size_t, 2> SIZES = []
+    {
+      const detail::StaticTable table = compile();
+      return std::array<std::size_t, 2>{table.accept_flags.size(),
+                                        table.class_count};
+    }();
+
+  public:
+    static constexpr std::size_t state_count = SIZES[0];
+    static constexpr std::size_t class_count = SIZES[1];
+
+    using state_type = detail::StaticStateId<state_count>;
+
+    /**
+     * @struct Tables
+     * @brief The compiled automaton, in DFA's layout
+     *
+     */
+    struct Tables
+    {
+      state_type start_state{};
+      std::array<std::uint8_t, DFA::ALPHABET_SIZE> byte_classes{};
+      std::array<state_type, state_count * class_count> transitions{};
+      std::array<std::uint8_t, state_count> accept_flags{};
+    };
+
+    static constexpr Tables tables = []
+    {
+      const detail::StaticTable table = compile();
+      Tables result;
+
+      result.start_state = static_cast<state_type>(table.start_state);
+      result.byte_classes = table.byte_classes;
+
+      for (std::size_t i = 0; i < result.transitions.size(); ++i)
+        result.transitions[i] = static_cast<state_type>(table.transitions[i]);
+
+      for (std::size_t i = 0; i < result.accept_flags.size(); ++i)
+        result.accept_flags[i] = table.accept_flags[i];
+
+      return result;
+    }();
+
+    /**
+     * @brief Checks whether the whole input is matched by the pattern
+     *
+     * @param[in] input The input to match
+     * @return true If the input is in the language of the pattern
+     */
+    [[nodiscard]] static constexpr bool matches(std::string_view input) noexcept
+    {
+      std::size_t state = tables.start_state;
+
+      for (const char character : input)
+      {
+        state = tables.transitions[state * class_count +
+                                   tables.byte_classes[static_cast<
+                                       std::uint8_t>(character)]];
+
+        if (state == DFA::DEAD_STATE)
+          return false;
+      }
+
+      return tables.accept_flags[state] & ACCEPT_AT_EOF;
+    }
+
+    /**
+     * @brief Copies the tables into a runtime DFA
+     *
+     * @return DFA The automaton
+     */
+    [[nodiscard]] static DFA to_dfa()
+    {
+      return DFA(tables.start_state, tables.byte_classes, class_count,
+                 std::vector<StateId>(tables.transitions.begin(),
+                                      tables.transitions.end()),
+                 std::vector<std::uint8_t>(tables.accept_flags.begin(),
+                                           tables.accept_flags.end()));
+    }
+  };
+} // namespace dfa
@@ -0,0 +1,46 @@
+#include "stream_matcher.h"
+
+namespace dfa
+{
+  /**
+   * @brief Construct a new StreamMatcher:: StreamMatcher object
+   *
+   * @param[in] dfa The automaton to run, which must outlive the matcher
+   */
+  StreamMatcher::StreamMatcher(const DFA &dfa)
+      : m_dfa(dfa), m_state(dfa.get_start_state()), m_offset(0),
+        m_at_start(true)
+  {
+  }
+
+  /**
+   * @brief Starts a new stream at offset 0
+   *
+   */
+  void StreamMatcher::reset() noexcept
+  {
+    m_state = m_dfa.get_start_state();
+    m_offset = 0;
+    m_at_start = true;
+  }
+
+  /**
+   * @brief Gets the DFA state after the bytes fed so far
+   *
+   * @return StateId The current state
+   */
+  StateId StreamMatcher::get_state() const noexcept
+  {
+    return m_state;
+  }
+
+  /**
+   * @brief Gets the number of bytes fed so far
+   *
+   * @return std::uint64_t The absolute offset of the next byte
+   */
+  std::uint64_t StreamMatcher::get_offset() const noexcept
+  {
+    return m_offset;
+  }
+} // namespace dfa
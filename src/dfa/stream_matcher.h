@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "dfa.h"
+
+namespace dfa
+{
+  /**
+   * @class StreamMatcher
+   * @brief Runs a DFA over input that arrives in chunks
+   *
+   * @details The matcher keeps only the current state and the absolute
+   *          offset, so a match may span any number of chunks and memory
+   *          stays constant however long the stream is. Every offset at
+   *          which the DFA accepts is reported as the end of a match; with
+   *          a DFA compiled with CompileOptions::unanchored that is the end
+   *          of every match in the stream. Matches that need the end of
+   *          input, through '$', are reported by finish().
+   */
+  class StreamMatcher
+  {
+  public:
+    explicit StreamMatcher(const DFA &dfa);
+
+    template <typename OnMatch>
+    std::size_t feed(std::span<const std::byte> chunk, OnMatch &&on_match);
+
+    template <typename OnMatch>
+    std::size_t finish(OnMatch &&on_match);
+
+    void reset() noexcept;
+
+    // Getters
+    [[nodiscard]] StateId get_state() const noexcept;
+    [[nodiscard]] std::uint64_t get_offset() const noexcept;
+
+  private:
+    const DFA &m_dfa;
+    StateId m_state;
+    std::uint64_t m_offset;
+    bool m_at_start;
+  };
+
+  /**
+   * @brief Scans the next chunk of the stream
+   *
+   * @param[in] chunk The bytes following the previous chunk
+   * @param[in] on_match Called with the absolute end offset of every match
+   *            ending in the chunk
+   * @return std::size_t The number of matches reported
+   */
+  template <typename OnMatch>
+  std::size_t StreamMatcher::feed(std::span<const std::byte> chunk,
+                                  OnMatch &&on_match)
+  {
+    std::size_t count = 0;
+
+    if (m_at_start && !chunk.empty())
+    {
+      m_at_start = false;
+
+      if (m_dfa.is_accepting(m_state))
+      {
+        on_match(m_offset);
+        ++count;
+      }
+    }
+
+    if (m_state == DFA::DEAD_STATE)
+    {
+      m_offset += chunk.size();
+      return count;
+    }
+
+    for (const std::byte byte : chunk)
+    {
+      m_state = m_dfa.next(m_state, static_cast<std::uint8_t>(byte));
+      ++m_offset;
+
+      if (m_dfa.is_accepting(m_state))
+      {
+        on_match(m_offset);
+        ++count;
+      }
+    }
+
+    return count;
+  }
+
+  /**
+   * @brief Ends the stream and resets the matcher for the next one
+   * @details Reports the match ending at the end of input that only '$'
+   *          allows, and the empty match of an empty stream
+   *
+   * @param[in] on_match Called with the absolute end offset of the match
+   * @return std::size_t The number of matches reported
+   */
+  template <typename OnMatch>
+  std::size_t StreamMatcher::finish(OnMatch &&on_match)
+  {
+    std::size_t count = 0;
+    const bool reported = m_dfa.is_accepting(m_state) && !m_at_start;
+
+    if (m_dfa.is_accepting_at_eof(m_state) && !reported)
+    {
+      on_match(m_offset);
+      ++count;
+    }
+
+    reset();
+    return count;
+  }
+} // namespace dfa
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "byte_set.h"
+
+namespace dfa
+{
+  /**
+   * @brief The NFAStateKind enum tells how a Thompson NFA state is left
+   *
+   * @details
+   *       - SYMBOL: Consumes one byte out of its byte set, then goes to out.
+   *       - EPSILON: Goes to out without consuming input.
+   *       - SPLIT: Goes to both out and out1 without consuming input.
+   *       - START_ANCHOR: Goes to out only before any input.
+   *       - END_ANCHOR: Goes to out only at the end of input.
+   *       - MATCH: Accepts.
+   */
+  enum class NFAStateKind : std::uint8_t
+  {
+    SYMBOL,
+    EPSILON,
+    SPLIT,
+    START_ANCHOR,
+    END_ANCHOR,
+    MATCH
+  };
+
+  /**
+   * @struct ThompsonNFA
+   * @brief Thompson's construction of a regex AST, with epsilon moves
+   *
+   * @details State i is left as kinds[i] tells, through out[i] and, for a
+   *          split, out1[i]. Unlike the position automaton, every operator
+   *          adds a constant number of states and edges, so the automaton
+   *          grows linearly with the expanded pattern even where followpos
+   *          grows with its square, as in (a?){n}.
+   */
+  struct ThompsonNFA
+  {
+    static constexpr std::uint32_t NONE =
+        std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<NFAStateKind> kinds;
+    std::vector<ByteSet> symbols;
+    std::vector<std::uint32_t> out;
+    std::vector<std::uint32_t> out1;
+    std::uint32_t start = NONE;
+
+    /**
+     * @brief Gets the number of states, including the match state
+     *
+     * @return std::size_t The number of states
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return kinds.size();
+    }
+  };
+} // namespace dfa
@@ -0,0 +1,475 @@
+#include <stdexcept>
+#include <string>
+#include "thompson_visitor.h"
+
+namespace dfa
+{
+  namespace
+  {
+    /**
+     * @brief Largest number of states an automaton may have
+     *
+     */
+    constexpr std::size_t MAX_STATES = std::size_t{1} << 22;
+
+    /**
+     * @brief Bytes a single state takes in the automaton
+     *
+     */
+    constexpr std::size_t STATE_BYTES =
+        sizeof(NFAStateKind) + sizeof(ByteSet) + 2 * sizeof(std::uint32_t);
+  } // namespace
+
+  /**
+   * @brief Construct a new Thompson Visitor:: Thompson Visitor object
+   *
+   * @param[in] max_memory The most bytes the automaton may take; 0 is no
+   *            limit
+   */
+  ThompsonVisitor::ThompsonVisitor(std::size_t max_memory)
+      : m_max_memory(max_memory)
+  {
+  }
+
+  /**
+   * @brief Builds the automaton of an AST, ending in a match state
+   *
+   * @param[in] tree The AST, with its root set
+   * @return ThompsonNFA The automaton
+   * @throw std::invalid_argument If the AST has nodes the automaton cannot
+   *        express
+   * @throw std::length_error If the automaton has too many states or takes
+   *        more than the memory limit
+   */
+  ThompsonNFA ThompsonVisitor::build(const ast::Arena &tree)
+  {
+    m_tree = &tree;
+    m_nfa = ThompsonNFA{};
+
+    Fragment fragment = visit(tree.get_root());
+
+    if (fragment.entry == ThompsonNFA::NONE)
+      fragment = leaf(NFAStateKind::EPSILON);
+
+    m_nfa.out[fragment.exit] = add_state(NFAStateKind::MATCH);
+    m_nfa.start = fragment.entry;
+
+    return std::move(m_nfa);
+  }
+
+  /**
+   * @brief Visits a literal node as the concatenation of its characters
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_literal_node(const ast::LiteralNode &node)
+  {
+    Fragment fragment;
+
+    for (const char character : node.value)
+      fragment = concatenate(
+          fragment, leaf(NFAStateKind::SYMBOL, literal_bytes(character)));
+
+    m_result = fragment;
+  }
+
+  /**
+   * @brief Visits a metacharacter node
+   * @details '.' behaves as a wildcard, '^' and '$' as anchors and any other
+   *          metacharacter matches itself
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_metacharacter_node(
+      const ast::MetacharacterNode &node)
+  {
+    if (node.character == '.')
+      m_result = leaf(NFAStateKind::SYMBOL, wildcard_bytes());
+
+    else if (node.character == '^' || node.character == '$')
+      m_result = anchor(node.character);
+
+    else
+      m_result = leaf(NFAStateKind::SYMBOL, literal_bytes(node.character));
+  }
+
+  /**
+   * @brief Visits a character class node
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_character_class_node(
+      const ast::CharacterClassNode &node)
+  {
+    m_result = leaf(NFAStateKind::SYMBOL, character_class_bytes(node.value));
+  }
+
+  /**
+   * @brief Visits a grouping node as the concatenation of its children
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_grouping_node(const ast::GroupingNode &node)
+  {
+    Fragment fragment;
+
+    for (const ast::NodeIndex child : node.children)
+      fragment = concatenate(fragment, visit(child));
+
+    m_result = fragment;
+  }
+
+  /**
+   * @brief Visits a quantifier node
+   * @details x{m,n} is expanded to m copies of x followed by n - m nested
+   *          optional copies, x(x(x)?)?; an unbounded maximum adds a
+   *          starred copy instead.
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument If the minimum exceeds the maximum
+   * @throw std::length_error If the expansion has too many states
+   */
+  void ThompsonVisitor::visit_quantifier_node(const ast::QuantifierNode &node)
+  {
+    const std::uint32_t min = node.min_occurrences;
+    const std::uint32_t max = node.max_occurrences;
+
+    if (min > max || min == ast::UNBOUNDED)
+      throw std::invalid_argument("Invalid quantifier bounds");
+
+    const std::size_t begin = m_nfa.size();
+    const Fragment child = visit(node.child);
+    const std::size_t end = m_nfa.size();
+
+    if (max == 0 || child.entry == ThompsonNFA::NONE)
+    {
+      m_result = Fragment{};
+      return;
+    }
+
+    const bool unbounded = max == ast::UNBOUNDED;
+    const std::uint64_t count = unbounded ? std::uint64_t{min} + 1 : max;
+
+    if ((end - begin) * count > MAX_STATES)
+      throw std::length_error("Too many states in quantifier");
+
+    // Every copy is taken before any link leaves the child
+    std::vector<Fragment> copies;
+    copies.reserve(count);
+    copies.push_back(child);
+
+    for (std::uint64_t i = 1; i < count; ++i)
+      copies.push_back(copy_of(child, begin, end));
+
+    Fragment fragment;
+
+    for (std::uint32_t i = 0; i < min; ++i)
+      fragment = concatenate(fragment, copies[i]);
+
+    if (unbounded)
+      fragment = concatenate(fragment, star(copies.back()));
+
+    else if (max > min)
+    {
+      Fragment tail = optional(copies.back());
+
+      for (std::size_t i = max - 1; i-- > min;)
+        tail = optional(concatenate(copies[i], tail));
+
+      fragment = concatenate(fragment, tail);
+    }
+
+    m_result = fragment;
+  }
+
+  /**
+   * @brief Visits an anchor node
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument If the anchor is not '^' or '$'
+   */
+  void ThompsonVisitor::visit_anchor_node(const ast::AnchorNode &node)
+  {
+    if (node.value.size() != 1)
+      throw std::invalid_argument("Invalid anchor: " + std::string(node.value));
+
+    m_result = anchor(node.value.front());
+  }
+
+  /**
+   * @brief Visits an escape sequence node
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_escape_sequence_node(
+      const ast::EscapeSequenceNode &node)
+  {
+    m_result = leaf(NFAStateKind::SYMBOL, escape_bytes(node.character));
+  }
+
+  /**
+   * @brief Visits a wildcard node
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_wildcard_node(const ast::WildcardNode &)
+  {
+    m_result = leaf(NFAStateKind::SYMBOL, wildcard_bytes());
+  }
+
+  /**
+   * @brief Visits an alternation node as a chain of splits joined again
+   *        after the alternatives
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_alternation_node(
+      const ast::AlternationNode &node)
+  {
+    std::vector<Fragment> alternatives;
+    alternatives.reserve(node.children.size());
+
+    for (const ast::NodeIndex child : node.children)
+    {
+      Fragment alternative = visit(child);
+
+      if (alternative.entry == ThompsonNFA::NONE)
+        alternative = leaf(NFAStateKind::EPSILON);
+
+      alternatives.push_back(alternative);
+    }
+
+    if (alternatives.size() < 2)
+    {
+      m_result = alternatives.empty() ? Fragment{} : alternatives.front();
+      return;
+    }
+
+    const std::uint32_t join = add_state(NFAStateKind::EPSILON);
+    std::uint32_t entry = alternatives.back().entry;
+
+    for (std::size_t i = alternatives.size() - 1; i-- > 0;)
+    {
+      const std::uint32_t split = add_state(NFAStateKind::SPLIT);
+      m_nfa.out[split] = alternatives[i].entry;
+      m_nfa.out1[split] = entry;
+      entry = split;
+    }
+
+    for (const auto &alternative : alternatives)
+      m_nfa.out[alternative.exit] = join;
+
+    m_result = {entry, join};
+  }
+
+  /**
+   * @brief Rejects boundary nodes, which need lookaround
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument Always
+   */
+  void ThompsonVisitor::visit_boundary_node(const ast::BoundaryNode &node)
+  {
+    throw std::invalid_argument("Unsupported boundary: " +
+                                std::string(node.value));
+  }
+
+  /**
+   * @brief Rejects modifier nodes, which are not supported yet
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument Always
+   */
+  void ThompsonVisitor::visit_modifier_node(const ast::ModifierNode &node)
+  {
+    throw std::invalid_argument("Unsupported modifier: " +
+                                std::string(node.value));
+  }
+
+  /**
+   * @brief Rejects invalid nodes
+   *
+   * @param[in] node The node to visit
+   * @throw std::invalid_argument Always
+   */
+  void ThompsonVisitor::visit_invalid_node(const ast::InvalidNode &node)
+  {
+    throw std::invalid_argument("Invalid token: " + std::string(node.value));
+  }
+
+  /**
+   * @brief Visits an end of input node as a '$' anchor
+   *
+   * @param[in] node The node to visit
+   */
+  void ThompsonVisitor::visit_end_of_input_node(const ast::EndOfInputNode &)
+  {
+    m_result = anchor('$');
+  }
+
+  /**
+   * @brief Visits a subtree and returns its fragment
+   *
+   * @param[in] node The root of the subtree
+   * @return Fragment The fragment, with no states if it matches only the
+   *         empty string
+   */
+  ThompsonVisitor::Fragment ThompsonVisitor::visit(ast::NodeIndex node)
+  {
+    m_tree->accept(node, *this);
+    return m_result;
+  }
+
+  /**
+   * @brief Appends a state with dangling edges
+   *
+   * @param[in] kind How the state is left
+   * @param[in] symbols The bytes a symbol state consumes
+   * @return std::uint32_t The index of the state
+   * @throw std::length_error If the automaton has too many states or takes
+   *        more than the memory limit
+   */
+  std::uint32_t ThompsonVisitor::add_state(NFAStateKind kind,
+                                           const ByteSet &symbols)
+  {
+    const std::size_t size = m_nfa.size();
+
+    if (size >= MAX_STATES)
+      throw std::length_error("Too many states in the Thompson NFA");
+
+    if (m_max_memory != 0 && (size + 1) * STATE_BYTES > m_max_memory)
+      throw std::length_error("Thompson NFA needs more than " +
+                              std::to_string(m_max_memory) + " bytes");
+
+    m_nfa.kinds.push_back(kind);
+    m_nfa.symbols.push_back(symbols);
+    m_nfa.out.push_back(ThompsonNFA::NONE);
+    m_nfa.out1.push_back(ThompsonNFA::NONE);
+
+    return static_cast<std::uint32_t>(size);
+  }
+
+  /**
+   * @brief Creates a fragment of a single state
+   *
+   * @param[in] kind How the state is left
+   * @param[in] symbols The bytes a symbol state consumes
+   * @return Fragment The fragment
+   */
+  ThompsonVisitor::Fragment ThompsonVisitor::leaf(NFAStateKind kind,
+                                                  const ByteSet &symbols)
+  {
+    const std::uint32_t state = add_state(kind, symbols);
+    return {state, state};
+  }
+
+  /**
+   * @brief Appends a copy of a built fragment at new states
+   *
+   * @param[in] fragment The fragment
+   * @param[in] begin The first state of the fragment
+   * @param[in] end One past the last state of the fragment, which must not
+   *            have edges leaving the range yet
+   * @return Fragment The copy
+   */
+  ThompsonVisitor::Fragment ThompsonVisitor::copy_of(const Fragment &fragment,
+                                                     std::size_t begin,
+                                                     std::size_t end)
+  {
+    const auto offset = static_cast<std::uint32_t>(m_nfa.size() - begin);
+
+    auto moved = [offset](std::uint32_t state)
+    { return state == ThompsonNFA::NONE ? state : state + offset; };
+
+    for (std::size_t state = begin; state < end; ++state)
+    {
+      const ByteSet symbols = m_nfa.symbols[state];
+      const std::uint32_t copy = add_state(m_nfa.kinds[state], symbols);
+
+      m_nfa.out[copy] = moved(m_nfa.out[state]);
+      m_nfa.out1[copy] = moved(m_nfa.out1[state]);
+    }
+
+    return {moved(fragment.entry), moved(fragment.exit)};
+  }
+
+  /**
+   * @brief Links two fragments matched one after the other
+   *
+   * @param[in] left The first fragment
+   * @param[in] right The second fragment
+   * @return Fragment The concatenation
+   */
+  ThompsonVisitor::Fragment ThompsonVisitor::concatenate(const Fragment &left,
+                                                         const Fragment &right)
+  {
+    if (left.entry == ThompsonNFA::NONE)
+      return right;
+
+    if (right.entry == ThompsonNFA::NONE)
+      return left;
+
+    m_nfa.out[left.exit] = right.entry;
+    return {left.entry, right.exit};
+  }
+
+  /**
+   * @brief Makes a fragment skippable
+   *
+   * @param[in] fragment The fragment
+   * @return Fragment The optional fragment
+   */
+  ThompsonVisitor::Fragment ThompsonVisitor::optional(const Fragment &fragment)
+  {
+    if (fragment.entry == ThompsonNFA::NONE)
+      return fragment;
+
+    const std::uint32_t split = add_state(NFAStateKind::SPLIT);
+    const std::uint32_t exit = add_state(NFAStateKind::EPSILON);
+
+    m_nfa.out[split] = fragment.entry;
+    m_nfa.out1[split] = exit;
+    m_nfa.out[fragment.exit] = exit;
+
+    return {split, exit};
+  }
+
+  /**
+   * @brief Applies the Kleene star to a fragment
+   *
+   * @param[in] fragment The fragment
+   * @return Fragment The starred fragment
+   */
+  ThompsonVisitor::Fragment ThompsonVisitor::star(const Fragment &fragment)
+  {
+    if (fragment.entry == ThompsonNFA::NONE)
+      return fragment;
+
+    const std::uint32_t split = add_state(NFAStateKind::SPLIT);
+    const std::uint32_t exit = add_state(NFAStateKind::EPSILON);
+
+    m_nfa.out[split] = fragment.entry;
+    m_nfa.out1[split] = exit;
+    m_nfa.out[fragment.exit] = split;
+
+    return {split, exit};
+  }
+
+  /**
+   * @brief Creates the state of a '^' or '$' anchor
+   *
+   * @param[in] character The anchor character
+   * @return Fragment The fragment of the anchor
+   * @throw std::invalid_argument If the character is not an anchor
+   */
+  ThompsonVisitor::Fragment ThompsonVisitor::anchor(char character)
+  {
+    if (character == '^')
+      return leaf(NFAStateKind::START_ANCHOR);
+
+    if (character == '$')
+      return leaf(NFAStateKind::END_ANCHOR);
+
+    throw std::invalid_argument(std::string("Invalid anchor: ") + character);
+  }
+} // namespace dfa
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../ast/arena.h"
+#include "thompson_nfa.h"
+
+namespace dfa
+{
+  /**
+   * @class ThompsonVisitor
+   * @brief Builds the Thompson NFA of an AST
+   *
+   * @details Every subtree becomes a fragment of consecutive states with
+   *          one entry and one exit whose out edge is left dangling until
+   *          the fragment is linked to what follows it. Bounded quantifiers
+   *          are expanded into copies of their child; the child is built
+   *          once and every copy reuses its states moved to new indices.
+   *          The state count is capped, and so are the bytes of the
+   *          automaton when a memory limit is given.
+   */
+  class ThompsonVisitor : public ast::AstVisitor
+  {
+  public:
+    explicit ThompsonVisitor(std::size_t max_memory = 0);
+
+    ThompsonNFA build(const ast::Arena &tree);
+
+    void visit_literal_node(const ast::LiteralNode &node) override;
+    void visit_metacharacter_node(
+        const ast::MetacharacterNode &node) override;
+
+    void visit_character_class_node(
+        const ast::CharacterClassNode &node) override;
+
+    void visit_grouping_node(const ast::GroupingNode &node) override;
+    void visit_quantifier_node(const ast::QuantifierNode &node) override;
+    void visit_anchor_node(const ast::AnchorNode &node) override;
+    void visit_escape_sequence_node(
+        const ast::EscapeSequenceNode &node) override;
+
+    void visit_wildcard_node(const ast::WildcardNode &node) override;
+    void visit_alternation_node(const ast::AlternationNode &node) override;
+    void visit_boundary_node(const ast::BoundaryNode &node) override;
+    void visit_modifier_node(const ast::ModifierNode &node) override;
+    void visit_invalid_node(const ast::InvalidNode &node) override;
+    void visit_end_of_input_node(const ast::EndOfInputNode &node) override;
+
+  private:
+    /**
+     * @struct Fragment
+     * @brief The entry and the exit state of a visited subtree
+     *
+     */
+    struct Fragment
+    {
+      std::uint32_t entry = ThompsonNFA::NONE;
+      std::uint32_t exit = ThompsonNFA::NONE;
+    };
+
+    const ast::Arena *m_tree = nullptr;
+    std::size_t m_max_memory = 0;
+    ThompsonNFA m_nfa;
+    Fragment m_result;
+
+    // Helper functions
+    Fragment visit(ast::NodeIndex node);
+    std::uint32_t add_state(NFAStateKind kind, const ByteSet &symbols = {});
+    Fragment leaf(NFAStateKind kind, const ByteSet &symbols = {});
+    Fragment copy_of(const Fragment &fragment, std::size_t begin,
+                     std::size_t end);
+    Fragment concatenate(const Fragment &left, const Fragment &right);
+    Fragment optional(const Fragment &fragment);
+    Fragment star(const Fragment &fragment);
+    Fragment anchor(char character);
+  };
+} // namespace dfa
@@ -18,13 +18,21 @@ namespace lex
     {
     }
 
-    void on_token(std::shared_ptr<Token> token) override
+    void on_tokens(std::span<const std::shared_ptr<Token>> tokens) override
     {
-      if (logger)
-        logger->debug("TokenLogger: {}", token->to_string());
-
-      else
+      if (!logger)
         throw std::runtime_error("TokenLogger: logger is null");
+
+      // One level check per batch; compiled out, there is no loop at all
+#if REGEX_DFA_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+      if (!logger->should_log(spdlog::level::debug))
+        return;
+
+      for (const auto &token : tokens)
+        REGEX_DFA_LOG_DEBUG(logger, "TokenLogger: {}", token->to_string());
+#else
+      (void)tokens;
+#endif
     }
 
   private:
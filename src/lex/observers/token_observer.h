@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include "../token/token.h"
 
 namespace lex
@@ -8,12 +9,15 @@ namespace lex
   /**
    * @class TokenObserver
    * @brief Interface for classes that want to observe tokens as they are
+   *        created
    *
+   * @details Tokens are delivered in batches, one call per batch rather
+   *          than one per token. The span is only valid during the call.
    */
   class TokenObserver
   {
   public:
     virtual ~TokenObserver() = default;
-    virtual void on_token(std::shared_ptr<Token> token) = 0;
+    virtual void on_tokens(std::span<const std::shared_ptr<Token>> tokens) = 0;
   };
-}
\ No newline at end of file
+}
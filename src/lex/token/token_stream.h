@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "token.h"
+
+namespace lex
+{
+  /**
+   * @struct CompactToken
+   * @brief Plain value token: its type and where its text lies in the
+   *        pattern
+   *
+   */
+  struct CompactToken
+  {
+    TokenType type = TokenType::INVALID;
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+  };
+
+  /**
+   * @class TokenStream
+   * @brief Contiguous sequence of CompactTokens over a source pattern
+   *
+   * @details Token values are string_views into the source, so the stream
+   *          must not outlive the pattern it was scanned from.
+   */
+  class TokenStream
+  {
+  public:
+    using const_iterator = std::vector<CompactToken>::const_iterator;
+
+    TokenStream() = default;
+
+    /**
+     * @brief Construct a new Token Stream:: Token Stream object
+     *
+     * @param[in] source The pattern the tokens refer to
+     */
+    explicit TokenStream(std::string_view source) : m_source(source) {}
+
+    /**
+     * @brief Appends a token
+     *
+     * @param[in] type The type of the token
+     * @param[in] offset Index of the first byte of the token in the source
+     * @param[in] length The number of bytes of the token
+     */
+    void push_back(TokenType type, std::size_t offset, std::size_t length)
+    {
+      m_tokens.push_back({type, static_cast<std::uint32_t>(offset),
+                          static_cast<std::uint32_t>(length)});
+    }
+
+    /**
+     * @brief Reserves room for tokens
+     *
+     * @param[in] count The number of tokens to reserve
+     */
+    void reserve(std::size_t count)
+    {
+      m_tokens.reserve(count);
+    }
+
+    /**
+     * @brief Gets the text of a token
+     *
+     * @param[in] token A token of this stream
+     * @return std::string_view The token's bytes in the source
+     */
+    [[nodiscard]] std::string_view get_value(
+        const CompactToken &token) const noexcept
+    {
+      return m_source.substr(token.offset, token.length);
+    }
+
+    [[nodiscard]] const CompactToken &operator[](
+        std::size_t index) const noexcept
+    {
+      return m_tokens[index];
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return m_tokens.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+      return m_tokens.empty();
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+      return m_tokens.begin();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+      return m_tokens.end();
+    }
+
+    [[nodiscard]] std::string_view get_source() const noexcept
+    {
+      return m_source;
+    }
+
+  private:
+    std::string_view m_source;
+    std::vector<CompactToken> m_tokens;
+  };
+} // namespace lex
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <span>
 #include <vector>
 #include "observers/token_observer.h"
 
@@ -14,6 +16,9 @@ namespace lex
   class TokenFactory
   {
   public:
+    // Most tokens an observer receives in one call
+    static constexpr std::size_t BATCH_SIZE = 1024;
+
     TokenFactory() = default;
 
     /**
@@ -26,6 +31,16 @@ namespace lex
       m_observers.emplace_back(observer);
     }
 
+    /**
+     * @brief Checks whether any observer is registered
+     *
+     * @return true If tokens have to be reported
+     */
+    [[nodiscard]] bool has_observers() const noexcept
+    {
+      return !m_observers.empty();
+    }
+
     /**
      * @brief Create a token object
      *
@@ -36,28 +51,35 @@ namespace lex
      */
     std::shared_ptr<Token> create_token(TokenType type,
                                         const std::string &value,
-                                        std::size_t position)
+                                        std::size_t position) const
     {
-      auto token = std::make_shared<RegexToken>(type, value,
-                                                position);
-
-      notify_observers(token);
-      return token;
+      return std::make_shared<RegexToken>(type, value, position);
     }
 
-  private:
-    std::vector<std::shared_ptr<TokenObserver>> m_observers;
-
-    // Helper functions
     /**
-     * @brief Notify all observers that a token has been created
+     * @brief Notify all observers that tokens have been created
+     * @details Every observer gets the tokens in batches of at most
+     *          BATCH_SIZE, one virtual call per batch. Without observers
+     *          nothing is done.
      *
-     * @param[in] token Token that was created
+     * @param[in] tokens Tokens that were created
      */
-    void notify_observers(const std::shared_ptr<Token> &token)
+    void notify_observers(std::span<const std::shared_ptr<Token>> tokens) const
     {
-      for (const auto &observer : m_observers)
-        observer->on_token(token);
+      if (m_observers.empty())
+        return;
+
+      for (std::size_t first = 0; first < tokens.size(); first += BATCH_SIZE)
+      {
+        const auto batch = tokens.subspan(
+            first, std::min(BATCH_SIZE, tokens.size() - first));
+
+        for (const auto &observer : m_observers)
+          observer->on_tokens(batch);
+      }
     }
+
+  private:
+    std::vector<std::shared_ptr<TokenObserver>> m_observers;
   };
 } // namespace lex
\ No newline at end of file
@@ -1,50 +1,214 @@
-#include <boost/regex.hpp>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 #include "lexer.h"
 
 namespace lexer
 {
+  namespace
+  {
+    /**
+     * @brief The CharKind enum groups input bytes by how the scanner
+     *        starts a token on them
+     *
+     */
+    enum class CharKind : std::uint8_t
+    {
+      LITERAL,
+      GROUP_OPEN,
+      GROUP_CLOSE,
+      CLASS_OPEN,
+      BRACE_OPEN,
+      QUANTIFIER,
+      ANCHOR,
+      WILDCARD,
+      ALTERNATION,
+      ESCAPE,
+      DIGIT
+    };
+
+    /**
+     * @brief Lookup table classifying every byte in a single load
+     *
+     */
+    constexpr std::array<CharKind, 256> CHAR_KINDS = []
+    {
+      std::array<CharKind, 256> table{};
+      table.fill(CharKind::LITERAL);
+
+      for (unsigned char digit = '0'; digit <= '9'; ++digit)
+        table[digit] = CharKind::DIGIT;
+
+      table['('] = CharKind::GROUP_OPEN;
+      table[')'] = CharKind::GROUP_CLOSE;
+      table['['] = CharKind::CLASS_OPEN;
+      table['{'] = CharKind::BRACE_OPEN;
+      table['*'] = CharKind::QUANTIFIER;
+      table['+'] = CharKind::QUANTIFIER;
+      table['?'] = CharKind::QUANTIFIER;
+      table['^'] = CharKind::ANCHOR;
+      table['$'] = CharKind::ANCHOR;
+      table['.'] = CharKind::WILDCARD;
+      table['|'] = CharKind::ALTERNATION;
+      table['\\'] = CharKind::ESCAPE;
+
+      return table;
+    }();
+
+    /**
+     * @brief Classifies a byte of the input
+     *
+     * @param[in] character The byte to classify
+     * @return CharKind The kind of the byte
+     */
+    constexpr CharKind kind_of(char character) noexcept
+    {
+      return CHAR_KINDS[static_cast<unsigned char>(character)];
+    }
+  } // namespace
+
   /**
    * @brief Construct a new Lexer:: Lexer object
    *
    * @param[in] input The regex string to tokenize
    */
   Lexer::Lexer(const std::string &input)
-      : m_input(input), m_logger(logger::Logger::get_logger()),
+      : m_input(input),
         m_token_factory(std::make_shared<lex::TokenFactory>())
   {
-    m_logger->debug("Lexer: Tokenizing input: {}", m_input);
+    REGEX_DFA_LOG_DEBUG(logger::Logger::get_logger(),
+                        "Lexer: Tokenizing input: {}", m_input);
   }
 
   /**
-   * @brief Tokenize the input string
+   * @brief Scan the input string in a single pass
+   * @details Bracket expressions, {m,n} quantifiers, escape sequences and
+   *          (?flags) modifiers are each returned as one token. Every other
+   *          byte forms a token on its own. The tokens are plain values in
+   *          one buffer and refer to the lexer's copy of the input, so the
+   *          stream must not outlive the lexer.
    *
-   * @return std::vector<std::shared_ptr<Token>> List of tokens
+   * @return lex::TokenStream The tokens
+   * @throw std::length_error If the input does not fit 32-bit offsets
    */
-  std::vector<std::shared_ptr<lex::Token>> Lexer::tokenize() const
+  lex::TokenStream Lexer::scan() const
   {
-    std::vector<std::shared_ptr<lex::Token>> tokens;
+    if (m_input.size() > std::numeric_limits<std::uint32_t>::max())
+      throw std::length_error("Lexer: input too long");
 
-    boost::regex pattern(R"((\(|\)|\[|\]|\{|\}|\*|\+|\?|\||\\|\^|\$|\.|\d|\w|\s))");
+    lex::TokenStream tokens(m_input);
+    tokens.reserve(m_input.size());
 
-    boost::smatch matches;
-    std::string::const_iterator start = m_input.begin();
-    std::string::const_iterator end = m_input.end();
+    std::size_t position = 0;
 
-    while (boost::regex_search(start, end, matches, pattern))
+    while (position < m_input.size())
     {
-      std::string value = matches[0];
-      std::size_t position = std::distance(m_input.begin(), matches[0].first);
+      lex::TokenType type = lex::TokenType::LITERAL;
+      std::size_t end = position + 1;
+
+      switch (kind_of(m_input[position]))
+      {
+      case CharKind::LITERAL:
+      case CharKind::DIGIT:
+        break;
 
-      lex::TokenType type = determine_type(value);
-      auto token = m_token_factory->create_token(type, value, position);
+      case CharKind::GROUP_OPEN:
+        type = lex::TokenType::GROUPING;
 
-      tokens.emplace_back(token);
-      start = matches[0].second;
+        if (std::size_t modifier_end = scan_modifier(position);
+            modifier_end != std::string::npos)
+        {
+          type = lex::TokenType::MODIFIER;
+          end = modifier_end;
+        }
+        break;
+
+      case CharKind::GROUP_CLOSE:
+        type = lex::TokenType::GROUPING;
+        break;
+
+      case CharKind::CLASS_OPEN:
+        end = scan_character_class(position);
+        type = end == std::string::npos ? lex::TokenType::INVALID
+                                        : lex::TokenType::CHARACTER_CLASS;
+
+        if (end == std::string::npos)
+          end = m_input.size();
+        break;
+
+      case CharKind::BRACE_OPEN:
+        if (std::size_t quantifier_end = scan_quantifier(position);
+            quantifier_end != std::string::npos)
+        {
+          type = lex::TokenType::QUANTIFIER;
+          end = quantifier_end;
+        }
+        break;
+
+      case CharKind::QUANTIFIER:
+        type = lex::TokenType::QUANTIFIER;
+        break;
+
+      case CharKind::ANCHOR:
+        type = lex::TokenType::ANCHOR;
+        break;
+
+      case CharKind::WILDCARD:
+        type = lex::TokenType::WILDCARD;
+        break;
+
+      case CharKind::ALTERNATION:
+        type = lex::TokenType::ALTERNATION;
+        break;
+
+      case CharKind::ESCAPE:
+        if (position + 1 == m_input.size())
+          type = lex::TokenType::INVALID;
+
+        else
+        {
+          const char escaped = m_input[position + 1];
+
+          type = escaped == 'b' || escaped == 'B'
+                     ? lex::TokenType::BOUNDARY
+                     : lex::TokenType::ESCAPE_SEQUENCE;
+          end = position + 2;
+        }
+        break;
+      }
+
+      tokens.push_back(type, position, end - position);
+
+      position = end;
     }
 
     return tokens;
   }
 
+  /**
+   * @brief Tokenize the input string into Token objects
+   * @details Adapter over scan() for code using the Token interface; every
+   *          token is allocated through the factory, and the whole list is
+   *          reported to the registered observers in batches
+   *
+   * @return std::vector<std::shared_ptr<Token>> List of tokens
+   */
+  std::vector<std::shared_ptr<lex::Token>> Lexer::tokenize() const
+  {
+    const lex::TokenStream stream = scan();
+    std::vector<std::shared_ptr<lex::Token>> tokens;
+
+    tokens.reserve(stream.size());
+
+    for (const lex::CompactToken &token : stream)
+      tokens.emplace_back(m_token_factory->create_token(
+          token.type, std::string(stream.get_value(token)), token.offset));
+
+    m_token_factory->notify_observers(tokens);
+    return tokens;
+  }
+
   /**
    * @brief Add an observer to be notified when a token is created
    *
@@ -53,67 +217,102 @@ namespace lexer
   void Lexer::register_observer(
       std::shared_ptr<lex::TokenObserver> observer) noexcept
   {
-    m_observers.emplace_back(observer);
     m_token_factory->register_observer(observer);
   }
 
   /**
-   * @brief Determine the type of the token
+   * @brief Find the end of the bracket expression starting at position
+   * @details A ']' right after the opening bracket (or after '^') is taken
+   *          literally, and backslashes escape the next byte
    *
-   * @param[in] value Value of the token
-   * @return lex::TokenType Type of the token
-   * @throw std::runtime_error If the token type cannot be determined
+   * @param[in] position Index of the opening '['
+   * @return std::size_t Index one past the closing ']', or npos if the
+   *         expression is never closed
    */
-  lex::TokenType Lexer::determine_type(const std::string &value) const
+  std::size_t Lexer::scan_character_class(std::size_t position) const noexcept
   {
-    boost::regex grouping_regex(R"([\(\)\[\]\{\}])");
-    boost::regex metacharacter_regex(R"([\\^$.*+?])");
-    boost::regex literal_regex(R"(\d+|\w+|\s+)");
-    boost::regex quantifier_regex(R"(\{\d*,?\d*\})");
-    boost::regex character_class_regex(R"(\[[^\]]*\])");
-    boost::regex boundary_regex(R"(\b)");
-    boost::regex modifier_regex(R"(\\[ig])");
-    boost::regex alternation_regex(R"(\|)");
-    boost::regex escape_sequence_regex(R"(\\[dws])");
+    std::size_t index = position + 1;
+
+    if (index < m_input.size() && m_input[index] == '^')
+      ++index;
+
+    if (index < m_input.size() && m_input[index] == ']')
+      ++index;
+
+    while (index < m_input.size())
+    {
+      if (m_input[index] == '\\')
+        index += 2;
 
-    if (boost::regex_match(value, grouping_regex))
-      return lex::TokenType::GROUPING;
+      else if (m_input[index] == ']')
+        return index + 1;
 
-    else if (boost::regex_match(value, metacharacter_regex))
-      return lex::TokenType::METACHARACTER;
+      else
+        ++index;
+    }
 
-    else if (boost::regex_match(value, literal_regex))
-      return lex::TokenType::LITERAL;
+    return std::string::npos;
+  }
 
-    else if (boost::regex_match(value, quantifier_regex))
-      return lex::TokenType::QUANTIFIER;
+  /**
+   * @brief Find the end of the {m}, {m,} or {m,n} quantifier at position
+   *
+   * @param[in] position Index of the opening '{'
+   * @return std::size_t Index one past the closing '}', or npos if the
+   *         brace does not start a quantifier
+   */
+  std::size_t Lexer::scan_quantifier(std::size_t position) const noexcept
+  {
+    std::size_t index = position + 1;
+    const std::size_t digits_start = index;
 
-    else if (boost::regex_match(value, character_class_regex))
-      return lex::TokenType::CHARACTER_CLASS;
+    while (index < m_input.size() && kind_of(m_input[index]) == CharKind::DIGIT)
+      ++index;
 
-    else if (boost::regex_match(value, boundary_regex))
-      return lex::TokenType::BOUNDARY;
+    if (index == digits_start)
+      return std::string::npos;
 
-    else if (boost::regex_match(value, modifier_regex))
-      return lex::TokenType::MODIFIER;
+    if (index < m_input.size() && m_input[index] == ',')
+    {
+      ++index;
 
-    else if (boost::regex_match(value, alternation_regex))
-      return lex::TokenType::ALTERNATION;
+      while (index < m_input.size() &&
+             kind_of(m_input[index]) == CharKind::DIGIT)
+        ++index;
+    }
 
-    else if (boost::regex_match(value, escape_sequence_regex))
-      return lex::TokenType::ESCAPE_SEQUENCE;
+    if (index < m_input.size() && m_input[index] == '}')
+      return index + 1;
+
+    return std::string::npos;
+  }
+
+  /**
+   * @brief Find the end of the (?flags) modifier at position
+   *
+   * @param[in] position Index of the opening '('
+   * @return std::size_t Index one past the closing ')', or npos if the
+   *         parenthesis does not start a modifier
+   */
+  std::size_t Lexer::scan_modifier(std::size_t position) const noexcept
+  {
+    std::size_t index = position + 1;
 
-    else if (value == ".")
-      return lex::TokenType::WILDCARD;
+    if (index >= m_input.size() || m_input[index] != '?')
+      return std::string::npos;
 
-    else if (value == "$")
-      return lex::TokenType::ANCHOR;
+    ++index;
+    const std::size_t flags_start = index;
 
-    else if (value == "")
-      return lex::TokenType::END_OF_INPUT;
+    while (index < m_input.size() &&
+           ((m_input[index] >= 'a' && m_input[index] <= 'z') ||
+            m_input[index] == '-'))
+      ++index;
 
-    else
+    if (index == flags_start || index >= m_input.size() ||
+        m_input[index] != ')')
+      return std::string::npos;
 
-      return lex::TokenType::INVALID;
+    return index + 1;
   }
-}
\ No newline at end of file
+}
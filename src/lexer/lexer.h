@@ -5,6 +5,7 @@
 
 #include "../lex/observers/token_observer.h"
 #include "../lex/token_factory.h"
+#include "../lex/token/token_stream.h"
 #include "../utils/logger.h"
 
 namespace lexer
@@ -22,18 +23,18 @@ namespace lexer
     explicit Lexer(const std::string &input);
 
     // Functions
+    lex::TokenStream scan() const;
     std::vector<std::shared_ptr<lex::Token>> tokenize() const;
     void register_observer(
         std::shared_ptr<lex::TokenObserver> observer) noexcept;
 
   private:
     std::string m_input;
-    std::vector<std::shared_ptr<lex::TokenObserver>> m_observers;
     std::shared_ptr<lex::TokenFactory> m_token_factory;
-    std::shared_ptr<spdlog::logger> m_logger;
 
     // Helper functions
-    lex::TokenType determine_type(const std::string &value) const;
-    void notify_observers(std::shared_ptr<lex::Token> token) const;
+    std::size_t scan_character_class(std::size_t position) const noexcept;
+    std::size_t scan_quantifier(std::size_t position) const noexcept;
+    std::size_t scan_modifier(std::size_t position) const noexcept;
   };
 } // namespace lexer
\ No newline at end of file
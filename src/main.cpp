@@ -1,15 +1,153 @@
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
 
 // Project Files
 #include "utils/logger.h"
-#include "ast/ast_builder.h"
+#include "dfa/code_generator.h"
+#include "dfa/compiler.h"
+#include "dfa/dfa_file.h"
 
-int main()
+namespace
+{
+  /**
+   * @struct LogFlusher
+   * @brief Shuts spdlog down when main returns, so an async logger writes
+   *        its queued messages before the process exits
+   *
+   */
+  struct LogFlusher
+  {
+    ~LogFlusher()
+    {
+      spdlog::shutdown();
+    }
+  };
+
+  /**
+   * @brief Reads a pattern file, one pattern per line
+   *
+   * @param[in] path The path of the pattern file
+   * @return std::vector<std::string> The non-empty lines of the file
+   * @throw std::runtime_error If the file cannot be read
+   */
+  std::vector<std::string> read_patterns(const std::string &path)
+  {
+    std::ifstream input(path);
+
+    if (!input)
+      throw std::runtime_error("Cannot open pattern file " + path);
+
+    std::vector<std::string> patterns;
+
+    for (std::string line; std::getline(input, line);)
+    {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+
+      if (!line.empty())
+        patterns.push_back(std::move(line));
+    }
+
+    return patterns;
+  }
+
+  /**
+   * @brief Precompiles a pattern file into a binary DFA file
+   * @details Pattern i of the file, counting non-empty lines from 0, is
+   *          reported as pattern id i when the DFA is loaded
+   *
+   * @param[in] patterns_path The pattern file
+   * @param[in] output_path The DFA file to write
+   */
+  void precompile(const std::string &patterns_path,
+                  const std::string &output_path)
+  {
+    auto &logger = logger::Logger::get_logger();
+    dfa::Compiler compiler;
+    const auto machine = compiler.compile_set(read_patterns(patterns_path));
+
+    dfa::DFAFile::save(machine, output_path);
+
+    logger->info("Wrote {} ({} patterns, {} states)", output_path,
+                 compiler.get_stats().patterns,
+                 compiler.get_stats().dfa_states);
+  }
+
+  /**
+   * @brief Generates a C++ header with the DFA of a pattern file
+   * @details Pattern i of the file, counting non-empty lines from 0, is
+   *          reported as pattern id i by the generated matching_patterns()
+   *
+   * @param[in] patterns_path The pattern file
+   * @param[in] output_path The header to write
+   * @param[in] namespace_name The namespace of the generated code
+   */
+  void generate(const std::string &patterns_path,
+                const std::string &output_path,
+                const std::string &namespace_name)
+  {
+    auto &logger = logger::Logger::get_logger();
+    dfa::Compiler compiler;
+    const auto patterns = read_patterns(patterns_path);
+    const auto machine = compiler.compile_set(patterns);
+
+    dfa::CodeGenerator::save(machine, patterns, output_path,
+                             {.namespace_name = namespace_name});
+
+    logger->info("Wrote {} ({} patterns, {} states)", output_path,
+                 compiler.get_stats().patterns,
+                 compiler.get_stats().dfa_states);
+  }
+} // namespace
+
+int main(int argc, char *argv[])
 {
   auto &logger = logger::Logger::get_logger();
-  ast::ConcreteBuilder builder;
+  const LogFlusher flusher;
+
+  try
+  {
+    if (argc > 1 && std::string_view(argv[1]) == "compile")
+    {
+      if (argc != 4)
+      {
+        logger->error("Usage: {} compile <pattern-file> <output.dfa>",
+                      argv[0]);
+        return 2;
+      }
+
+      precompile(argv[2], argv[3]);
+      return 0;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "generate")
+    {
+      if (argc != 4 && argc != 5)
+      {
+        logger->error(
+            "Usage: {} generate <pattern-file> <output.h> [namespace]",
+            argv[0]);
+        return 2;
+      }
+
+      generate(argv[2], argv[3], argc == 5 ? argv[4] : "regex_dfa_generated");
+      return 0;
+    }
 
-  auto root = builder.literal("abc").build();
+    const std::string pattern = argc > 1 ? argv[1] : "(a|b)*abb";
+    dfa::Compiler compiler;
+    auto machine = compiler.compile(pattern);
 
-  logger->debug(builder.to_string());
+    logger->info("DFA for {} ({} states, {} removed by minimization):\n{}",
+                 pattern, compiler.get_stats().dfa_states,
+                 compiler.get_stats().states_removed, machine.to_string());
+  }
+  catch (const std::exception &e)
+  {
+    logger->error("{}", e.what());
+    return 1;
+  }
 }
@@ -19,7 +19,7 @@ namespace parser
    *
    */
   template <typename Iterator>
-  struct RegexGrammar : qi::grammar<Iterator, ast::AST_ptr(), ascii::space_type>
+  struct RegexGrammar : qi::grammar<Iterator, ast::NodeIndex(), ascii::space_type>
   {
     /**
      * @brief Construct a new Regex Grammar:: Regex Grammar object
@@ -44,10 +44,10 @@ namespace parser
       literal = char_("a-zA-Z0-9");
     }
 
-    qi::rule<Iterator, ast::AST_ptr(), ascii::space_type> start;
-    qi::rule<Iterator, ast::AST_ptr(), ascii::space_type> term;
-    qi::rule<Iterator, ast::AST_ptr(), ascii::space_type> factor;
-    qi::rule<Iterator, ast::AST_ptr(), ascii::space_type> primary;
-    qi::rule<Iterator, ast::AST_ptr(), ascii::space_type> literal;
+    qi::rule<Iterator, ast::NodeIndex(), ascii::space_type> start;
+    qi::rule<Iterator, ast::NodeIndex(), ascii::space_type> term;
+    qi::rule<Iterator, ast::NodeIndex(), ascii::space_type> factor;
+    qi::rule<Iterator, ast::NodeIndex(), ascii::space_type> primary;
+    qi::rule<Iterator, ast::NodeIndex(), ascii::space_type> literal;
   };
 } // namespace parser
\ No newline at end of file
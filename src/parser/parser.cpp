@@ -0,0 +1,315 @@
+#include <stdexcept>
+#include "parser.h"
+
+namespace parser
+{
+  namespace
+  {
+    /**
+     * @brief Builds the error message for a token the parser cannot use
+     *
+     * @param[in] message What went wrong
+     * @param[in] value The text of the offending token
+     * @param[in] position The position of the offending token
+     * @return std::string The error message
+     */
+    std::string error_at(const std::string &message, std::string_view value,
+                         std::size_t position)
+    {
+      return "Parser: " + message + " '" + std::string(value) +
+             "' at position " + std::to_string(position);
+    }
+
+    /**
+     * @brief Parses a decimal quantifier bound
+     *
+     * @param[in] digits The digits of the bound
+     * @return std::uint32_t The bound
+     * @throw std::invalid_argument If the bound does not fit a QuantifierNode
+     */
+    std::uint32_t parse_bound(std::string_view digits)
+    {
+      std::uint64_t bound = 0;
+
+      for (const char digit : digits)
+      {
+        bound = bound * 10 + static_cast<std::uint64_t>(digit - '0');
+
+        if (bound >= ast::UNBOUNDED)
+          throw std::invalid_argument("Parser: quantifier bound too large");
+      }
+
+      return static_cast<std::uint32_t>(bound);
+    }
+  } // namespace
+
+  /**
+   * @brief Construct a new Parser:: Parser object
+   *
+   * @param[in] tokens The tokens produced by the lexer
+   */
+  Parser::Parser(lex::TokenStream tokens)
+      : m_tokens(std::move(tokens)), m_current(0), m_depth(0)
+  {
+  }
+
+  /**
+   * @brief Parses the whole token stream
+   *
+   * @return ast::Arena The AST, rooted at the top-level alternation
+   * @throw std::invalid_argument If the tokens do not form a valid regex
+   */
+  ast::Arena Parser::parse()
+  {
+    m_current = 0;
+    m_depth = 0;
+    m_builder.reset();
+
+    // Every token yields at most one node, plus the groups of the sequences
+    m_builder.get_arena().reserve(m_tokens.size() * 2 + 1, m_tokens.size());
+
+    const ast::NodeIndex root = parse_alternation();
+
+    if (!at_end())
+      throw std::invalid_argument(
+          error_at("unexpected", value_of(peek()), peek().offset));
+
+    m_builder.get_arena().set_root(root);
+    return m_builder.release();
+  }
+
+  /**
+   * @brief Parses sequences separated by '|'
+   *
+   * @return ast::NodeIndex The alternation, or the single sequence
+   */
+  ast::NodeIndex Parser::parse_alternation()
+  {
+    ast::NodeIndex node = parse_sequence();
+
+    if (!check(lex::TokenType::ALTERNATION, nullptr))
+      return node;
+
+    ++m_current;
+    const ast::NodeIndex right = parse_sequence();
+    node = m_builder.alternation(node, right).build();
+
+    while (check(lex::TokenType::ALTERNATION, nullptr))
+    {
+      ++m_current;
+      m_builder.add_child(node, parse_sequence());
+    }
+
+    return node;
+  }
+
+  /**
+   * @brief Parses the repeats matched one after the other
+   *
+   * @return ast::NodeIndex The grouping of the repeats, or the single repeat
+   */
+  ast::NodeIndex Parser::parse_sequence()
+  {
+    std::vector<ast::NodeIndex> children;
+
+    while (!at_end() && !check(lex::TokenType::ALTERNATION, nullptr) &&
+           !check(lex::TokenType::GROUPING, ")"))
+      children.push_back(parse_repeat());
+
+    if (children.size() == 1)
+      return children.front();
+
+    return m_builder.grouping(children).build();
+  }
+
+  /**
+   * @brief Parses an atom followed by any number of quantifiers
+   *
+   * @return ast::NodeIndex The quantified atom
+   * @throw std::invalid_argument If the quantifiers nest too deeply
+   */
+  ast::NodeIndex Parser::parse_repeat()
+  {
+    ast::NodeIndex node = parse_atom();
+    std::size_t depth = m_depth;
+
+    while (check(lex::TokenType::QUANTIFIER, nullptr))
+    {
+      const std::string_view value = value_of(peek());
+
+      if (++depth > MAX_DEPTH)
+        throw std::invalid_argument(
+            error_at("quantifiers nested too deeply", value, peek().offset));
+
+      ++m_current;
+      node = parse_quantifier(node, value);
+    }
+
+    return node;
+  }
+
+  /**
+   * @brief Parses a single atom
+   *
+   * @return ast::NodeIndex The atom
+   * @throw std::invalid_argument If the token cannot start an atom, or a
+   *        group nests too deeply
+   */
+  ast::NodeIndex Parser::parse_atom()
+  {
+    const lex::CompactToken &token = peek();
+    const std::string_view value = value_of(token);
+
+    ++m_current;
+
+    switch (token.type)
+    {
+    case lex::TokenType::LITERAL:
+      return m_builder.literal(value).build();
+
+    case lex::TokenType::METACHARACTER:
+      return m_builder.metacharacter(value.front()).build();
+
+    case lex::TokenType::CHARACTER_CLASS:
+      return m_builder.character_class(value).build();
+
+    case lex::TokenType::ESCAPE_SEQUENCE:
+      return m_builder.escape_sequence(value.back()).build();
+
+    case lex::TokenType::WILDCARD:
+      return m_builder.wildcard().build();
+
+    case lex::TokenType::ANCHOR:
+      return m_builder.anchor(value.front()).build();
+
+    case lex::TokenType::BOUNDARY:
+      return m_builder.boundary(value.back()).build();
+
+    case lex::TokenType::MODIFIER:
+      return m_builder.modifier(value[2]).build();
+
+    case lex::TokenType::END_OF_INPUT:
+      return m_builder.end_of_input().build();
+
+    case lex::TokenType::GROUPING:
+      if (value == "(")
+      {
+        if (++m_depth > MAX_DEPTH)
+          throw std::invalid_argument(
+              error_at("groups nested too deeply", value, token.offset));
+
+        const ast::NodeIndex inner = parse_alternation();
+        --m_depth;
+
+        if (!check(lex::TokenType::GROUPING, ")"))
+          throw std::invalid_argument(
+              error_at("unclosed group", value, token.offset));
+
+        ++m_current;
+        return m_builder.grouping(inner).build();
+      }
+      break;
+
+    case lex::TokenType::QUANTIFIER:
+      throw std::invalid_argument(
+          error_at("nothing to repeat", value, token.offset));
+
+    default:
+      break;
+    }
+
+    throw std::invalid_argument(error_at("unexpected", value, token.offset));
+  }
+
+  /**
+   * @brief Wraps a node in the quantifier given by its token value
+   *
+   * @param[in] node The node to quantify
+   * @param[in] value The quantifier token: '*', '+', '?' or "{m,n}"
+   * @return ast::NodeIndex The quantifier node
+   * @throw std::invalid_argument If the bounds are invalid
+   */
+  ast::NodeIndex Parser::parse_quantifier(ast::NodeIndex node,
+                                          std::string_view value)
+  {
+    std::uint32_t min = 0;
+    std::uint32_t max = ast::UNBOUNDED;
+
+    if (value == "+")
+      min = 1;
+
+    else if (value == "?")
+      max = 1;
+
+    else if (value != "*")
+    {
+      const std::string_view bounds = value.substr(1, value.size() - 2);
+      const std::size_t comma = bounds.find(',');
+
+      min = parse_bound(bounds.substr(0, comma));
+
+      if (comma == std::string_view::npos)
+        max = min;
+
+      else if (comma + 1 < bounds.size())
+        max = parse_bound(bounds.substr(comma + 1));
+
+      if (min > max)
+        throw std::invalid_argument("Parser: invalid quantifier " +
+                                    std::string(value));
+    }
+
+    return m_builder.quantifier(node, min, max).build();
+  }
+
+  /**
+   * @brief Checks whether every token has been consumed
+   *
+   * @return true If there are no tokens left
+   */
+  bool Parser::at_end() const noexcept
+  {
+    return m_current >= m_tokens.size();
+  }
+
+  /**
+   * @brief Checks the type, and optionally the value, of the next token
+   *
+   * @param[in] type The expected type
+   * @param[in] value The expected value, or nullptr to accept any
+   * @return true If the next token matches
+   */
+  bool Parser::check(lex::TokenType type, const char *value) const
+  {
+    if (at_end() || m_tokens[m_current].type != type)
+      return false;
+
+    return value == nullptr || value_of(m_tokens[m_current]) == value;
+  }
+
+  /**
+   * @brief Gets the next token
+   *
+   * @return const lex::CompactToken& The next token
+   * @throw std::invalid_argument If there are no tokens left
+   */
+  const lex::CompactToken &Parser::peek() const
+  {
+    if (at_end())
+      throw std::invalid_argument("Parser: unexpected end of pattern");
+
+    return m_tokens[m_current];
+  }
+
+  /**
+   * @brief Gets the text of a token
+   *
+   * @param[in] token A token of the stream
+   * @return std::string_view The token's bytes in the pattern
+   */
+  std::string_view Parser::value_of(
+      const lex::CompactToken &token) const noexcept
+  {
+    return m_tokens.get_value(token);
+  }
+} // namespace parser
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "../ast/ast_builder.h"
+#include "../lex/token/token_stream.h"
+
+namespace parser
+{
+  /**
+   * @class Parser
+   * @brief Recursive descent parser turning lexer tokens into an AST
+   *
+   * @details The grammar, from lowest to highest precedence, is
+   *          alternation := sequence ('|' sequence)*
+   *          sequence    := repeat*
+   *          repeat      := atom quantifier*
+   *          atom        := literal | escape | class | '.' | anchor
+   *                       | boundary | modifier | '(' alternation ')'
+   *          Sequences become GroupingNodes, alternatives AlternationNodes.
+   *          Groups and quantifiers may nest at most MAX_DEPTH levels deep,
+   *          so that neither the parser nor the visitors walking the AST
+   *          overflow the stack.
+   */
+  class Parser
+  {
+  public:
+    static constexpr std::size_t MAX_DEPTH = 1000;
+
+    explicit Parser(lex::TokenStream tokens);
+
+    ast::Arena parse();
+
+  private:
+    lex::TokenStream m_tokens;
+    std::size_t m_current;
+    std::size_t m_depth;
+    ast::ConcreteBuilder m_builder;
+
+    // Helper functions
+    ast::NodeIndex parse_alternation();
+    ast::NodeIndex parse_sequence();
+    ast::NodeIndex parse_repeat();
+    ast::NodeIndex parse_atom();
+    ast::NodeIndex parse_quantifier(ast::NodeIndex node,
+                                    std::string_view value);
+
+    bool at_end() const noexcept;
+    bool check(lex::TokenType type, const char *value) const;
+    const lex::CompactToken &peek() const;
+    std::string_view value_of(const lex::CompactToken &token) const noexcept;
+  };
+} // namespace parser
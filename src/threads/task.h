@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace thread_management
+{
+  /**
+   * @class Task
+   * @brief Type-erased `void()` callable with inline storage
+   *
+   * @details Callables of up to INLINE_SIZE bytes that can be moved without
+   *          throwing are stored inside the Task itself, so submitting them
+   *          allocates nothing. Larger callables fall back to the heap.
+   *          A Task is neither copyable nor movable, since queues refer to
+   *          it by address.
+   */
+  class Task
+  {
+  public:
+    static constexpr std::size_t INLINE_SIZE = 48;
+
+    Task() = default;
+
+    /**
+     * @brief Destroy the Task object
+     *
+     */
+    ~Task()
+    {
+      reset();
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    /**
+     * @brief Stores a callable, replacing the previous one
+     *
+     * @tparam Function Callable type, invocable without arguments
+     * @param[in] function The callable
+     */
+    template <typename Function>
+    void emplace(Function &&function)
+    {
+      using Callable = std::decay_t<Function>;
+
+      reset();
+
+      if constexpr (sizeof(Callable) <= INLINE_SIZE &&
+                    alignof(Callable) <= alignof(std::max_align_t) &&
+                    std::is_nothrow_move_constructible_v<Callable>)
+      {
+        ::new (static_cast<void *>(m_storage))
+            Callable(std::forward<Function>(function));
+
+        m_invoke = [](Task &task)
+        { (*std::launder(reinterpret_cast<Callable *>(task.m_storage)))(); };
+
+        m_destroy = [](Task &task)
+        { std::launder(reinterpret_cast<Callable *>(task.m_storage))->~Callable(); };
+      }
+      else
+      {
+        ::new (static_cast<void *>(m_storage))
+            Callable *(new Callable(std::forward<Function>(function)));
+
+        m_invoke = [](Task &task)
+        { (**std::launder(reinterpret_cast<Callable **>(task.m_storage)))(); };
+
+        m_destroy = [](Task &task)
+        { delete *std::launder(reinterpret_cast<Callable **>(task.m_storage)); };
+      }
+    }
+
+    /**
+     * @brief Runs the stored callable
+     *
+     */
+    void operator()()
+    {
+      m_invoke(*this);
+    }
+
+    /**
+     * @brief Destroys the stored callable, if any
+     *
+     */
+    void reset() noexcept
+    {
+      if (m_destroy != nullptr)
+        m_destroy(*this);
+
+      m_invoke = nullptr;
+      m_destroy = nullptr;
+    }
+
+    /**
+     * @brief Checks whether no callable is stored
+     *
+     * @return true If the task is empty
+     */
+    [[nodiscard]] bool empty() const noexcept
+    {
+      return m_invoke == nullptr;
+    }
+
+  private:
+    alignas(std::max_align_t) std::byte m_storage[INLINE_SIZE];
+    void (*m_invoke)(Task &) = nullptr;
+    void (*m_destroy)(Task &) = nullptr;
+  };
+} // namespace thread_management
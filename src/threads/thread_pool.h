@@ -1,22 +1,39 @@
 #pragma once
 
-#include <vector>
-#include <queue>
-#include <thread>
-#include <functional>
-#include <mutex>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 #include "../utils/logger.h"
+#include "task.h"
+#include "work_stealing_deque.h"
 
 namespace thread_management
 {
+  class TaskGroup;
+
   /**
    * @class ThreadPool
-   * @brief A thread pool for executing tasks in parallel on a set of threads
+   * @brief A work-stealing thread pool for executing tasks in parallel
    *
+   * @details Every worker owns a Chase-Lev deque. Tasks submitted from a
+   *          worker go to its own deque without locking and idle workers
+   *          steal from the others; only tasks submitted from outside the
+   *          pool pass through a shared, locked queue. TaskGroup and
+   *          parallel_for store their tasks inline and allocate nothing per
+   *          task, while enqueue() returns a future for one-off jobs.
    */
   class ThreadPool
   {
@@ -24,45 +41,31 @@ namespace thread_management
     /**
      * @brief Construct a new ThreadPool object
      *
-     * @param[in] num_threads Number of threads to use
+     * @param[in] num_threads Number of threads to use, at least one
      */
     explicit ThreadPool(std::size_t num_threads)
-        : m_logger(logger::Logger::get_logger()), m_stop(false)
+        : m_logger(logger::Logger::get_logger())
     {
-      for (std::size_t iterator; iterator < num_threads; ++iterator)
-      {
-        m_threads.emplace_back([this]
-                               {
-            while (true)
-            {
-                std::function<void()> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(this->m_queue_mutex);
-                    this->m_condition.wait(lock, [this]
-                                           { return this->m_stop || !this->m_tasks.empty(); });
-
-                    if (this->m_stop && this->m_tasks.empty())
-                        return;
-
-                    task = std::move(this->m_tasks.front());
-                    this->m_tasks.pop();
-                }
-
-                task();
-            } });
-      }
+      num_threads = std::max<std::size_t>(num_threads, 1);
+
+      for (std::size_t index = 0; index < num_threads; ++index)
+        m_workers.push_back(std::make_unique<Worker>(index));
+
+      for (std::size_t index = 0; index < num_threads; ++index)
+        m_threads.emplace_back([this, index]
+                               { work(*m_workers[index]); });
     }
 
     /**
      * @brief Destroy the ThreadPool object
+     * @details Tasks already submitted still run before the workers exit
      *
      */
     ~ThreadPool()
     {
       {
-        std::unique_lock<std::mutex> lock(m_queue_mutex);
-        m_stop = true;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop.store(true);
       }
 
       m_condition.notify_all();
@@ -71,6 +74,9 @@ namespace thread_management
         thread.join();
     }
 
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
     /**
      * @brief Adds a new task to the pool
      *
@@ -80,57 +86,473 @@ namespace thread_management
      * @param[in] function Function to execute
      * @param[in] args Arguments to pass to the function
      *
-     * @return std::future<typename std::result_of<Function(Args...)>::type>
+     * @return std::future<std::invoke_result_t<Function, Args...>>
      *         Future object holding the result of the function
      *
      * @throw std::runtime_error If the pool is stopped
      */
     template <class Function, class... Args>
     auto enqueue(Function &&function, Args &&...args)
-        -> std::future<typename std::result_of<Function(Args...)>::type>
+        -> std::future<std::invoke_result_t<Function, Args...>>
     {
-      try
+      using ReturnType = std::invoke_result_t<Function, Args...>;
+
+      if (m_stop.load())
       {
-        using ReturnType = typename std::result_of<Function(Args...)>::type;
+        REGEX_DFA_LOG_ERROR(m_logger,
+                            "ThreadPool: Error: enqueue on stopped pool");
+        throw std::runtime_error("ThreadPool: enqueue on stopped pool");
+      }
 
-        auto task = std::make_shared<std::packaged_task<ReturnType()>>(
-            std::bind(std::forward<Function>(function),
-                      std::forward<Args>(args)...));
+      std::packaged_task<ReturnType()> task(
+          [function = std::forward<Function>(function),
+           ... args = std::forward<Args>(args)]() mutable
+          { return std::invoke(std::move(function), std::move(args)...); });
 
-        std::future<ReturnType> result = task->get_future();
+      std::future<ReturnType> result = task.get_future();
+      auto job = std::make_unique<Job>();
 
-        {
-          std::unique_lock<std::mutex> lock(m_queue_mutex);
+      job->owned = true;
+      job->task.emplace([task = std::move(task)]() mutable
+                        { task(); });
 
-          if (m_stop)
-            throw std::runtime_error("ThreadPool: enqueue on stopped pool");
+      submit(job.release());
+      return result;
+    }
 
-          m_tasks.emplace([task]()
-                          { (*task)(); });
-        }
+    /**
+     * @brief Runs body over [begin, end) split into ranges of at most grain
+     *        indices, and waits for all of them
+     * @details The range is halved recursively; one half is offered to other
+     *          workers while the calling thread keeps splitting the other
+     *
+     * @tparam Function Callable as body(range_begin, range_end)
+     * @param[in] begin The first index
+     * @param[in] end One past the last index
+     * @param[in] grain The largest range given to a single call
+     * @param[in] body The loop body
+     * @throw Rethrows the first exception thrown by body
+     */
+    template <class Function>
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain,
+                      const Function &body);
+
+    /**
+     * @brief Gets the number of worker threads
+     *
+     * @return std::size_t The number of threads
+     */
+    [[nodiscard]] std::size_t get_thread_count() const noexcept
+    {
+      return m_threads.size();
+    }
+
+  private:
+    friend class TaskGroup;
+
+    /**
+     * @struct Job
+     * @brief A queued task with its owner
+     *
+     * @details Owned jobs come from enqueue() and are deleted after they
+     *          run; the others live in a TaskGroup and report to it.
+     */
+    struct Job
+    {
+      Task task;
+      TaskGroup *group = nullptr;
+      bool owned = false;
+    };
+
+    /**
+     * @struct Worker
+     * @brief Per-thread state of a worker
+     *
+     */
+    struct Worker
+    {
+      explicit Worker(std::size_t worker_index)
+          : index(worker_index), seed(worker_index * 2654435761u + 1)
+      {
+      }
+
+      std::size_t index;
+      std::uint64_t seed;
+      WorkStealingDeque<Job *> deque;
+    };
+
+    /**
+     * @struct ThreadContext
+     * @brief Identifies the pool and worker the current thread belongs to
+     *
+     */
+    struct ThreadContext
+    {
+      const ThreadPool *pool = nullptr;
+      Worker *worker = nullptr;
+    };
+
+    static constexpr int IDLE_SPINS = 64;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::deque<Job *> m_injected;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::shared_ptr<spdlog::logger> m_logger;
+
+    std::atomic<std::size_t> m_pending{0};
+    std::atomic<std::size_t> m_injected_count{0};
+    std::atomic<std::size_t> m_sleeping{0};
+    std::atomic<bool> m_stop{false};
 
+    /**
+     * @brief Gets the context of the calling thread
+     *
+     * @return ThreadContext& The context
+     */
+    static ThreadContext &context() noexcept
+    {
+      thread_local ThreadContext current;
+      return current;
+    }
+
+    /**
+     * @brief Gets the worker of this pool running the calling thread
+     *
+     * @return Worker* The worker, or nullptr outside the pool
+     */
+    Worker *current_worker() const noexcept
+    {
+      const ThreadContext &current = context();
+      return current.pool == this ? current.worker : nullptr;
+    }
+
+    /**
+     * @brief Queues a job, on the caller's own deque when it is a worker
+     *
+     * @param[in] job The job to queue
+     */
+    void submit(Job *job)
+    {
+      m_pending.fetch_add(1);
+
+      if (Worker *worker = current_worker())
+        worker->deque.push(job);
+
+      else
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_injected.push_back(job);
+        m_injected_count.fetch_add(1);
+      }
+
+      if (m_sleeping.load() > 0)
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
         m_condition.notify_one();
-        return result;
       }
-      catch (const std::exception &e)
+    }
+
+    /**
+     * @brief Takes a job from the caller's deque, the shared queue or
+     *        another worker
+     *
+     * @param[in] self The calling worker, or nullptr outside the pool
+     * @return Job* The job, or nullptr if none was found
+     */
+    Job *find_job(Worker *self)
+    {
+      std::optional<Job *> job;
+
+      if (self != nullptr)
+        job = self->deque.pop();
+
+      if (!job && m_injected_count.load(std::memory_order_relaxed) > 0)
       {
-        m_logger->error("ThreadPool: Error: {}", e.what());
-        throw;
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (!m_injected.empty())
+        {
+          job = m_injected.front();
+          m_injected.pop_front();
+          m_injected_count.fetch_sub(1);
+        }
       }
-      catch (...)
+
+      if (!job)
       {
-        m_logger->error("ThreadPool: Unknown error");
-        throw;
+        const std::size_t count = m_workers.size();
+        std::size_t start = 0;
+
+        if (self != nullptr)
+        {
+          self->seed ^= self->seed << 13;
+          self->seed ^= self->seed >> 7;
+          self->seed ^= self->seed << 17;
+          start = static_cast<std::size_t>(self->seed % count);
+        }
+
+        for (std::size_t i = 0; i < count && !job; ++i)
+        {
+          Worker &victim = *m_workers[(start + i) % count];
+
+          if (&victim != self)
+            job = victim.deque.steal();
+        }
       }
+
+      if (!job)
+        return nullptr;
+
+      m_pending.fetch_sub(1);
+      return *job;
+    }
+
+    /**
+     * @brief Runs a job and reports its completion
+     *
+     * @param[in] job The job to run
+     */
+    void run_job(Job *job);
+
+    /**
+     * @brief Runs one queued job on the calling thread, if there is one
+     *
+     * @return true If a job was run
+     */
+    bool help()
+    {
+      Job *job = find_job(current_worker());
+
+      if (job == nullptr)
+        return false;
+
+      run_job(job);
+      return true;
+    }
+
+    /**
+     * @brief Main loop of a worker thread
+     *
+     * @param[in] self The worker
+     */
+    void work(Worker &self)
+    {
+      context() = ThreadContext{this, &self};
+
+      while (true)
+      {
+        Job *job = find_job(&self);
+
+        for (int spin = 0; job == nullptr && spin < IDLE_SPINS; ++spin)
+        {
+          std::this_thread::yield();
+          job = find_job(&self);
+        }
+
+        if (job != nullptr)
+        {
+          run_job(job);
+          continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleeping.fetch_add(1);
+        m_condition.wait(lock, [this]
+                         { return m_stop.load() || m_pending.load() > 0; });
+        m_sleeping.fetch_sub(1);
+
+        if (m_stop.load() && m_pending.load() == 0)
+          return;
+      }
+    }
+  };
+
+  /**
+   * @class TaskGroup
+   * @brief Fork-join scope: runs tasks on a ThreadPool and waits for them
+   *
+   * @details Task storage is kept in the group and reused after wait(), so
+   *          a group that is run and waited on repeatedly stops allocating.
+   *          run() must be called by the thread that created the group.
+   *          wait() runs queued tasks while it waits, so groups may nest.
+   */
+  class TaskGroup
+  {
+  public:
+    /**
+     * @brief Construct a new TaskGroup object
+     *
+     * @param[in] pool The pool running the tasks
+     */
+    explicit TaskGroup(ThreadPool &pool) : m_pool(pool)
+    {
+    }
+
+    /**
+     * @brief Destroy the TaskGroup object, waiting for its tasks
+     *
+     */
+    ~TaskGroup()
+    {
+      drain();
+    }
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /**
+     * @brief Starts a task
+     *
+     * @tparam Function Callable type, invocable without arguments
+     * @param[in] function The task
+     */
+    template <class Function>
+    void run(Function &&function)
+    {
+      ThreadPool::Job &job = next_job();
+
+      job.group = this;
+      job.task.emplace(std::forward<Function>(function));
+
+      m_pending.fetch_add(1);
+      m_pool.submit(&job);
+    }
+
+    /**
+     * @brief Waits for every task started since the last wait
+     *
+     * @throw Rethrows the first exception thrown by a task
+     */
+    void wait()
+    {
+      drain();
+
+      if (m_error)
+        std::rethrow_exception(std::exchange(m_error, nullptr));
     }
 
   private:
-    std::vector<std::thread> m_threads;
-    std::queue<std::function<void()>> m_tasks;
-    std::mutex m_queue_mutex;
-    std::condition_variable m_condition;
-    std::shared_ptr<spdlog::logger> m_logger;
+    friend class ThreadPool;
+
+    static constexpr std::size_t INLINE_JOBS = 4;
+    static constexpr std::size_t BLOCK_JOBS = 64;
+
+    ThreadPool &m_pool;
+    std::atomic<std::size_t> m_pending{0};
+    std::array<ThreadPool::Job, INLINE_JOBS> m_inline;
+    std::vector<std::unique_ptr<ThreadPool::Job[]>> m_blocks;
+    std::size_t m_used = 0;
+    std::mutex m_error_mutex;
+    std::exception_ptr m_error;
+
+    /**
+     * @brief Gets a free job slot, adding a block if all are in use
+     *
+     * @return ThreadPool::Job& The slot
+     */
+    ThreadPool::Job &next_job()
+    {
+      const std::size_t index = m_used++;
+
+      if (index < INLINE_JOBS)
+        return m_inline[index];
+
+      const std::size_t block = (index - INLINE_JOBS) / BLOCK_JOBS;
+
+      if (block == m_blocks.size())
+        m_blocks.push_back(std::make_unique<ThreadPool::Job[]>(BLOCK_JOBS));
 
-    bool m_stop;
+      return m_blocks[block][(index - INLINE_JOBS) % BLOCK_JOBS];
+    }
+
+    /**
+     * @brief Records the completion of a task; the last access to the
+     *        group made on behalf of that task
+     *
+     * @param[in] error The exception thrown by the task, if any
+     */
+    void complete(std::exception_ptr error)
+    {
+      if (error)
+      {
+        std::unique_lock<std::mutex> lock(m_error_mutex);
+
+        if (!m_error)
+          m_error = std::move(error);
+      }
+
+      m_pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Helps the pool until every task of the group has finished
+     *
+     */
+    void drain()
+    {
+      while (m_pending.load(std::memory_order_acquire) > 0)
+        if (!m_pool.help())
+          std::this_thread::yield();
+
+      m_used = 0;
+    }
   };
-} // namespace thread_management
\ No newline at end of file
+
+  inline void ThreadPool::run_job(Job *job)
+  {
+    std::exception_ptr error;
+
+    try
+    {
+      job->task();
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    job->task.reset();
+
+    if (job->owned)
+      delete job;
+
+    else
+      job->group->complete(std::move(error));
+  }
+
+  template <class Function>
+  void ThreadPool::parallel_for(std::size_t begin, std::size_t end,
+                                std::size_t grain, const Function &body)
+  {
+    grain = std::max<std::size_t>(grain, 1);
+
+    if (end <= begin)
+      return;
+
+    if (end - begin <= grain)
+    {
+      body(begin, end);
+      return;
+    }
+
+    const std::size_t middle = begin + (end - begin) / 2;
+    TaskGroup group(*this);
+
+    group.run([this, middle, end, grain, &body]
+              { parallel_for(middle, end, grain, body); });
+
+    try
+    {
+      parallel_for(begin, middle, grain, body);
+    }
+    catch (...)
+    {
+      group.drain();
+      throw;
+    }
+
+    group.wait();
+  }
+} // namespace thread_management
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace thread_management
+{
+  /**
+   * @class WorkStealingDeque
+   * @brief Chase-Lev work-stealing deque of pointers
+   *
+   * @details The owning thread pushes and pops at the bottom without locks,
+   *          while any other thread may steal from the top. The ring buffer
+   *          doubles when full; replaced buffers are kept until the deque is
+   *          destroyed, since a thief may still be reading one. Follows Lê
+   *          et al., "Correct and Efficient Work-Stealing for Weak Memory
+   *          Models" (PPoPP 2013).
+   *
+   * @tparam T Element type, a pointer
+   */
+  template <typename T>
+  class WorkStealingDeque
+  {
+    static_assert(std::is_pointer_v<T>, "WorkStealingDeque holds pointers");
+
+  public:
+    /**
+     * @brief Construct a new WorkStealingDeque object
+     *
+     * @param[in] capacity Initial capacity, rounded up to a power of two
+     */
+    explicit WorkStealingDeque(std::size_t capacity = 256)
+    {
+      std::size_t size = 1;
+
+      while (size < capacity)
+        size <<= 1;
+
+      m_buffers.push_back(std::make_unique<Buffer>(size));
+      m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    /**
+     * @brief Pushes an element at the bottom; owner thread only
+     *
+     * @param[in] item The element
+     */
+    void push(T item)
+    {
+      const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+      const std::int64_t top = m_top.load(std::memory_order_acquire);
+      Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+
+      if (bottom - top > static_cast<std::int64_t>(buffer->mask))
+        buffer = grow(buffer, top, bottom);
+
+      buffer->put(bottom, item);
+      std::atomic_thread_fence(std::memory_order_release);
+      m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Pops the most recently pushed element; owner thread only
+     *
+     * @return std::optional<T> The element, if the deque was not empty
+     */
+    std::optional<T> pop()
+    {
+      const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+      Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+
+      m_bottom.store(bottom, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+      if (top > bottom)
+      {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+
+      std::optional<T> item = buffer->get(bottom);
+
+      // The last element may be contended by a thief
+      if (top == bottom)
+      {
+        if (!m_top.compare_exchange_strong(top, top + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+          item = std::nullopt;
+
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+      }
+
+      return item;
+    }
+
+    /**
+     * @brief Steals the oldest element; any thread
+     *
+     * @return std::optional<T> The element, if one was taken
+     */
+    std::optional<T> steal()
+    {
+      std::int64_t top = m_top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+      if (top >= bottom)
+        return std::nullopt;
+
+      Buffer *buffer = m_buffer.load(std::memory_order_acquire);
+      T item = buffer->get(top);
+
+      if (!m_top.compare_exchange_strong(top, top + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+        return std::nullopt;
+
+      return item;
+    }
+
+    /**
+     * @brief Checks whether the deque looks empty; a hint only
+     *
+     * @return true If no element was visible
+     */
+    [[nodiscard]] bool empty() const noexcept
+    {
+      return m_bottom.load(std::memory_order_relaxed) <=
+             m_top.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * @struct Buffer
+     * @brief Ring buffer indexed by the unbounded top and bottom counters
+     *
+     */
+    struct Buffer
+    {
+      std::size_t mask;
+      std::unique_ptr<std::atomic<T>[]> items;
+
+      explicit Buffer(std::size_t size)
+          : mask(size - 1), items(new std::atomic<T>[size])
+      {
+      }
+
+      void put(std::int64_t index, T item) noexcept
+      {
+        items[static_cast<std::size_t>(index) & mask].store(
+            item, std::memory_order_relaxed);
+      }
+
+      T get(std::int64_t index) const noexcept
+      {
+        return items[static_cast<std::size_t>(index) & mask].load(
+            std::memory_order_relaxed);
+      }
+    };
+
+    alignas(64) std::atomic<std::int64_t> m_top{0};
+    alignas(64) std::atomic<std::int64_t> m_bottom{0};
+    alignas(64) std::atomic<Buffer *> m_buffer{nullptr};
+    std::vector<std::unique_ptr<Buffer>> m_buffers;
+
+    /**
+     * @brief Doubles the ring buffer; owner thread only
+     *
+     * @param[in] buffer The current buffer
+     * @param[in] top The current top
+     * @param[in] bottom The current bottom
+     * @return Buffer* The new buffer
+     */
+    Buffer *grow(Buffer *buffer, std::int64_t top, std::int64_t bottom)
+    {
+      auto larger = std::make_unique<Buffer>((buffer->mask + 1) * 2);
+
+      for (std::int64_t i = top; i < bottom; ++i)
+        larger->put(i, buffer->get(i));
+
+      m_buffers.push_back(std::move(larger));
+      m_buffer.store(m_buffers.back().get(), std::memory_order_release);
+
+      return m_buffers.back().get();
+    }
+  };
+} // namespace thread_management
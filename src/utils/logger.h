@@ -2,8 +2,71 @@
 
 #include <memory>
 #include <spdlog/spdlog.h>
+#include <spdlog/cfg/env.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#ifdef REGEX_DFA_LOG_ASYNC
+#include <spdlog/async.h>
+#endif
+
+/**
+ * @brief Lowest level whose log calls are compiled in, one of the
+ *        SPDLOG_LEVEL_* values; set by the LOG_LEVEL CMake option
+ *
+ */
+#ifndef REGEX_DFA_ACTIVE_LEVEL
+#define REGEX_DFA_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief Logs through a logger if it is enabled at runtime
+ * @details The arguments are only evaluated when the level is enabled, so a
+ *          disabled call does not format anything
+ *
+ */
+#define REGEX_DFA_LOG(logger, level, ...)                                      \
+  do                                                                           \
+  {                                                                            \
+    if ((logger)->should_log(level))                                           \
+      (logger)->log(level, __VA_ARGS__);                                       \
+  } while (false)
+
+// Level macros, which compile to nothing below REGEX_DFA_ACTIVE_LEVEL
+#if REGEX_DFA_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define REGEX_DFA_LOG_TRACE(logger, ...)                                       \
+  REGEX_DFA_LOG(logger, spdlog::level::trace, __VA_ARGS__)
+#else
+#define REGEX_DFA_LOG_TRACE(logger, ...) (void)0
+#endif
+
+#if REGEX_DFA_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define REGEX_DFA_LOG_DEBUG(logger, ...)                                       \
+  REGEX_DFA_LOG(logger, spdlog::level::debug, __VA_ARGS__)
+#else
+#define REGEX_DFA_LOG_DEBUG(logger, ...) (void)0
+#endif
+
+#if REGEX_DFA_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define REGEX_DFA_LOG_INFO(logger, ...)                                        \
+  REGEX_DFA_LOG(logger, spdlog::level::info, __VA_ARGS__)
+#else
+#define REGEX_DFA_LOG_INFO(logger, ...) (void)0
+#endif
+
+#if REGEX_DFA_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define REGEX_DFA_LOG_WARN(logger, ...)                                        \
+  REGEX_DFA_LOG(logger, spdlog::level::warn, __VA_ARGS__)
+#else
+#define REGEX_DFA_LOG_WARN(logger, ...) (void)0
+#endif
+
+#if REGEX_DFA_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define REGEX_DFA_LOG_ERROR(logger, ...)                                       \
+  REGEX_DFA_LOG(logger, spdlog::level::err, __VA_ARGS__)
+#else
+#define REGEX_DFA_LOG_ERROR(logger, ...) (void)0
+#endif
+
 /**
  * @namespace logger
  * @brief Defines the logger class for the project
@@ -16,7 +79,12 @@ namespace logger
   public:
     /**
      * @brief Get the logger object
-     * @details Creates two loggers, one for console and one for stderr
+     * @details Creates the console logger on first use. Its level starts at
+     *          the compiled-in level and can be changed with the
+     *          SPDLOG_LEVEL environment variable, e.g. SPDLOG_LEVEL=warn.
+     *          Built with REGEX_DFA_LOG_ASYNC, messages are written by a
+     *          background thread, and the oldest are dropped rather than
+     *          blocking the caller when the queue is full.
      *
      * @return std::shared_ptr<spdlog::logger>& The logger
      */
@@ -24,18 +92,26 @@ namespace logger
     {
       static std::shared_ptr<spdlog::logger> logger = []
       {
+#ifdef REGEX_DFA_LOG_ASYNC
+        auto logger =
+            spdlog::create_async_nb<spdlog::sinks::stdout_color_sink_mt>(
+                "console");
+#else
         auto logger = spdlog::stdout_color_mt("console");
+#endif
         const std::string pattern =
             "[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [thread %t] %v";
         logger->set_pattern(pattern);
-        logger->set_level(spdlog::level::trace);
+        logger->set_level(
+            static_cast<spdlog::level::level_enum>(REGEX_DFA_ACTIVE_LEVEL));
+        spdlog::cfg::load_env_levels();
         return logger;
       }();
-  
+
       return logger;
     }
 
   private:
     Logger() = default;
   };
-} // namespace logger
\ No newline at end of file
+} // namespace logger
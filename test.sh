@@ -17,7 +17,8 @@ SRC_FILES=$(find $SRC_DIR -name "*.cpp")
 SRC_FILES=$(echo "$SRC_FILES" | grep -v "main.cpp")
 
 # Compile the tests and source files
-g++ -std=c++20 -o run_tests $TEST_FILES $SRC_FILES -lgtest -lgtest_main -pthread -lfmt
+g++ -std=c++20 -DUNIT_TEST -o run_tests $TEST_FILES $SRC_FILES -lgtest -lgtest_main -pthread \
+  -lfmt -lspdlog
 
 # Run the tests
 ./run_tests
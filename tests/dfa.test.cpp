@@ -0,0 +1,1035 @@
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif // UNIT_TEST
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include "../src/ast/ast_builder.h"
+#include "../src/dfa/batch_matcher.h"
+#include "../src/dfa/code_generator.h"
+#include "../src/dfa/bit_parallel_nfa.h"
+#include "../src/dfa/compile_cache.h"
+#include "../src/dfa/compiler.h"
+#include "../src/dfa/dfa_builder.h"
+#include "../src/dfa/dfa_file.h"
+#include "../src/dfa/followpos_visitor.h"
+#include "../src/dfa/jit_dfa.h"
+#include "../src/dfa/matcher.h"
+#include "../src/dfa/minimizer.h"
+#include "../src/dfa/parallel_scanner.h"
+#include "../src/dfa/prefilter.h"
+#include "../src/dfa/static_regex.h"
+#include "../src/dfa/stream_matcher.h"
+#include "../src/dfa/thompson_visitor.h"
+#include "../src/lexer/lexer.h"
+#include "../src/parser/parser.h"
+
+#ifdef UNIT_TEST
+namespace
+{
+  dfa::DFA build_dfa(ast::ConcreteBuilder &builder)
+  {
+    const ast::Arena tree = builder.release();
+    dfa::FollowposVisitor visitor;
+    auto automaton = visitor.analyze(tree);
+
+    return dfa::DFABuilder(automaton).build();
+  }
+} // namespace
+
+TEST(DFATest, LiteralMatchesOnlyItself)
+{
+  ast::ConcreteBuilder builder;
+  builder.literal("abc");
+  auto machine = build_dfa(builder);
+
+  ASSERT_TRUE(machine.matches("abc"));
+  ASSERT_FALSE(machine.matches("ab"));
+  ASSERT_FALSE(machine.matches("abcd"));
+  ASSERT_FALSE(machine.matches(""));
+}
+
+TEST(DFATest, FollowposOfClassicExample)
+{
+  // (a|b)*abb, the textbook followpos example
+  ast::ConcreteBuilder builder;
+  const auto a = builder.literal("a").build();
+  const auto b = builder.literal("b").build();
+  const auto alternation = builder.alternation(a, b).build();
+  const ast::NodeIndex sequence[] = {
+      builder.quantifier(alternation, 0, ast::UNBOUNDED).build(),
+      builder.literal("abb").build()};
+
+  builder.grouping(sequence);
+  const ast::Arena tree = builder.release();
+
+  dfa::FollowposVisitor visitor;
+  auto automaton = visitor.analyze(tree);
+
+  ASSERT_EQ(automaton.size(), 6);
+  ASSERT_EQ(automaton.end_markers, std::vector<std::uint32_t>{5});
+  ASSERT_EQ(automaton.first.size(), 3);
+  ASSERT_TRUE(automaton.follow[0].contains(2));
+  ASSERT_TRUE(automaton.follow[4].contains(5));
+
+  auto machine = dfa::DFABuilder(automaton).build();
+
+  // Dead state plus the four states of the textbook construction
+  ASSERT_EQ(machine.get_state_count(), 5);
+  ASSERT_TRUE(machine.matches("abb"));
+  ASSERT_TRUE(machine.matches("babaabb"));
+  ASSERT_FALSE(machine.matches("abba"));
+}
+
+TEST(DFATest, BoundedQuantifierAndClasses)
+{
+  ast::ConcreteBuilder builder;
+  builder.quantifier(builder.character_class("[a-c\\d]").build(), 2, 3);
+  auto machine = build_dfa(builder);
+
+  ASSERT_TRUE(machine.matches("a1"));
+  ASSERT_TRUE(machine.matches("cb9"));
+  ASSERT_FALSE(machine.matches("a"));
+  ASSERT_FALSE(machine.matches("abcd"));
+  ASSERT_FALSE(machine.matches("ax"));
+}
+
+TEST(DFATest, LargeRepeatsExpandLinearly)
+{
+  dfa::Compiler compiler;
+  const dfa::DFA exact = compiler.compile("x{300}");
+
+  ASSERT_EQ(compiler.get_stats().positions, 301);
+  ASSERT_TRUE(exact.matches(std::string(300, 'x')));
+  ASSERT_FALSE(exact.matches(std::string(299, 'x')));
+  ASSERT_FALSE(exact.matches(std::string(301, 'x')));
+
+  const dfa::DFA digits = compiler.compile("a\\d{1,4096}");
+
+  ASSERT_TRUE(digits.matches("a" + std::string(4096, '7')));
+  ASSERT_TRUE(digits.matches("a1"));
+  ASSERT_FALSE(digits.matches("a"));
+  ASSERT_FALSE(digits.matches("a" + std::string(4097, '7')));
+
+  ast::ConcreteBuilder builder;
+  ASSERT_THROW(builder.quantifier(builder.literal("a").build(), 3, 2),
+               std::invalid_argument);
+}
+
+TEST(DFATest, EstimatedStateBlowupIsRejected)
+{
+  dfa::Compiler compiler;
+
+  ASSERT_THROW(compiler.compile(".*a.{40}"), std::length_error);
+  ASSERT_GT(compiler.get_stats().estimated_states, 1ULL << 40);
+  ASSERT_THROW(dfa::Compiler({.unanchored = true}).compile("a.{40}"),
+               std::length_error);
+
+  ASSERT_NO_THROW(compiler.compile(".*a.{5}"));
+  ASSERT_NO_THROW(compiler.compile("a*a{1000}"));
+  ASSERT_NO_THROW(dfa::Compiler({.unanchored = true}).compile(".{500}"));
+
+  // Few states, but every one holds a share of the 40001 positions
+  ASSERT_THROW(compiler.compile("(a{1,200}){1,200}"), std::length_error);
+  ASSERT_LT(compiler.get_stats().estimated_states, 1ULL << 20);
+  ASSERT_GT(compiler.get_stats().estimated_work, 1ULL << 30);
+  ASSERT_EQ(compiler.compile_matcher("(a{1,200}){1,200}").get_engine(),
+            dfa::Engine::PIKE_VM);
+  ASSERT_NO_THROW(compiler.compile("(a{1,20}){1,20}"));
+  ASSERT_NO_THROW(compiler.compile("a\\d{1,4096}"));
+
+  // The lazy automaton only builds the states the input reaches
+  dfa::LazyDFA lazy = compiler.compile_lazy(".*a.{40}");
+
+  ASSERT_TRUE(lazy.matches("xa" + std::string(40, 'b')));
+  ASSERT_FALSE(lazy.matches("xa" + std::string(39, 'b')));
+}
+
+TEST(DFATest, MatcherFallsBackToThePikeVMOverBudget)
+{
+  // Too many positions for the bit-parallel engine
+  const std::string pattern = "(a|b)*a(a|b){10}c{50}";
+  const std::string tail(50, 'c');
+  dfa::Compiler bounded({.budget = {.max_states = 100}});
+
+  ASSERT_THROW(bounded.compile(pattern), std::length_error);
+
+  const dfa::Matcher fallback = bounded.compile_matcher(pattern);
+
+  ASSERT_EQ(fallback.get_engine(), dfa::Engine::PIKE_VM);
+  ASSERT_TRUE(fallback.matches("bba" + std::string(10, 'b') + tail));
+  ASSERT_FALSE(fallback.matches("bba" + std::string(9, 'b') + tail));
+  ASSERT_EQ(bounded.compile_matcher("a{70}").get_engine(), dfa::Engine::DFA);
+
+  dfa::Compiler small_memory({.budget = {.max_memory = 4096}});
+
+  ASSERT_EQ(small_memory.compile_matcher(pattern).get_engine(),
+            dfa::Engine::PIKE_VM);
+
+  // No engine runs a repeat with more states than the Thompson NFA allows
+  ASSERT_THROW(dfa::Compiler().compile_matcher("x{5000000}"),
+               std::invalid_argument);
+}
+
+TEST(DFATest, PikeVMGrowsLinearlyWithNullableRepeats)
+{
+  // followpos links every copy of a? to every later copy, the Thompson
+  // NFA only to the next one
+  dfa::Compiler compiler;
+  const dfa::Matcher matcher = compiler.compile_matcher("(a?){30000}");
+
+  ASSERT_EQ(matcher.get_engine(), dfa::Engine::PIKE_VM);
+  ASSERT_LT(matcher.memory_usage(), 16u << 20);
+  ASSERT_TRUE(matcher.matches(""));
+  ASSERT_TRUE(matcher.matches(std::string(500, 'a')));
+  ASSERT_FALSE(matcher.matches(std::string(500, 'a') + "b"));
+
+  const dfa::Matcher shorter = compiler.compile_matcher("(a?){5000}");
+
+  ASSERT_EQ(shorter.get_engine(), dfa::Engine::PIKE_VM);
+  ASSERT_TRUE(shorter.matches(std::string(5000, 'a')));
+  ASSERT_FALSE(shorter.matches(std::string(5001, 'a')));
+
+  // The automaton must fit the memory budget too
+  ASSERT_THROW(dfa::Compiler({.budget = {.max_memory = 1 << 20}})
+                   .compile_matcher("(a?){30000}"),
+               std::invalid_argument);
+}
+
+TEST(DFATest, BudgetBoundsTheWorkOfNestedRepeats)
+{
+  // Every state holds a share of the 40001 positions, so the work grows
+  // with states times positions long before the states run out
+  const std::string pattern = "(a{1,200}){1,200}";
+  lexer::Lexer lexer(pattern);
+  parser::Parser parser(lexer.scan());
+  dfa::FollowposVisitor visitor;
+  const auto automaton = visitor.analyze(parser.parse());
+
+  ASSERT_THROW(dfa::DFABuilder(automaton, nullptr,
+                               {.max_states = 100000,
+                                .max_memory = 16 << 20,
+                                .max_work = 1000000})
+                   .build(),
+               std::length_error);
+
+  dfa::Compiler bounded(
+      {.max_estimated_states = 0,
+       .max_estimated_work = 0,
+       .budget = {.max_work = 1000000}});
+  const dfa::Matcher fallback = bounded.compile_matcher(pattern);
+
+  ASSERT_EQ(fallback.get_engine(), dfa::Engine::PIKE_VM);
+  ASSERT_TRUE(fallback.matches(std::string(300, 'a')));
+  ASSERT_FALSE(fallback.matches("aab"));
+}
+
+TEST(DFATest, PositionEnginesAgreeWithTheDFA)
+{
+  const std::vector<std::string> patterns = {
+      "(a|b)*abb", "^ab|c$", "a{2,4}b?", "(ab|c)*d+", "a\\d{1,3}", "a?",
+      "(a|$)^", "($|a)(^|b)", "$^", "(a?){3}b*", "(a*)*b|", "()*(|a)"};
+  const std::string alphabet = "abcd1";
+  std::vector<std::string> inputs = {""};
+
+  for (std::size_t length = 1; length <= 5; ++length)
+    for (std::size_t code = 0; code < 3125; code += 7)
+    {
+      std::string input;
+
+      for (std::size_t i = 0, rest = code; i < length; ++i, rest /= 5)
+        input += alphabet[rest % 5];
+
+      inputs.push_back(input);
+    }
+
+  dfa::Compiler compiler;
+
+  for (const auto &pattern : patterns)
+  {
+    lexer::Lexer lexer(pattern);
+    parser::Parser parser(lexer.scan());
+    const ast::Arena tree = parser.parse();
+    dfa::FollowposVisitor visitor;
+    const auto automaton = visitor.analyze(tree);
+
+    const dfa::DFA reference = compiler.compile(pattern);
+    const dfa::PikeVM vm(dfa::ThompsonVisitor().build(tree));
+    const dfa::BitParallelNFA nfa(automaton);
+
+    for (const auto &input : inputs)
+    {
+      ASSERT_EQ(vm.matches(input), reference.matches(input))
+          << pattern << " on " << input;
+      ASSERT_EQ(nfa.matches(input), reference.matches(input))
+          << pattern << " on " << input;
+    }
+  }
+
+  ASSERT_EQ(compiler.compile_matcher("[a-z]+@[a-z]+\\.com").get_engine(),
+            dfa::Engine::BIT_PARALLEL);
+}
+
+TEST(DFATest, AnchorsOnlyPassAtTheEnds)
+{
+  ast::ConcreteBuilder builder;
+  const ast::NodeIndex anchored[] = {builder.anchor('^').build(),
+                                     builder.end_of_input().build()};
+  builder.grouping(anchored);
+  auto empty_only = build_dfa(builder);
+
+  ASSERT_TRUE(empty_only.matches(""));
+  ASSERT_FALSE(empty_only.matches("a"));
+
+  const ast::NodeIndex misplaced[] = {builder.literal("a").build(),
+                                      builder.anchor('^').build()};
+  builder.grouping(misplaced);
+
+  ASSERT_FALSE(build_dfa(builder).matches("a"));
+
+  // On empty input '$' and '^' may be passed in either order
+  const ast::NodeIndex crossed[] = {builder.end_of_input().build(),
+                                    builder.anchor('^').build()};
+  builder.grouping(crossed);
+  auto crossed_only = build_dfa(builder);
+
+  ASSERT_TRUE(crossed_only.matches(""));
+  ASSERT_FALSE(crossed_only.matches("a"));
+
+  for (const auto *pattern : {"(a|$)^", ".*$^", "$^$^"})
+  {
+    ASSERT_TRUE(dfa::Compiler().compile(pattern).matches("")) << pattern;
+    ASSERT_FALSE(dfa::Compiler().compile(pattern).matches("a")) << pattern;
+  }
+}
+
+TEST(DFATest, UnsupportedNodesThrow)
+{
+  ast::ConcreteBuilder builder;
+  builder.boundary('b');
+  ASSERT_THROW(build_dfa(builder), std::invalid_argument);
+}
+
+TEST(DFATest, ArenaReuseKeepsCapacity)
+{
+  ast::ConcreteBuilder builder;
+  builder.get_arena().reserve(16, 16);
+  builder.literal("abc");
+
+  const auto *nodes = &builder.get_arena().get_node(0);
+  builder.reset();
+
+  ASSERT_EQ(builder.get_arena().size(), 0);
+  ASSERT_EQ(builder.build(), ast::NO_NODE);
+
+  builder.literal("xyz");
+  ASSERT_EQ(&builder.get_arena().get_node(0), nodes);
+  ASSERT_EQ(builder.get_arena().get_value(0), "xyz");
+}
+
+TEST(DFATest, MinimizationKeepsTheLanguage)
+{
+  const std::string pattern = "(a|b)*(aab|bab)|abb|bbb";
+
+  dfa::Compiler full({.minimize = false});
+  dfa::Compiler minimal;
+
+  auto expected = full.compile(pattern);
+  auto machine = minimal.compile(pattern);
+
+  ASSERT_LT(machine.get_state_count(), expected.get_state_count());
+  ASSERT_EQ(minimal.get_stats().states_removed,
+            expected.get_state_count() - machine.get_state_count());
+
+  // Compare both automata on every string over {a, b} up to length 10
+  for (std::size_t length = 0; length <= 10; ++length)
+    for (std::size_t bits = 0; bits < (std::size_t{1} << length); ++bits)
+    {
+      std::string input;
+
+      for (std::size_t i = 0; i < length; ++i)
+        input += (bits >> i) & 1 ? 'b' : 'a';
+
+      ASSERT_EQ(machine.matches(input), expected.matches(input)) << input;
+    }
+}
+
+TEST(DFATest, MinimizationMergesEquivalentStates)
+{
+  // a|b|c and [a-c] describe the same language
+  auto machine = dfa::Compiler().compile("(a|b|c)(a|b|c)");
+  auto reference = dfa::Compiler().compile("[a-c]{2}");
+
+  ASSERT_EQ(machine.get_state_count(), 4);
+  ASSERT_EQ(machine.get_transitions(), reference.get_transitions());
+  ASSERT_EQ(machine.get_accept_flags(), reference.get_accept_flags());
+}
+
+TEST(DFATest, TableHasOneColumnPerByteClass)
+{
+  auto machine = dfa::Compiler().compile("[a-z]+@[a-z]+\\.com");
+  const auto &classes = machine.get_byte_classes();
+
+  // 'c', 'm', 'o', the rest of [a-z], '@', '.' and everything else
+  ASSERT_EQ(machine.get_class_count(), 7);
+  ASSERT_EQ(machine.get_transitions().size(),
+            machine.get_state_count() * machine.get_class_count());
+  ASSERT_EQ(classes['a'], classes['b']);
+  ASSERT_EQ(classes['b'], classes['z']);
+  ASSERT_NE(classes['c'], classes['d']);
+  ASSERT_EQ(classes['#'], classes['A']);
+  ASSERT_TRUE(machine.matches("joe@example.com"));
+  ASSERT_FALSE(machine.matches("joe@example.org"));
+}
+
+TEST(DFATest, LazyDFAMatchesTheFullDFA)
+{
+  const std::string pattern = "(a|b)*a(a|b){6}";
+
+  auto full = dfa::Compiler().compile(pattern);
+  auto lazy = dfa::Compiler().compile_lazy(pattern);
+
+  for (std::size_t length = 0; length <= 10; ++length)
+    for (std::size_t bits = 0; bits < (std::size_t{1} << length); ++bits)
+    {
+      std::string input;
+
+      for (std::size_t i = 0; i < length; ++i)
+        input += (bits >> i) & 1 ? 'b' : 'a';
+
+      ASSERT_EQ(lazy.matches(input), full.matches(input)) << input;
+    }
+
+  ASSERT_GT(lazy.get_stats().hits, 0);
+  ASSERT_EQ(lazy.get_stats().flushes, 0);
+  ASSERT_EQ(lazy.get_stats().states, full.get_state_count());
+}
+
+TEST(DFATest, LazyDFAFlushesWhenTheCacheIsFull)
+{
+  // The full DFA of this pattern has over a million states
+  auto lazy = dfa::Compiler().compile_lazy("(a|b)*a(a|b){20}",
+                                           {.cache_capacity = 16 << 10});
+  std::string input;
+  std::uint32_t seed = 12345;
+
+  for (std::size_t i = 0; i < 4096; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    input += (seed >> 16) & 1 ? 'a' : 'b';
+  }
+
+  const bool expected = input[input.size() - 21] == 'a';
+
+  ASSERT_EQ(lazy.matches(input), expected);
+  ASSERT_GT(lazy.get_stats().flushes, 0);
+  ASSERT_LE(lazy.get_stats().memory, std::size_t{16} << 10);
+
+  input[input.size() - 21] = expected ? 'b' : 'a';
+  ASSERT_EQ(lazy.matches(input), !expected);
+}
+
+TEST(DFATest, StaticRegexIsBuiltAtCompileTime)
+{
+  using Email = dfa::StaticRegex<"[a-z]+@[a-z]+\\.com">;
+
+  static_assert(Email::matches("joe@example.com"));
+  static_assert(!Email::matches("joe@example.org"));
+  static_assert(sizeof(Email::state_type) == 1);
+
+  auto machine = dfa::Compiler().compile("[a-z]+@[a-z]+\\.com");
+  ASSERT_EQ(Email::state_count, machine.get_state_count());
+  ASSERT_EQ(Email::to_dfa().matches("a@b.com"), true);
+
+  static_assert(dfa::StaticRegex<"(a|$)^">::matches(""));
+  static_assert(!dfa::StaticRegex<"(a|$)^">::matches("a"));
+}
+
+TEST(DFATest, StaticRegexMatchesTheRuntimeDFA)
+{
+  using Pattern = dfa::StaticRegex<"^(ab|a)*c?$|[^a-c]\\d{2}">;
+  auto machine = dfa::Compiler().compile("^(ab|a)*c?$|[^a-c]\\d{2}");
+  const std::string alphabet = "abcx19";
+
+  ASSERT_EQ(Pattern::state_count, machine.get_state_count());
+
+  for (std::size_t length = 0; length <= 5; ++length)
+  {
+    std::size_t combinations = 1;
+
+    for (std::size_t i = 0; i < length; ++i)
+      combinations *= alphabet.size();
+
+    for (std::size_t n = 0; n < combinations; ++n)
+    {
+      std::string input;
+
+      for (std::size_t i = 0, rest = n; i < length; ++i)
+      {
+        input += alphabet[rest % alphabet.size()];
+        rest /= alphabet.size();
+      }
+
+      ASSERT_EQ(Pattern::matches(input), machine.matches(input)) << input;
+    }
+  }
+}
+
+TEST(DFATest, PrefilterIsDerivedFromThePattern)
+{
+  using Kind = dfa::Prefilter::Kind;
+  dfa::Compiler compiler;
+
+  auto literal = compiler.compile_searcher("foo(bar|baz)+");
+  ASSERT_EQ(literal.get_prefilter().get_kind(), Kind::LITERAL);
+  ASSERT_EQ(literal.get_prefilter().get_prefix(), "fooba");
+
+  ASSERT_EQ(compiler.compile_searcher("[ab]x").get_prefilter().get_kind(),
+            Kind::BYTES);
+  ASSERT_EQ(compiler.compile_searcher("\\w+").get_prefilter().get_kind(),
+            Kind::BYTE_TABLE);
+  ASSERT_EQ(compiler.compile_searcher("a*").get_prefilter().get_kind(),
+            Kind::NONE);
+  ASSERT_EQ(compiler.compile_searcher("$").get_prefilter().get_kind(),
+            Kind::NONE);
+}
+
+TEST(DFATest, SearchAgreesAcrossSimdLevels)
+{
+  const std::vector<std::string> patterns = {
+      "abc", "ab(c|d)+", "[ax]b", "[a-c]+d", "a*d", "b{2,3}"};
+  std::uint32_t seed = 7;
+  std::string text;
+
+  for (std::size_t i = 0; i < 400; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    text += static_cast<char>('a' + (seed >> 16) % 5);
+  }
+
+  for (const auto &pattern : patterns)
+  {
+    auto searcher = dfa::Compiler().compile_searcher(pattern);
+    auto machine = dfa::Compiler().compile(pattern);
+
+    for (const auto level : {dfa::SimdLevel::SCALAR, dfa::SimdLevel::SSE2,
+                             dfa::SimdLevel::AVX2})
+    {
+      searcher.get_prefilter().set_simd_level(level);
+
+      for (std::size_t from = 0; from <= text.size(); from += 37)
+      {
+        std::optional<dfa::Match> expected;
+
+        for (std::size_t start = from; start <= text.size() && !expected;
+             ++start)
+          for (std::size_t end = text.size() + 1; end-- > start;)
+            if (machine.matches(text.substr(start, end - start)))
+            {
+              expected = dfa::Match{start, end};
+              break;
+            }
+
+        ASSERT_EQ(searcher.find(text, from), expected) << pattern;
+      }
+    }
+  }
+}
+
+TEST(DFATest, SearchRejectsLongTextsWithoutAMatch)
+{
+  // Trying every candidate to its end would be quadratic in the text
+  const std::string text(1 << 20, 'x');
+
+  for (const auto *pattern : {"x*b", "[a-z]+[0-9]", "x[a-z]*y"})
+  {
+    auto searcher = dfa::Compiler().compile_searcher(pattern);
+
+    ASSERT_EQ(searcher.find(text), std::nullopt) << pattern;
+  }
+
+  auto searcher = dfa::Compiler().compile_searcher("x[a-z]*y");
+  ASSERT_EQ(searcher.find(text + "y", 5), (dfa::Match{5, text.size() + 1}));
+}
+
+TEST(DFATest, SearchRespectsAnchors)
+{
+  auto start = dfa::Compiler().compile_searcher("^ab|cd");
+  ASSERT_EQ(start.find("abab"), (dfa::Match{0, 2}));
+  ASSERT_EQ(start.find("xabcd"), (dfa::Match{3, 5}));
+  ASSERT_EQ(start.find("abab", 1), std::nullopt);
+
+  auto end = dfa::Compiler().compile_searcher("ab$");
+  ASSERT_EQ(end.find("abab"), (dfa::Match{2, 4}));
+  ASSERT_EQ(end.find("abx"), std::nullopt);
+
+  // A '$' never leads to '^' after the start of the text
+  for (const auto *pattern : {"$^", "($|b)^"})
+  {
+    auto crossed = dfa::Compiler().compile_searcher(pattern);
+    ASSERT_EQ(crossed.find("x"), std::nullopt) << pattern;
+    ASSERT_EQ(crossed.find(""), (dfa::Match{0, 0})) << pattern;
+  }
+}
+
+TEST(DFATest, PatternSetReportsEveryMatchingPattern)
+{
+  const std::vector<std::string> patterns = {
+      "a+b", "[ab]*", "ab|ba", "(a|b)*b$", "c?a{2}"};
+  dfa::Compiler compiler;
+  auto set = compiler.compile_set(patterns);
+
+  ASSERT_EQ(compiler.get_stats().patterns, patterns.size());
+  ASSERT_EQ(compiler.get_stats().dfa_states, set.get_state_count());
+
+  std::vector<dfa::DFA> singles;
+
+  for (const auto &pattern : patterns)
+    singles.push_back(dfa::Compiler().compile(pattern));
+
+  const std::string alphabet = "abc";
+
+  for (std::size_t n = 0; n < 3 * 3 * 3 * 3 * 3; ++n)
+  {
+    std::string input;
+
+    for (std::size_t rest = n; rest > 0; rest /= 3)
+      input += alphabet[rest % 3];
+
+    std::vector<std::uint32_t> expected;
+
+    for (std::uint32_t id = 0; id < singles.size(); ++id)
+      if (singles[id].matches(input))
+        expected.push_back(id);
+
+    const auto matched = set.matching_patterns(input);
+    ASSERT_EQ(std::vector<std::uint32_t>(matched.begin(), matched.end()),
+              expected)
+        << input;
+  }
+}
+
+TEST(DFATest, ParallelBuildNumbersStatesLikeSequentialBuild)
+{
+  std::vector<std::string> patterns;
+
+  for (int i = 0; i < 40; ++i)
+    patterns.push_back(std::string(1, static_cast<char>('a' + i % 26)) +
+                       "[a-f]{" + std::to_string(i % 5) + "}x*" +
+                       std::to_string(i));
+
+  thread_management::ThreadPool pool(4);
+
+  for (const bool unanchored : {false, true})
+  {
+    auto sequential = dfa::Compiler({.minimize = false,
+                                     .unanchored = unanchored})
+                          .compile_set(patterns);
+    auto parallel = dfa::Compiler({.minimize = false,
+                                   .unanchored = unanchored,
+                                   .pool = &pool})
+                        .compile_set(patterns);
+
+    ASSERT_EQ(parallel.get_start_state(), sequential.get_start_state());
+    ASSERT_EQ(parallel.get_transitions(), sequential.get_transitions());
+    ASSERT_EQ(parallel.get_accept_flags(), sequential.get_accept_flags());
+
+    for (dfa::StateId state = 0; state < sequential.get_state_count();
+         ++state)
+    {
+      const auto expected = sequential.get_accept_ids(state);
+      const auto actual = parallel.get_accept_ids(state);
+
+      ASSERT_TRUE(std::equal(expected.begin(), expected.end(),
+                             actual.begin(), actual.end()));
+    }
+  }
+}
+
+TEST(DFATest, PatternSetNamesTheInvalidPattern)
+{
+  try
+  {
+    (void)dfa::Compiler().compile_set({"ab", "(ab"});
+    FAIL();
+  }
+  catch (const std::invalid_argument &e)
+  {
+    ASSERT_EQ(std::string(e.what()).rfind("Compiler: pattern 1: ", 0), 0);
+  }
+
+  ASSERT_THROW((void)dfa::Compiler().compile_set(std::vector<std::string>{}),
+               std::invalid_argument);
+}
+
+TEST(DFATest, BinaryFileRoundTrips)
+{
+  const std::vector<std::string> patterns = {"[a-z]+@[a-z]+\\.com", "a.*",
+                                             "(ab)+$"};
+  const auto machine = dfa::Compiler().compile_set(patterns);
+  const std::string path = ::testing::TempDir() + "round_trip.dfa";
+
+  dfa::DFAFile::save(machine, path);
+  const dfa::MappedDFA mapped(path);
+  const dfa::DFAView &view = mapped.get_view();
+
+  ASSERT_EQ(view.get_state_count(), machine.get_state_count());
+  ASSERT_EQ(view.get_class_count(), machine.get_class_count());
+
+  for (const std::string input : {"joe@example.com", "abab", "ab@cd.com", "",
+                                  "b", "a@b.co"})
+  {
+    const auto expected = machine.matching_patterns(input);
+    const auto actual = view.matching_patterns(input);
+
+    ASSERT_TRUE(std::ranges::equal(actual, expected)) << input;
+    ASSERT_EQ(view.matches(input), machine.matches(input)) << input;
+  }
+
+  ASSERT_EQ(view.to_dfa().to_string(), machine.to_string());
+}
+
+TEST(DFATest, BinaryLoaderRejectsCorruptFiles)
+{
+  std::ostringstream output;
+  dfa::DFAFile::write(dfa::Compiler().compile("a+b"), output);
+  const std::string bytes = output.str();
+
+  auto load = [](std::string data)
+  {
+    std::vector<std::uint32_t> aligned((data.size() + 3) / 4);
+    std::memcpy(aligned.data(), data.data(), data.size());
+    return dfa::DFAFile::load(std::as_bytes(std::span(aligned))
+                                  .first(data.size()));
+  };
+
+  ASSERT_TRUE(load(bytes).matches("aab"));
+
+  std::string magic = bytes;
+  magic[0] = 'X';
+  ASSERT_THROW(load(magic), std::runtime_error);
+
+  std::string endian = bytes;
+  std::swap(endian[12], endian[15]);
+  std::swap(endian[13], endian[14]);
+  ASSERT_THROW(load(endian), std::runtime_error);
+
+  ASSERT_THROW(load(bytes.substr(0, bytes.size() - 1)), std::runtime_error);
+
+  std::string target = bytes;
+  const std::size_t transitions = 384;
+  target[transitions + 1] = '\x7f';
+  ASSERT_THROW(load(target), std::runtime_error);
+}
+
+TEST(DFATest, StreamMatchesSpanChunks)
+{
+  const std::vector<std::string> patterns = {"abc", "a[bc]+", "(ab)*c",
+                                             "b{2}"};
+  std::uint32_t seed = 11;
+  std::string text;
+
+  for (std::size_t i = 0; i < 300; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    text += static_cast<char>('a' + (seed >> 16) % 3);
+  }
+
+  for (const auto &pattern : patterns)
+  {
+    const auto anchored = dfa::Compiler().compile(pattern);
+    const auto machine = dfa::Compiler({.unanchored = true}).compile(pattern);
+    std::vector<std::uint64_t> expected;
+
+    for (std::size_t end = 0; end <= text.size(); ++end)
+      for (std::size_t start = 0; start <= end; ++start)
+        if (anchored.matches(text.substr(start, end - start)))
+        {
+          expected.push_back(end);
+          break;
+        }
+
+    dfa::StreamMatcher matcher(machine);
+    std::vector<std::uint64_t> ends;
+    auto record = [&](std::uint64_t end)
+    { ends.push_back(end); };
+    const auto bytes = std::as_bytes(std::span(text.data(), text.size()));
+
+    for (std::size_t offset = 0, size = 1; offset < bytes.size();
+         offset += size, size = size % 7 + 1)
+      matcher.feed(bytes.subspan(offset, std::min(size, bytes.size() - offset)),
+                   record);
+
+    ASSERT_EQ(matcher.get_offset(), text.size());
+    matcher.finish(record);
+
+    ASSERT_EQ(ends, expected) << pattern;
+    ASSERT_EQ(matcher.get_offset(), 0);
+  }
+}
+
+TEST(DFATest, StreamFinishHandlesTheEndAnchor)
+{
+  const auto machine = dfa::Compiler({.unanchored = true}).compile("^a|b$");
+  dfa::StreamMatcher matcher(machine);
+  std::vector<std::uint64_t> ends;
+  auto record = [&](std::uint64_t end)
+  { ends.push_back(end); };
+  const std::string first = "ab";
+  const std::string second = "ab";
+
+  matcher.feed(std::as_bytes(std::span(first.data(), first.size())), record);
+  matcher.feed(std::as_bytes(std::span(second.data(), second.size())),
+               record);
+  ASSERT_EQ(ends, std::vector<std::uint64_t>{1});
+
+  ASSERT_EQ(matcher.finish(record), 1);
+  ASSERT_EQ(ends, (std::vector<std::uint64_t>{1, 4}));
+}
+
+TEST(DFATest, ParallelScanMatchesTheStreamMatcher)
+{
+  const std::vector<std::string> patterns = {"ab+c", "(a|b)*a(a|b){3}",
+                                             "^ab|c$", "a*"};
+  std::uint32_t seed = 5;
+  std::string text;
+
+  for (std::size_t i = 0; i < 2000; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    text += static_cast<char>('a' + (seed >> 16) % 3);
+  }
+
+  thread_management::ThreadPool pool(4);
+
+  for (const auto &pattern : patterns)
+    for (const bool unanchored : {false, true})
+    {
+      const auto machine =
+          dfa::Compiler({.unanchored = unanchored}).compile(pattern);
+      dfa::StreamMatcher matcher(machine);
+      std::vector<std::uint64_t> expected;
+      auto record = [&](std::uint64_t end)
+      { expected.push_back(end); };
+
+      matcher.feed(std::as_bytes(std::span(text.data(), text.size())),
+                   record);
+      const dfa::StateId final_state = matcher.get_state();
+      matcher.finish(record);
+
+      for (const std::size_t chunk_size : {1, 7, 100, 5000})
+      {
+        dfa::ParallelScanner scanner(machine, pool, {chunk_size});
+        const auto result = scanner.scan(text);
+
+        ASSERT_EQ(result.match_ends, expected) << pattern << chunk_size;
+        ASSERT_EQ(result.final_state, final_state);
+        ASSERT_EQ(result.accepted, machine.matches(text));
+      }
+    }
+}
+
+TEST(DFATest, CompileCacheEvictsTheLeastRecentlyUsed)
+{
+  dfa::CompileCache probe;
+  probe.get("abc");
+  const std::size_t one = probe.get_stats().memory;
+
+  dfa::CompileCache cache({.capacity = 2 * one + one / 2});
+
+  auto first = cache.get("abc");
+  ASSERT_EQ(cache.get("abc"), first);
+  ASSERT_NE(cache.get("abc", {.minimize = false}), first);
+
+  // "abc" was used last, so the unminimized entry goes first
+  cache.get("abc");
+  cache.get("abd");
+
+  auto stats = cache.get_stats();
+  ASSERT_EQ(stats.hits, 2u);
+  ASSERT_EQ(stats.misses, 3u);
+  ASSERT_EQ(stats.evictions, 1u);
+  ASSERT_EQ(stats.entries, 2u);
+  ASSERT_LE(stats.memory, 2 * one + one / 2);
+  ASSERT_EQ(cache.get("abc"), first);
+  ASSERT_TRUE(first->matches("abc"));
+
+  ASSERT_THROW(cache.get("(ab"), std::invalid_argument);
+  ASSERT_EQ(cache.get_stats().entries, 2u);
+}
+
+TEST(DFATest, CompileCacheKeepsTheLimitsOfEveryCaller)
+{
+  dfa::CompileCache cache;
+
+  const auto large = cache.get("a.{10}", {.unanchored = true});
+  ASSERT_GT(large->get_state_count(), 1000u);
+
+  // A cached automaton is not returned to callers whose limits reject it
+  ASSERT_THROW(cache.get("a.{10}",
+                         {.unanchored = true, .max_estimated_states = 1000}),
+               std::length_error);
+  ASSERT_THROW(
+      cache.get("a.{10}", {.unanchored = true, .budget = {.max_states = 64}}),
+      std::length_error);
+  ASSERT_THROW(cache.get("a.{10}",
+                         {.unanchored = true, .budget = {.max_memory = 4096}}),
+               std::length_error);
+
+  ASSERT_EQ(cache.get("a.{10}", {.unanchored = true}), large);
+  ASSERT_EQ(cache.get_stats().hits, 1u);
+}
+
+TEST(DFATest, CompileCacheCompilesConcurrentMissesOnce)
+{
+  dfa::CompileCache cache;
+  std::vector<std::shared_ptr<const dfa::DFA>> results(8);
+  std::vector<std::thread> threads;
+
+  for (auto &result : results)
+    threads.emplace_back([&cache, &result]
+                         { result = cache.get("(a|b)*a(a|b){6}"); });
+
+  for (auto &thread : threads)
+    thread.join();
+
+  for (const auto &result : results)
+    ASSERT_EQ(result, results.front());
+
+  ASSERT_EQ(cache.get_stats().misses, 1u);
+  ASSERT_EQ(cache.get_stats().hits, results.size() - 1);
+}
+
+TEST(DFATest, BatchMatcherAgreesWithTheDFA)
+{
+  const dfa::DFA machine = dfa::Compiler().compile("(a|b)*a(a|b){3}");
+  std::vector<std::string> records;
+  std::uint32_t seed = 7;
+
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    std::string record((seed >> 16) % 24, 'a');
+
+    for (auto &character : record)
+    {
+      seed = seed * 1103515245 + 12345;
+      character = "aab"[(seed >> 16) % 3];
+    }
+
+    // A few records die early
+    if (i % 17 == 0)
+      record.insert(record.size() / 2, "c");
+
+    records.push_back(std::move(record));
+  }
+
+  const std::vector<std::string_view> inputs(records.begin(), records.end());
+
+  for (const std::size_t lanes : {4, 8, 16})
+  {
+    const dfa::BatchMatcher matcher(machine, {.lanes = lanes});
+    std::vector<std::uint8_t> results(inputs.size(), 2);
+    std::size_t expected = 0;
+
+    const std::size_t count = matcher.matches(inputs, results);
+
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+    {
+      ASSERT_EQ(results[i] == 1, machine.matches(inputs[i])) << inputs[i];
+      expected += results[i];
+    }
+
+    ASSERT_EQ(count, expected);
+    ASSERT_GT(count, 0);
+
+    // Fewer inputs than lanes
+    const auto few = std::span(inputs).first(3);
+    matcher.matches(few, results);
+
+    for (std::size_t i = 0; i < few.size(); ++i)
+      ASSERT_EQ(results[i] == 1, machine.matches(few[i]));
+  }
+
+  ASSERT_THROW(dfa::BatchMatcher(machine, {.lanes = 3}),
+               std::invalid_argument);
+}
+
+TEST(DFATest, JitAgreesWithTheTable)
+{
+  // The first pattern dispatches through compare trees, the second needs
+  // jump tables
+  const std::pair<std::string, std::string> cases[] = {
+      {"(a|b)*a(a|b){3}c?$", "abc"},
+      {"[0-9a-fA-F:. -]*(x|y[0-9])+", "abcxy09F: -G"}};
+
+  for (const auto &[pattern, alphabet] : cases)
+  {
+    const dfa::DFA machine = dfa::Compiler().compile(pattern);
+    const dfa::JitDFA jit(machine);
+
+#if defined(__x86_64__)
+    ASSERT_TRUE(jit.is_native());
+    ASSERT_GT(jit.get_code_size(), 0);
+#endif
+
+    std::uint32_t seed = 3;
+
+    for (std::size_t i = 0; i < 5000; ++i)
+    {
+      seed = seed * 1103515245 + 12345;
+      std::string input((seed >> 16) % 12, 'a');
+
+      for (auto &character : input)
+      {
+        seed = seed * 1103515245 + 12345;
+        character = alphabet[(seed >> 16) % alphabet.size()];
+      }
+
+      ASSERT_EQ(jit.matches(input), machine.matches(input)) << input;
+    }
+
+    ASSERT_EQ(jit.matches(""), machine.matches(""));
+  }
+
+  // Moving keeps the code
+  dfa::JitDFA first(dfa::Compiler().compile("ab+"));
+  dfa::JitDFA second = std::move(first);
+  ASSERT_TRUE(second.matches("abbb"));
+  ASSERT_FALSE(second.matches("ba"));
+}
+
+TEST(DFATest, CodeGeneratorWritesAHeader)
+{
+  const std::vector<std::string> patterns = {"ab+", "a\"c"};
+  const dfa::DFA machine = dfa::Compiler().compile_set(patterns);
+
+  std::ostringstream direct;
+  dfa::CodeGenerator::write(machine, patterns, direct,
+                            {.namespace_name = "rules::http"});
+  const std::string header = direct.str();
+
+  ASSERT_NE(header.find("namespace rules::http\n"), std::string::npos);
+  ASSERT_NE(header.find("\"a\\\"c\""), std::string::npos);
+  ASSERT_NE(header.find("STATE_COUNT = " +
+                        std::to_string(machine.get_state_count()) + ";"),
+            std::string::npos);
+  ASSERT_NE(header.find("goto s" + std::to_string(machine.get_start_state())),
+            std::string::npos);
+
+  // Above the limit the scan runs the tables
+  std::ostringstream tables;
+  dfa::CodeGenerator::write(machine, patterns, tables,
+                            {.max_direct_states = 1});
+  ASSERT_NE(tables.str().find("return final_state_of_tables(input);"),
+            std::string::npos);
+  ASSERT_EQ(tables.str().find("goto"), std::string::npos);
+
+  ASSERT_THROW(dfa::CodeGenerator::write(machine, patterns, tables,
+                                         {.namespace_name = "9rules"}),
+               std::invalid_argument);
+}
+
+#endif // UNIT_TEST
@@ -4,6 +4,31 @@
 
 #include "../src/lexer/lexer.h"
 
+#ifdef UNIT_TEST
+namespace
+{
+  /**
+   * @class RecordingObserver
+   * @brief Records the size of every batch it is notified with
+   *
+   */
+  class RecordingObserver : public lex::TokenObserver
+  {
+  public:
+    void on_tokens(std::span<const std::shared_ptr<lex::Token>> tokens) override
+    {
+      m_batches.push_back(tokens.size());
+
+      for (const auto &token : tokens)
+        m_types.push_back(token->get_type());
+    }
+
+    std::vector<std::size_t> m_batches;
+    std::vector<lex::TokenType> m_types;
+  };
+} // namespace
+#endif // UNIT_TEST
+
 #ifdef UNIT_TEST
 TEST(LexerTest, TokenizeEmptyInput)
 {
@@ -23,4 +48,97 @@ TEST(LexerTest, TokenizeSingleCharacter)
   ASSERT_EQ(tokens[0]->get_value(), "a");
 }
 
-#endif // UNIT_TEST
\ No newline at end of file
+TEST(LexerTest, TokenizeCompoundTokens)
+{
+  lexer::Lexer lexer("[a-z\\]]{2,4}\\d(?i)");
+
+  auto tokens = lexer.tokenize();
+  ASSERT_EQ(tokens.size(), 4);
+  ASSERT_EQ(tokens[0]->get_type(), lex::TokenType::CHARACTER_CLASS);
+  ASSERT_EQ(tokens[0]->get_value(), "[a-z\\]]");
+  ASSERT_EQ(tokens[1]->get_type(), lex::TokenType::QUANTIFIER);
+  ASSERT_EQ(tokens[1]->get_value(), "{2,4}");
+  ASSERT_EQ(tokens[2]->get_type(), lex::TokenType::ESCAPE_SEQUENCE);
+  ASSERT_EQ(tokens[2]->get_value(), "\\d");
+  ASSERT_EQ(tokens[2]->get_position(), 12);
+  ASSERT_EQ(tokens[3]->get_type(), lex::TokenType::MODIFIER);
+}
+
+TEST(LexerTest, TokenizeOperators)
+{
+  lexer::Lexer lexer("^(a|b).*\\b{x$");
+
+  auto tokens = lexer.tokenize();
+  std::vector<lex::TokenType> expected = {
+      lex::TokenType::ANCHOR, lex::TokenType::GROUPING,
+      lex::TokenType::LITERAL, lex::TokenType::ALTERNATION,
+      lex::TokenType::LITERAL, lex::TokenType::GROUPING,
+      lex::TokenType::WILDCARD, lex::TokenType::QUANTIFIER,
+      lex::TokenType::BOUNDARY, lex::TokenType::LITERAL,
+      lex::TokenType::LITERAL, lex::TokenType::ANCHOR};
+
+  ASSERT_EQ(tokens.size(), expected.size());
+
+  for (std::size_t i = 0; i < expected.size(); ++i)
+    ASSERT_EQ(tokens[i]->get_type(), expected[i]);
+}
+
+TEST(LexerTest, TokenizeUnterminatedInput)
+{
+  lexer::Lexer lexer("a[bc");
+
+  auto tokens = lexer.tokenize();
+  ASSERT_EQ(tokens.size(), 2);
+  ASSERT_EQ(tokens[1]->get_type(), lex::TokenType::INVALID);
+  ASSERT_EQ(tokens[1]->get_value(), "[bc");
+}
+
+TEST(LexerTest, ScanReturnsViewsIntoThePattern)
+{
+  lexer::Lexer lexer("a{2}[xy]\\.");
+
+  const auto tokens = lexer.scan();
+  ASSERT_EQ(tokens.size(), 4);
+  ASSERT_EQ(tokens[1].type, lex::TokenType::QUANTIFIER);
+  ASSERT_EQ(tokens[1].offset, 1);
+  ASSERT_EQ(tokens.get_value(tokens[1]), "{2}");
+  ASSERT_EQ(tokens.get_value(tokens[2]), "[xy]");
+  ASSERT_EQ(tokens.get_value(tokens[3]).data(),
+            tokens.get_source().data() + 8);
+
+  // The Token adapter reports the same tokens
+  const auto adapted = lexer.tokenize();
+  ASSERT_EQ(adapted.size(), tokens.size());
+
+  for (std::size_t i = 0; i < tokens.size(); ++i)
+  {
+    ASSERT_EQ(adapted[i]->get_type(), tokens[i].type);
+    ASSERT_EQ(adapted[i]->get_value(), tokens.get_value(tokens[i]));
+    ASSERT_EQ(adapted[i]->get_position(), tokens[i].offset);
+  }
+}
+
+TEST(LexerTest, ObserversReceiveTokensInBatches)
+{
+  lexer::Lexer lexer("a|b*");
+  auto observer = std::make_shared<RecordingObserver>();
+  lexer.register_observer(observer);
+
+  const auto tokens = lexer.tokenize();
+  ASSERT_EQ(observer->m_batches, std::vector<std::size_t>{tokens.size()});
+  ASSERT_EQ(observer->m_types.size(), tokens.size());
+
+  for (std::size_t i = 0; i < tokens.size(); ++i)
+    ASSERT_EQ(observer->m_types[i], tokens[i]->get_type());
+
+  // Long inputs are split into batches of at most BATCH_SIZE tokens
+  lexer::Lexer long_lexer(std::string(lex::TokenFactory::BATCH_SIZE + 5, 'a'));
+  long_lexer.register_observer(observer);
+  observer->m_batches.clear();
+
+  long_lexer.tokenize();
+  ASSERT_EQ(observer->m_batches,
+            (std::vector<std::size_t>{lex::TokenFactory::BATCH_SIZE, 5}));
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,71 @@
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif // UNIT_TEST
+
+#include "../src/lexer/lexer.h"
+#include "../src/parser/parser.h"
+
+#ifdef UNIT_TEST
+namespace
+{
+  ast::Arena parse(const std::string &pattern)
+  {
+    lexer::Lexer lexer(pattern);
+    parser::Parser parser(lexer.scan());
+
+    return parser.parse();
+  }
+} // namespace
+
+TEST(ParserTest, ParseSequence)
+{
+  const auto tree = parse("ab");
+  const auto root = tree.get_root();
+
+  ASSERT_EQ(tree.get_node(root).type, ast::NodeType::GROUPING);
+  ASSERT_EQ(tree.get_children(root).size(), 2);
+  ASSERT_EQ(tree.to_string(), "(ab)");
+}
+
+TEST(ParserTest, ParseAlternationOfQuantifiedGroups)
+{
+  const auto tree = parse("(ab)+|c{2,3}|d?");
+  const auto root = tree.get_root();
+
+  ASSERT_EQ(tree.get_node(root).type, ast::NodeType::ALTERNATION);
+  ASSERT_EQ(tree.get_children(root).size(), 3);
+  ASSERT_EQ(tree.to_string(), "(((ab))+|c{2,3}|d?)");
+}
+
+TEST(ParserTest, RejectMalformedPatterns)
+{
+  ASSERT_THROW(parse("(ab"), std::invalid_argument);
+  ASSERT_THROW(parse("ab)"), std::invalid_argument);
+  ASSERT_THROW(parse("*a"), std::invalid_argument);
+  ASSERT_THROW(parse("a{3,2}"), std::invalid_argument);
+  ASSERT_THROW(parse("[ab"), std::invalid_argument);
+}
+
+TEST(ParserTest, QuantifierBoundsAreThirtyTwoBits)
+{
+  ASSERT_EQ(parse("a{300}").to_string(), "a{300}");
+  ASSERT_EQ(parse("a{2,}").to_string(), "a{2,}");
+  ASSERT_EQ(parse("a{1,4294967294}").to_string(), "a{1,4294967294}");
+  ASSERT_THROW(parse("a{4294967295}"), std::invalid_argument);
+  ASSERT_THROW(parse("a{99999999999}"), std::invalid_argument);
+}
+
+TEST(ParserTest, RejectDeepNesting)
+{
+  const std::size_t limit = parser::Parser::MAX_DEPTH;
+
+  ASSERT_NO_THROW(
+      parse(std::string(limit, '(') + "a" + std::string(limit, ')')));
+  ASSERT_THROW(parse(std::string(20000, '(') + "a" + std::string(20000, ')')),
+               std::invalid_argument);
+  ASSERT_THROW(parse(std::string(20000, '(')), std::invalid_argument);
+  ASSERT_THROW(parse("a" + std::string(limit + 1, '?')),
+               std::invalid_argument);
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,123 @@
+#ifdef UNIT_TEST
+#include <gtest/gtest.h>
+#endif // UNIT_TEST
+
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/threads/thread_pool.h"
+
+#ifdef UNIT_TEST
+namespace
+{
+  std::uint64_t fibonacci(thread_management::ThreadPool &pool, unsigned n)
+  {
+    if (n < 2)
+      return n;
+
+    std::uint64_t left = 0;
+    thread_management::TaskGroup group(pool);
+
+    group.run([&]
+              { left = fibonacci(pool, n - 1); });
+    const std::uint64_t right = fibonacci(pool, n - 2);
+    group.wait();
+
+    return left + right;
+  }
+} // namespace
+
+TEST(ThreadPoolTest, EnqueueReturnsResults)
+{
+  thread_management::ThreadPool pool(2);
+
+  auto sum = pool.enqueue([](int a, int b)
+                          { return a + b; },
+                          2, 3);
+  auto text = pool.enqueue([]
+                           { return std::string("done"); });
+
+  ASSERT_EQ(sum.get(), 5);
+  ASSERT_EQ(text.get(), "done");
+}
+
+TEST(ThreadPoolTest, ParallelForCoversTheRangeOnce)
+{
+  thread_management::ThreadPool pool(4);
+  std::vector<std::atomic<int>> hits(10007);
+
+  pool.parallel_for(0, hits.size(), 16,
+                    [&](std::size_t begin, std::size_t end)
+                    {
+                      ASSERT_LE(end - begin, 16u);
+
+                      for (std::size_t i = begin; i < end; ++i)
+                        hits[i].fetch_add(1);
+                    });
+
+  for (const auto &hit : hits)
+    ASSERT_EQ(hit.load(), 1);
+}
+
+TEST(ThreadPoolTest, TaskGroupsNest)
+{
+  thread_management::ThreadPool pool(3);
+
+  ASSERT_EQ(fibonacci(pool, 20), 6765u);
+
+  // From inside a task as well as from outside the pool
+  ASSERT_EQ(pool.enqueue([&]
+                         { return fibonacci(pool, 16); })
+                .get(),
+            987u);
+}
+
+TEST(ThreadPoolTest, TaskGroupRethrowsAndIsReusable)
+{
+  thread_management::ThreadPool pool(2);
+  thread_management::TaskGroup group(pool);
+  std::atomic<int> count{0};
+
+  for (int i = 0; i < 100; ++i)
+    group.run([&, i]
+              {
+                count.fetch_add(1);
+
+                if (i == 42)
+                  throw std::runtime_error("task failed");
+              });
+
+  ASSERT_THROW(group.wait(), std::runtime_error);
+  ASSERT_EQ(count.load(), 100);
+
+  group.run([&]
+            { count.fetch_add(1); });
+  ASSERT_NO_THROW(group.wait());
+  ASSERT_EQ(count.load(), 101);
+}
+
+TEST(ThreadPoolTest, TaskStoresLargeCallablesOnTheHeap)
+{
+  thread_management::Task task;
+  int calls = 0;
+  std::array<int, 32> payload{};
+  payload[31] = 7;
+
+  ASSERT_TRUE(task.empty());
+
+  task.emplace([&calls]
+               { ++calls; });
+  task();
+
+  task.emplace([&calls, payload]
+               { calls += payload[31]; });
+  task();
+
+  ASSERT_EQ(calls, 8);
+
+  task.reset();
+  ASSERT_TRUE(task.empty());
+}
+#endif // UNIT_TEST